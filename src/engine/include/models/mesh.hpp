@@ -15,11 +15,20 @@
 #include "math/plane.hpp"
 #include "./texture.hpp"
 #include "./mesh_frame.hpp"
+#include "./mesh_transform.hpp"
 #include <tamtypes.h>
 #include <draw_buffers.h>
 #include <draw_sampling.h>
 #include "./anim_state.hpp"
 
+class DisplayList;
+class BakedAnimation;
+
+/** Max count of LOD levels (full detail level included) */
+const u32 MESH_MAX_LOD_LEVELS = 4;
+/** Screen size border of LOD level is moved by this fraction, so level does not flicker on border */
+const float MESH_LOD_HYSTERESIS = 0.1F;
+
 /** 
  * Class which have contain 3D object data.
  * External data can be loaded via loadXXX() methods.
@@ -31,8 +40,11 @@ public:
     Mesh();
     ~Mesh();
 
+    /** Rotation is done around X, Y and Z (in this order of matrices, so Z is applied first). */
     Vector3 position, rotation;
+    /** Uniform scale. Used by drawing, culling and LOD selection */
     float scale;
+    /** Gouraud shading by VU1, when mesh is drawn with light bulbs. */
     u8 shouldBeLighted;
     /** 
      * When true, invisible triangles of mesh materials are not drawn.
@@ -42,6 +54,13 @@ public:
      * When true, mesh materials are not drawn when they are outside of view frustum.
      */
     u8 shouldBeFrustumCulled;
+    /** 
+     * When true, triangles crossing near plane or GS guard band are clipped by VU1, instead of being skipped.
+     * Slower than default program and disables lighting and strips,
+     * so use it for big triangles near camera (floors, walls, terrain).
+     * Not used by VU1 animation.
+     */
+    u8 shouldBeClipped;
     clutbuffer_t clut;
     lod_t lod;
 
@@ -100,10 +119,110 @@ public:
     /** @returns bounding box object of current frame. */
     const BoundingBox *getCurrentBoundingBox() const { return frames[animState.currentFrame].getBoundingBox(); };
 
+    /** 
+     * Model matrix made from position, rotation and scale.
+     * Recalculated only when they changed (see MeshTransform).
+     */
+    const Matrix &getModelMatrix() { return transform.get(position, rotation, scale); };
+
+    /** Radius of sphere around mesh position, which contains current bounding box in any rotation. Scale included. */
+    float getCurrentBoundingRadius() const;
+
+    /** Count of LOD levels. 1 when generateLOD() was not called. */
+    inline const u32 &getLODLevelsCount() const { return lodLevelsCount; };
+
+    /** Current LOD level. 0 is full detail. See updateLOD() */
+    inline const u32 &getLODLevel() const { return lodLevel; };
+
+    /** 
+     * Returns material of current LOD level.
+     * Faces and strips are simplified, other data (id, color, bounding box) are the same as in getMaterial().
+     */
+    MeshMaterial &getLODMaterial(const u32 &i) const { return getLODFrames()[0].getMaterial(i); };
+
+    /** See setMipmapping() */
+    inline const float &getMipmapDistance() const { return mipmapDistance; };
+
+    inline const u8 isMipmappingEnabled() const { return mipmapDistance > 0.0F; };
+
+    /** See setStatic() */
+    inline const u8 &isStatic() const { return _isStatic; };
+
+    /** See setQuantized() */
+    inline const u8 &isQuantized() const { return _isQuantized; };
+
+    /** 
+     * Returns baked VU1 data of material.
+     * NULL if mesh is not static or material was not drawn yet.
+     */
+    DisplayList *getDisplayList(const u32 &t_materialIndex) const { return displayLists != NULL ? displayLists[lodLevel * getMaterialsCount() + t_materialIndex] : NULL; };
+
+    /** See setAnimationOnVU1() */
+    inline const u8 &isAnimatedOnVU1() const { return _isAnimatedOnVU1; };
+
+    /** 
+     * Returns baked animation frames of material.
+     * NULL if mesh is not animated on VU1 or material was not drawn yet.
+     */
+    BakedAnimation *getBakedAnimation(const u32 &t_materialIndex) const { return bakedAnimations != NULL ? bakedAnimations[lodLevel * getMaterialsCount() + t_materialIndex] : NULL; };
+
+    /** Interpolation between current and next animation frame. 0.0F - 1.0F */
+    inline const float &getAnimationInterpolation() const { return animState.interpolation; };
+
     // ----
     //  Setters
     // ----
 
+    /** 
+     * Enable texture mipmapping. Renderer sets LOD K from mesh distance every frame.
+     * Textures added by TextureRepository::addByMesh() after this call will get mipmaps.
+     * @param t_distance Distance from camera, where full resolution texture is used. 
+     * Every 2x further, next mip level is used. 0 disables mipmapping.
+     */
+    void setMipmapping(const float &t_distance);
+
+    /** 
+     * Static mesh materials are baked into VU1 display lists on first draw
+     * (or via Renderer::bake()), so drawing cost does not depend on vertex count.
+     * Only not animated meshes can be static. Backface culling is not used.
+     * Set false and true again to rebake, after mesh data change.
+     */
+    void setStatic(const u8 &t_val);
+
+    /** 
+     * Display lists of static mesh are baked with 16 bit vertices and STs,
+     * relative to bounding box of material (see VertexQuantizer).
+     * Vertices take 1/2 and STs 1/4 of memory and DMA transfer.
+     * Precision is 1/65535 of material size. Triangle strips are not used.
+     * Display lists are rebaked on next draw.
+     */
+    void setQuantized(const u8 &t_val);
+
+    /** 
+     * Do not call this method unless you know what you do.
+     * Should be called by renderer. Mesh takes ownership of display list.
+     * Display list is set for current LOD level.
+     */
+    void setDisplayList(const u32 &t_materialIndex, DisplayList *t_displayList);
+
+    /** 
+     * Animation frames of materials are baked on first draw (or via Renderer::bake())
+     * and VU1 does interpolation between them, so EE sends only small header per draw.
+     * Costs memory of all frames. Backface culling is done by VU1.
+     * Set false and true again to rebake, after mesh data change.
+     */
+    void setAnimationOnVU1(const u8 &t_val);
+
+    /** 
+     * Do not call this method unless you know what you do.
+     * Should be called by renderer. Mesh takes ownership of baked animation.
+     * Baked animation is set for current LOD level.
+     */
+    void setBakedAnimation(const u32 &t_materialIndex, BakedAnimation *t_bakedAnimation);
+
+    /** Forces LOD level. Renderer will change it on next draw via updateLOD(). */
+    void setLODLevel(const u32 &t_level);
+
     // ----
     //  Other
     // ----
@@ -157,7 +276,25 @@ public:
      */
     void loadMD2(char *t_subfolder, char *t_md2File, const float &t_scale, const u8 &t_invertT);
 
-    /** Copy by reference mesh data from other mesh */
+    /** 
+     * Generates less detailed levels of all frames by quadric error simplification (see MeshSimplifier).
+     * Works for every loader and animation, because only faces are simplified.
+     * Slow, so call it after loading, before loadFrom() of other meshes.
+     * @param t_levelsCount Count of levels with full detail level. Max MESH_MAX_LOD_LEVELS
+     * @param t_ratio Faces count of next level is faces count of previous level * ratio. Example 0.5F
+     * @param t_screenSize Projected mesh diameter in pixels, below which level 1 is used.
+     * Every 2x smaller, next level is used.
+     */
+    void generateLOD(const u32 &t_levelsCount, const float &t_ratio, const float &t_screenSize);
+
+    /** 
+     * Do not call this method unless you know what you do.
+     * Should be called by renderer. 
+     * Selects LOD level by projected mesh diameter in pixels (with hysteresis).
+     */
+    void updateLOD(const float &t_screenSize);
+
+    /** Copy by reference mesh data (LOD levels included) from other mesh */
     void loadFrom(const Mesh &t_mesh);
 
     /** Check if are there any frames */
@@ -203,12 +340,51 @@ public:
      */
     u32 getDrawData(u32 t_materialIndex, VECTOR *o_vertices, VECTOR *o_normals, VECTOR *o_coordinates, Vector3 &t_cameraPos);
 
+    /** 
+     * Do not call this method unless you know what you do.
+     * Should be called by renderer. 
+     * Like getDrawData(), but in triangle strips order and without backface culling.
+     * Vertex "w" keeps strip restart/winding flags instead of 1.0F.
+     */
+    u32 getStripDrawData(u32 t_materialIndex, VECTOR *o_vertices, VECTOR *o_normals, VECTOR *o_coordinates);
+
+    /** 
+     * Do not call this method unless you know what you do.
+     * Should be called by renderer. 
+     * Like getDrawData(), but for given animation frame, without interpolation and backface culling.
+     * @param o_coordinates Can be NULL.
+     */
+    u32 getFrameDrawData(const u32 &t_frame, u32 t_materialIndex, VECTOR *o_vertices, VECTOR *o_coordinates);
+
+    /** 
+     * Do not call this method unless you know what you do.
+     * Should be called by renderer. 
+     * Sets pointers to baked draw data of material (current LOD level),
+     * which can be sent as it is, instead of getDrawData() without backface culling.
+     * @returns Vertices count or 0, if data was not baked (animated mesh).
+     */
+    u32 getBakedDrawData(const u32 &t_materialIndex, VECTOR *&o_vertices, VECTOR *&o_normals, VECTOR *&o_coordinates);
+
 private:
     AnimState animState;
+    MeshTransform transform;
     MeshFrame *frames;
     u32 id, framesCount;
-    u8 _isMother, _areFramesAllocated;
+    float mipmapDistance;
+    u8 _isMother, _areFramesAllocated, _isStatic, _isQuantized, _isAnimatedOnVU1;
+    DisplayList **displayLists;
+    u32 displayListsCount;
+    void deleteDisplayLists();
+    BakedAnimation **bakedAnimations;
+    u32 bakedAnimationsCount;
+    void deleteBakedAnimations();
     Vector3 calc3Vectors[3];
+    MeshFrame *lodFrames[MESH_MAX_LOD_LEVELS];
+    float lodScreenSizes[MESH_MAX_LOD_LEVELS];
+    u32 lodLevelsCount, lodLevel;
+    void deleteLODLevels();
+    /** Frames of current LOD level. Vertices are the same for all levels, only faces are different */
+    inline MeshFrame *getLODFrames() const { return lodLevel == 0 ? frames : lodFrames[lodLevel]; };
     void setDefaultLODAndClut();
 };
 
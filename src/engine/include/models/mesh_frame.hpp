@@ -143,9 +143,26 @@ public:
     const u8 &areMaterialsAllocated() const { return _areMaterialsAllocated; };
     const u8 &isBoundingBoxCalculated() const { return _isBoundingBoxCalculated; };
 
+    /** 
+     * True when STs and materials (with faces) are owned by other frame.
+     * Only vertices and normals of this frame are its own data.
+     */
+    const u8 &isTopologyShared() const { return _isTopologyShared; };
+
     /** Create reference copy (non-mother) */
     void copyFrom(MeshFrame *t_refCopy);
 
+    /** 
+     * Drops own STs and materials and uses these of given frame.
+     * Used by animated meshes, which frames differ only by vertices and normals.
+     * Given frame have to live longer than this one.
+     * Material bounding boxes are not calculated for this frame.
+     */
+    void shareTopologyFrom(MeshFrame *t_frame);
+
+    /** True when STs, materials count and faces are the same as in given frame. */
+    u8 hasTheSameTopology(const MeshFrame &t_frame) const;
+
     /** Set STs count and allocate memory. */
     void allocateSTs(const u32 &t_val);
 
@@ -165,6 +182,19 @@ public:
      */
     void calculateBoundingBoxes();
 
+    /** 
+     * Generates triangle strips of materials.
+     * Should be called by data loader,
+     * so there is no need to run it again.
+     */
+    void generateStrips();
+
+    /** 
+     * Bakes de-indexed draw data of materials (see MeshMaterial::bakeDrawData()).
+     * Called by mesh class for not animated meshes.
+     */
+    void bakeDrawData();
+
 private:
     BoundingBox *boundingBoxObj;
     u8 _isMother,
@@ -172,6 +202,7 @@ private:
         _areVerticesAllocated,
         _areNormalsAllocated,
         _areMaterialsAllocated,
+        _isTopologyShared,
         _isBoundingBoxCalculated;
     u32 vertexCount, stsCount, normalsCount, materialsCount, id;
     MeshMaterial *materials;
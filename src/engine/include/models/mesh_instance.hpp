@@ -0,0 +1,27 @@
+/*
+# ______       ____   ___
+#   |     \/   ____| |___|    
+#   |     |   |   \  |   |       
+#-----------------------------------------------------------------------
+# Copyright 2020, tyra - https://github.com/h4570/tyra
+# Licenced under Apache License 2.0
+# Sandro Sobczyński <sandro.sobczynski@gmail.com>
+*/
+
+#ifndef _TYRA_MESH_INSTANCE_
+#define _TYRA_MESH_INSTANCE_
+
+#include "math/vector3.hpp"
+#include <tamtypes.h>
+#include <draw_types.h>
+
+/** Transform and color of one copy of mesh. See Renderer::drawInstanced() */
+struct MeshInstance
+{
+    Vector3 position, rotation;
+    float scale;
+    /** Replaces color of mesh materials. */
+    color_t color;
+};
+
+#endif
@@ -13,9 +13,12 @@
 
 #include <tamtypes.h>
 #include <draw_types.h>
+#include <math3d.h>
 #include "bounding_box.hpp"
 #include "./math/vector3.hpp"
 #include "./math/plane.hpp"
+#include "./math/point.hpp"
+#include "../utils/hash.hpp"
 
 /** 
  * Class which contains draw instructions for part of mesh.
@@ -39,6 +42,9 @@ public:
     /** Material name. */
     char *getName() const { return name; };
 
+    /** Hash of material name. Compare it with Hash::fnv1a("name") */
+    const u32 &getNameHash() const { return nameHash; };
+
     /** 
      * Auto generated unique Id. 
      * Core role of this variable is to select correct texture to draw
@@ -65,6 +71,29 @@ public:
     /** Array of normal vector faces. Size of getFacesCount() */
     u32 *getNormalFaces() const { return normalFaces; };
 
+    /** Count of triangle strips vertices. 0 if strips were not generated. */
+    const u32 &getStripFacesCount() const { return stripFacesCount; };
+
+    /** Indexes of faces in triangle strips order. Size of getStripFacesCount() */
+    u32 *getStripFaces() const { return stripFaces; };
+
+    /** 1 for first two vertices of every strip. Size of getStripFacesCount() */
+    u8 *getStripRestarts() const { return stripRestarts; };
+
+    const u8 areStripsPresent() const { return stripFacesCount > 0; };
+
+    /** True if de-indexed draw data was baked (see bakeDrawData()). */
+    const u8 isDrawDataBaked() const { return drawData != NULL; };
+
+    /** De-indexed vertices (w = 1.0F). Size of getFacesCount(). NULL if not baked. */
+    VECTOR *getDrawVertices() const { return drawData; };
+
+    /** De-indexed normals (w = 1.0F). Size of getFacesCount(). */
+    VECTOR *getDrawNormals() const { return drawData + facesCount; };
+
+    /** De-indexed texture coords (z, w = 1.0F). Size of getFacesCount(). */
+    VECTOR *getDrawCoordinates() const { return drawData + 2 * facesCount; };
+
     /** 
      * @returns bounding box (AABB).
      * Total length: 8
@@ -149,6 +178,16 @@ public:
     /** Set faces count and allocate memory. */
     void allocateFaces(const u32 &t_val);
 
+    /** 
+     * Replaces faces. Material takes ownership of given arrays (allocated with new[])
+     * and deletes them on destruction. Strips are removed.
+     * Used by mesh LOD generation.
+     */
+    void setFaces(u32 *t_vertexFaces, u32 *t_stFaces, u32 *t_normalFaces, const u32 &t_count);
+
+    /** Replaces faces and strips with reference copy of other material faces and strips. */
+    void referenceFacesFrom(const MeshMaterial &t_material);
+
     /** 
      * Do not call this method unless you know what you do.
      * Calculates bounding box (AABB).
@@ -157,16 +196,40 @@ public:
     void calculateBoundingBox(Vector3 *t_vertices, u32 t_vertCount);
 
     /** True when mesh is in view frustum */
-    u8 isInFrustum(Plane *t_frustumPlanes, const Vector3 &position);
+    u8 isInFrustum(Plane *t_frustumPlanes, const Vector3 &position, const float &t_scale = 1.0F);
+
+    /** 
+     * Do not call this method unless you know what you do.
+     * Converts faces into triangle strips (see Stripifier).
+     * Strips are kept only if they have less vertices than faces.
+     * Called automatically in mesh frame class on data loading.
+     */
+    void generateStrips();
+
+    /** 
+     * Do not call this method unless you know what you do.
+     * De-indexes faces into vertices, normals and texture coords streams,
+     * laid out in the same way as VU1 unpacks them, so they can be sent without preparation.
+     * Costs 48 bytes per face. Faces data have to stay the same after baking.
+     * Called automatically in mesh class for not animated meshes.
+     */
+    void bakeDrawData(Vector3 *t_vertices, Vector3 *t_normals, Point *t_sts);
 
 private:
     void setDefaultColor();
+    void deleteFaces();
+    void deleteDrawData();
     BoundingBox *boundingBoxObj;
-    u32 facesCount, id;
-    u32 *vertexFaces, *stFaces, *normalFaces;
+    u32 facesCount, id, nameHash;
+    u32 *vertexFaces, *stFaces, *normalFaces, *stripFaces;
+    u32 stripFacesCount;
+    u8 *stripRestarts;
+    VECTOR *drawData;
     u8 _isMother,
         _isNameSet,
         _areFacesAllocated,
+        _areFacesOwned,
+        _isDrawDataOwned,
         _isBoundingBoxCalculated,
         _areSTsPresent,
         _areNormalsPresent;
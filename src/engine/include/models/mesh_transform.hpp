@@ -0,0 +1,51 @@
+/*
+# ______       ____   ___
+#   |     \/   ____| |___|    
+#   |     |   |   \  |   |       
+#-----------------------------------------------------------------------
+# Copyright 2020, tyra - https://github.com/h4570/tyra
+# Licenced under Apache License 2.0
+# Sandro Sobczyński <sandro.sobczynski@gmail.com>
+*/
+
+#ifndef _TYRA_MESH_TRANSFORM_
+#define _TYRA_MESH_TRANSFORM_
+
+#include <tamtypes.h>
+#include "math/vector3.hpp"
+#include "math/matrix.hpp"
+
+/**
+ * Cached model matrix of mesh (OpenGL name: Model, Sony name: local world).
+ * Given values are compared with cached ones, so mesh fields can be still changed directly.
+ * Rotation part (sin/cos) is recalculated only when rotation or scale changed,
+ * translation part only when position changed.
+ */
+class MeshTransform
+{
+
+public:
+    MeshTransform();
+
+    /** 
+     * Returns model matrix, which scales, rotates (Z, then Y, then X) and translates.
+     * Result is the same as of identity(), scale(), rotate(), translate() calls,
+     * but without matrix multiplications.
+     */
+    const Matrix &get(const Vector3 &t_position, const Vector3 &t_rotation, const float &t_scale);
+
+    /** Forces recalculation on next get() */
+    inline void setDirty() { isRotationDirty = true; };
+
+    /** Calculates model matrix in closed form. See get() */
+    static void compose(Matrix &o_model, const Vector3 &t_position, const Vector3 &t_rotation, const float &t_scale);
+
+private:
+    Matrix model;
+    Vector3 position, rotation;
+    float scale;
+    u8 isRotationDirty;
+    static void setRotation(Matrix &o_model, const Vector3 &t_rotation, const float &t_scale);
+};
+
+#endif
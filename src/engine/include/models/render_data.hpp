@@ -34,6 +34,11 @@ struct RenderData
      * Sony name: View screen
      */
     Matrix *projection;
+    /** 
+     * projection * view, calculated once per frame by renderer
+     * Sony name: world screen
+     */
+    Matrix *viewProjection;
     Vector3 *cameraPosition;
     Plane *frustumPlanes;
     prim_t *prim;
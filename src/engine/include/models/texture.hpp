@@ -16,15 +16,29 @@
 #include "./texture_wrap_settings.hpp"
 #include "./texture_link.hpp"
 #include "../include/utils/debug.hpp"
+#include "../utils/hash.hpp"
 #include <vector>
 #include <gs_psm.h>
 
 enum TextureType
 {
-    TEX_TYPE_RGB = GS_PSM_24, // BMP
-    TEX_TYPE_RGBA = GS_PSM_32 // PNG
+    TEX_TYPE_RGB = GS_PSM_24,     // BMP
+    TEX_TYPE_RGBA = GS_PSM_32,    // PNG
+    TEX_TYPE_PALETTE8 = GS_PSM_8, // Palette PNG, 256 colors
+    TEX_TYPE_PALETTE4 = GS_PSM_4  // Palette PNG, 16 colors
 };
 
+class TextureRepository;
+
+/** GS supports 6 mip levels below base texture (MIPTBP1 and MIPTBP2) */
+const u8 TEXTURE_MAX_MIPMAPS = 6;
+
+/** Mip levels smaller than this (in pixels) are not generated */
+const u16 TEXTURE_MIN_MIPMAP_SIZE = 8;
+
+/** GS VRAM page size in 32bit words (8KB) */
+const u32 TEXTURE_GS_PAGE_SIZE = 2048;
+
 /** 
  * Class which contains texture data.
  * Textures are paired with meshes/sprites via addLink() and 
@@ -42,13 +56,19 @@ public:
     // ----
 
     /** 
-     * Auto generated unique Id. 
+     * Auto generated unique Id (generation checked handle).
      * Core role of this variable is to dont send 
      * again texture in renderer, when last sent texture id
      * by renderer will be equal to this id.
      */
     inline const u32 getId() const { return id; };
 
+    /** 
+     * Returns texture with given id in O(1).
+     * NULL if texture was destructed.
+     */
+    static Texture *getById(const u32 &t_id);
+
     inline const u16 getWidth() const { return width; };
 
     inline const u16 getHeight() const { return height; };
@@ -60,10 +80,45 @@ public:
     inline texwrap_t *getWrapSettings() { return &wrapSettings; };
 
     /** 
-     * Returns always width * width * 3/4. 
-     * 3 for RGB, 4 for RGBA.
+     * Returns width * height * bytes per pixel. 
+     * 3 for RGB, 4 for RGBA, 1 for 8bit palette, 0.5 for 4bit palette.
+     */
+    inline u32 getDataSize() const
+    {
+        switch (_type)
+        {
+        case TEX_TYPE_RGB:
+            return width * height * 3;
+        case TEX_TYPE_PALETTE8:
+            return width * height;
+        case TEX_TYPE_PALETTE4:
+            return width * height / 2;
+        default:
+            return width * height * 4;
+        }
+    };
+
+    inline const u8 isPaletted() const { return _type == TEX_TYPE_PALETTE8 || _type == TEX_TYPE_PALETTE4; };
+
+    /** 256 for 8bit palette, 16 for 4bit palette, 0 otherwise. */
+    inline u16 getClutColorsCount() const { return _type == TEX_TYPE_PALETTE8 ? 256 : _type == TEX_TYPE_PALETTE4 ? 16 : 0; };
+
+    /** Size of CLUT in bytes (RGBA colors). */
+    inline u32 getClutSize() const { return getClutColorsCount() * 4; };
+
+    /** 
+     * CLUT data (RGBA), used by renderer.
+     * Colors are stored in GS order (CSM1), so
+     * for 8bit palette see getClutIndexCSM1().
+     * NULL for not paletted textures.
      */
-    inline u32 getDataSize() const { return _type == TEX_TYPE_RGB ? width * height * 3 : width * height * 4; };
+    inline unsigned char *getClut() const { return clut; };
+
+    /** 
+     * GS CSM1 mode keeps 256 colors in 8x2 blocks, so
+     * in every 32 colors, colors 8-15 are swapped with 16-23.
+     */
+    static inline u8 getClutIndexCSM1(const u8 &t_index) { return (t_index & 0xE7) | ((t_index & 0x08) << 1) | ((t_index & 0x10) >> 1); };
 
     /** 
      * Texture data, used by renderer.
@@ -71,12 +126,51 @@ public:
      */
     inline unsigned char *getData() const { return data; };
 
+    /** Count of generated mip levels, without base texture. */
+    inline const u8 &getMipmapsCount() const { return mipmapsCount; };
+
+    /** @param t_level 0 for base texture, 1 - getMipmapsCount() for mip levels */
+    inline u16 getMipmapWidth(const u8 &t_level) const { return width >> t_level; };
+
+    /** @param t_level 0 for base texture, 1 - getMipmapsCount() for mip levels */
+    inline u16 getMipmapHeight(const u8 &t_level) const { return height >> t_level; };
+
+    /** @param t_level 0 for base texture, 1 - getMipmapsCount() for mip levels */
+    inline u32 getMipmapDataSize(const u8 &t_level) const { return getDataSize() >> (t_level * 2); };
+
+    /** 
+     * Buffer width (TBW * 64) in pixels.
+     * Paletted textures needs at least 128, other ones 64.
+     * @param t_level 0 for base texture, 1 - getMipmapsCount() for mip levels
+     */
+    u32 getBufferWidth(const u8 &t_level) const;
+
+    /** 
+     * VRAM size in words, rounded up to whole GS pages.
+     * Pixels are swizzled inside page, so buffer width (not texture width)
+     * and PSM page size decides how much VRAM is touched.
+     * @param t_level 0 for base texture, 1 - getMipmapsCount() for mip levels
+     */
+    u32 getVramSize(const u8 &t_level) const;
+
+    /** 
+     * Mip level data, used by renderer.
+     * @param t_level 0 for base texture, 1 - getMipmapsCount() for mip levels
+     */
+    inline unsigned char *getMipmapData(const u8 &t_level) const { return t_level == 0 ? data : mipmaps[t_level - 1]; };
+
     /** 
      * Get texture name.
      * For "textures/abc.bmp" result will be: "abc"
      */
     inline char *getName() const { return name; };
 
+    /** Hash of texture name. Compare it with Hash::fnv1a("name") */
+    inline const u32 &getNameHash() const { return nameHash; };
+
+    /** Repository which owns texture. NULL if texture was not added to any. */
+    inline TextureRepository *getRepository() const { return repository; };
+
     /** Array of texture links. Size of getTextureLinksCount() */
     inline const std::vector<TextureLink> &getTextureLinks() const { return texLinks; };
 
@@ -104,13 +198,13 @@ public:
      * Do not call this method unless you know what you do.
      * Should be called by data loader. 
      */
-    void setSize(const u8 &t_width, const u8 &t_height, const TextureType &t_type);
+    void setSize(const u16 &t_width, const u16 &t_height, const TextureType &t_type);
 
     /** 
      * Do not call this method unless you know what you do.
      * Should be called by data loader. 
      */
-    void setHeight(const u8 &t_val) { height = t_val; }
+    void setHeight(const u16 &t_val) { height = t_val; }
 
     /** 
      * Do not call this method unless you know what you do.
@@ -118,6 +212,21 @@ public:
      */
     void setData(const u32 &t_index, const unsigned char &t_val) { data[t_index] = t_val; }
 
+    /** 
+     * Set palette color. Alpha 128 = opaque.
+     * Do not call this method unless you know what you do.
+     * Should be called by data loader. 
+     */
+    void setClutColor(const u8 &t_index, const u8 &t_r, const u8 &t_g, const u8 &t_b, const u8 &t_a);
+
+    /** 
+     * Generate mip levels (2x2 box filter), until TEXTURE_MIN_MIPMAP_SIZE.
+     * Paletted textures are filtered in RGBA and mapped to nearest palette color.
+     * Should be called after texture data is loaded.
+     * @param t_maxCount Max mip levels. 1 - TEXTURE_MAX_MIPMAPS
+     */
+    void generateMipmaps(const u8 &t_maxCount = TEXTURE_MAX_MIPMAPS);
+
     /** 
      * Set texture name. 
      * Should be the file name without extension
@@ -127,15 +236,24 @@ public:
     /** Set texture wrapping */
     void setWrapSettings(const WrapSettings t_horizontal, const WrapSettings t_vertical);
 
+    /** 
+     * Set owner repository and register links in it.
+     * Do not call this method unless you know what you do.
+     * Should be called by texture repository. 
+     */
+    void setRepository(TextureRepository *t_repository);
+
     // ----
     //  Other
     // ----
 
-    /** Assign texture to mesh and mesh material. */
-    void addLink(const u32 &t_meshId, const u32 &t_materialId);
-
-    /** Assign texture to sprite. */
-    void addLink(const u32 &t_spriteId);
+    /** 
+     * Assign texture to mesh material or sprite. 
+     * @param t_id
+     * For 3D: Mesh material id.
+     * For 2D: Sprite id.
+     */
+    void addLink(const u32 &t_id);
 
     const u8 &isNameSet() const { return _isNameSet; };
 
@@ -156,7 +274,7 @@ public:
             return false;
     };
 
-    void removeLinkByIndex(const u32 &t_index) { texLinks.erase(texLinks.begin() + t_index); }
+    void removeLinkByIndex(const u32 &t_index);
 
     /** 
      * Remove texture link with given Mesh/Sprite. 
@@ -173,14 +291,18 @@ public:
 
 private:
     void setDefaultWrapSettings();
+    void getPixel(const unsigned char *t_data, const u32 &t_index, u8 *o_rgba) const;
+    void setPixel(unsigned char *t_data, const u32 &t_index, const u8 *t_rgba);
     texwrap_t wrapSettings;
     char *name;
     TextureType _type;
     std::vector<TextureLink> texLinks;
-    u32 id;
+    TextureRepository *repository;
+    u32 id, nameHash;
     u16 width, height;
-    u8 _isNameSet, _isSizeSet;
-    unsigned char *data;
+    u8 _isNameSet, _isSizeSet, mipmapsCount;
+    unsigned char *data, *clut;
+    unsigned char *mipmaps[TEXTURE_MAX_MIPMAPS];
 };
 
 #endif
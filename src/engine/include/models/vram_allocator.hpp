@@ -0,0 +1,125 @@
+/*
+# ______       ____   ___
+#   |     \/   ____| |___|    
+#   |     |   |   \  |   |       
+#-----------------------------------------------------------------------
+# Copyright 2020, tyra - https://github.com/h4570/tyra
+# Licenced under Apache License 2.0
+# Sandro Sobczyński <sandro.sobczynski@gmail.com>
+*/
+
+#ifndef _TYRA_VRAM_ALLOCATOR_
+#define _TYRA_VRAM_ALLOCATOR_
+
+#include <tamtypes.h>
+#include <vector>
+
+struct VramSlot
+{
+    /**
+     * Owner of the slot.
+     * For textures: texture id.
+     */
+    u32 key;
+    /** Start address in VRAM words. */
+    u32 address;
+    /** Size in VRAM words (aligned). */
+    u32 size;
+    /** Number of frame, in which slot was used last time. */
+    u32 lastUsedFrame;
+};
+
+/**
+ * First-fit allocator of VRAM range with LRU eviction.
+ * Works only on addresses/sizes (in words), it does not touch GS,
+ * so it can be simulated and tested without console.
+ */
+class VramAllocator
+{
+
+public:
+    VramAllocator();
+    ~VramAllocator();
+
+    /**
+     * Set managed VRAM range [t_start, t_end) and alignment of slots.
+     * All values in words. Releases all slots.
+     */
+    void init(const u32 &t_start, const u32 &t_end, const u32 &t_alignment);
+
+    // ----
+    // Getters
+    // ----
+
+    inline const u32 &getStart() const { return start; };
+
+    inline const u32 &getEnd() const { return end; };
+
+    inline const u32 &getCurrentFrame() const { return currentFrame; };
+
+    inline u32 getSlotsCount() const { return static_cast<u32>(slots.size()); };
+
+    /** Slots, sorted by address. */
+    inline const std::vector<VramSlot> &getSlots() const { return slots; };
+
+    /** Keys evicted by last allocate() call. */
+    inline const std::vector<u32> &getEvictedKeys() const { return evictedKeys; };
+
+    /** 
+     * True, if last allocate() call evicted slot used in current frame.
+     * Such VRAM can be still read by pending draws.
+     */
+    inline const u8 &isCurrentFrameSlotEvicted() const { return _isCurrentFrameSlotEvicted; };
+
+    /** Sum of words which are not used by any slot. */
+    u32 getFreeWords() const;
+
+    /**
+     * Returns index of slot.
+     * -1 if not found.
+     */
+    const s32 getIndexOfSlot(const u32 &t_key) const
+    {
+        for (u32 i = 0; i < slots.size(); i++)
+            if (slots[i].key == t_key)
+                return i;
+        return -1;
+    };
+
+    // ----
+    //  Other
+    // ----
+
+    /**
+     * Returns address of resident slot and marks it as used in current frame.
+     * -1 if not resident.
+     */
+    s32 use(const u32 &t_key);
+
+    /**
+     * Allocate slot for key and mark it as used in current frame.
+     * When there is no free space, least recently used slots are evicted
+     * (see getEvictedKeys()) until the slot fits.
+     * Returns address, or -1 if size is bigger than whole range.
+     */
+    s32 allocate(const u32 &t_key, const u32 &t_size);
+
+    /** Release slot with given key. Does nothing if not resident. */
+    void release(const u32 &t_key);
+
+    void releaseAll() { slots.clear(); }
+
+    /** Should be called once per frame. */
+    void nextFrame() { currentFrame++; }
+
+private:
+    std::vector<VramSlot> slots;
+    std::vector<u32> evictedKeys;
+    u32 start, end, alignment, currentFrame;
+    u8 _isCurrentFrameSlotEvicted;
+    u32 align(const u32 &t_val) const { return ((t_val + alignment - 1) / alignment) * alignment; }
+    s32 findGap(const u32 &t_size, u32 &o_insertIndex) const;
+    void evictLeastRecentlyUsed();
+};
+
+#endif
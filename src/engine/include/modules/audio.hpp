@@ -18,12 +18,7 @@
 #include <audsrv.h>
 #include <kernel.h>
 #include <vector>
-
-struct AudioListenerRef
-{
-    AudioListener *listener;
-    u32 id;
-};
+#include "../utils/handle_table.hpp"
 
 /** 
  * Class responsible for audio playing.
@@ -74,7 +69,7 @@ public:
 
     const u8 &isSongInLoop() const { return songInLoop; }
 
-    u32 getSongListenersCount() const { return songListeners.size(); }
+    u32 getSongListenersCount() const { return songListeners.getCount(); }
 
     const u8 &getVolume() const { return volume; }
 
@@ -127,7 +122,7 @@ public:
 private:
     u8 songLoaded, volume, realVolume, songPlaying, songInLoop, songFinished;
     u8 hack; // TODO
-    std::vector<AudioListenerRef *> songListeners;
+    HandleTable<AudioListener *> songListeners;
     FILE *wav;
     audsrv_fmt_t format;
     FileService *fileService;
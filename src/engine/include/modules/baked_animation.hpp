@@ -0,0 +1,51 @@
+/*
+# ______       ____   ___
+#   |     \/   ____| |___|    
+#   |     |   |   \  |   |       
+#-----------------------------------------------------------------------
+# Copyright 2020, tyra - https://github.com/h4570/tyra
+# Licenced under Apache License 2.0
+# Sandro Sobczyński <sandro.sobczynski@gmail.com>
+*/
+
+#ifndef _TYRA_BAKED_ANIMATION_
+#define _TYRA_BAKED_ANIMATION_
+
+#include <tamtypes.h>
+
+/**
+ * Vertices of all animation frames of mesh material, baked once (per face, in draw order).
+ * VU1 lerp program gets current and next frame directly from these buffers,
+ * so per draw EE sends only headers and unpack references.
+ * Created by renderer.
+ */
+class BakedAnimation
+{
+
+public:
+    BakedAnimation(const u32 &t_vertCount, const u32 &t_framesCount, const u8 &t_rgbaOnly);
+    ~BakedAnimation();
+
+    // ----
+    // Getters
+    // ----
+
+    /** Array of baked vertices of frame. Size of getVertCount() */
+    inline VECTOR *getFrame(const u32 &t_frame) { return frames[t_frame]; };
+
+    /** Array of baked STQs (shared by all frames). Size of getVertCount() */
+    inline VECTOR *getCoordinates() { return coordinates; };
+
+    inline const u32 &getVertCount() const { return vertCount; };
+
+    inline const u32 &getFramesCount() const { return framesCount; };
+
+    inline const u8 &isRGBAOnly() const { return _isRGBAOnly; };
+
+private:
+    VECTOR **frames, *coordinates;
+    u32 vertCount, framesCount;
+    u8 _isRGBAOnly;
+};
+
+#endif
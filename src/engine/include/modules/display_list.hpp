@@ -0,0 +1,99 @@
+/*
+# ______       ____   ___
+#   |     \/   ____| |___|    
+#   |     |   |   \  |   |       
+#-----------------------------------------------------------------------
+# Copyright 2020, tyra - https://github.com/h4570/tyra
+# Licenced under Apache License 2.0
+# Sandro Sobczyński <sandro.sobczynski@gmail.com>
+*/
+
+#ifndef _TYRA_DISPLAY_LIST_
+#define _TYRA_DISPLAY_LIST_
+
+#include <tamtypes.h>
+#include <packet2.h>
+#include <vector>
+#include "./vu1_program_manager.hpp"
+#include "../models/math/matrix.hpp"
+
+struct DisplayListPackage
+{
+    /** Unpack of vertices. Ends with RET tag, so it is drawn via CALL tag. */
+    qword_t *chain;
+    u32 vertCount;
+};
+
+/**
+ * VU1 ready data of static mesh material, baked once.
+ * Vertices and their unpack chain are kept in memory,
+ * so per draw only matrix, color and GS registers are sent.
+ * Quantized display list keeps s16 data of all packages in one array
+ * and dequantization, which is sent with header.
+ * Created by VifSender.
+ */
+class DisplayList
+{
+
+public:
+    /** @param t_quantizedSize Qwords of quantized data. Used only by quantized program. */
+    DisplayList(const u32 &t_vertCount, const u32 &t_packagesCount, const Vu1Program &t_program, const u32 &t_quantizedSize = 0);
+    ~DisplayList();
+
+    // ----
+    // Getters
+    // ----
+
+    /** Array of baked vertices. Size of getVertCount(). NULL if quantized. */
+    inline VECTOR *getVertices() { return vertices; };
+
+    /** Array of baked STQs. Size of getVertCount(). NULL if quantized or RGBA only. */
+    inline VECTOR *getCoordinates() { return coordinates; };
+
+    /** s16 vertices and STs of packages. NULL if not quantized. */
+    inline qword_t *getQuantizedData() { return quantizedData; };
+
+    /** Scale and offset of quantized vertices. Model view projection matrix is multiplied by it. */
+    inline Matrix &getDequantization() { return dequantization; };
+
+    /** Scale (xy) and offset (zw) of quantized STs. Sent with header. */
+    inline VECTOR &getSTDequantization() { return stDequantization; };
+
+    inline packet2_t *getChain() { return chain; };
+
+    inline const std::vector<DisplayListPackage> &getPackages() const { return packages; };
+
+    inline const u32 &getVertCount() const { return vertCount; };
+
+    /** VU1 program, which packages were baked for. */
+    inline const Vu1Program &getProgram() const { return program; };
+
+    inline u8 isRGBAOnly() const { return !(program & VU1_FEATURE_STQ); };
+
+    /** True, if vertices are triangle strips. */
+    inline u8 isStrip() const { return (program & VU1_FEATURE_STRIP) != 0; };
+
+    inline u8 isQuantized() const { return (program & VU1_FEATURE_QUANTIZED) != 0; };
+
+    // ----
+    //  Other
+    // ----
+
+    /** 
+     * Do not call this method unless you know what you do.
+     * Should be called by VifSender, while chain is baked.
+     */
+    void addPackage(qword_t *t_chain, const u32 &t_vertCount);
+
+private:
+    VECTOR *vertices, *coordinates;
+    qword_t *quantizedData;
+    Matrix dequantization;
+    VECTOR stDequantization;
+    packet2_t *chain;
+    std::vector<DisplayListPackage> packages;
+    u32 vertCount;
+    Vu1Program program;
+};
+
+#endif
@@ -15,6 +15,7 @@
 #include <stdio.h>
 #include <kernel.h>
 #include <vector>
+#include "../utils/handle_table.hpp"
 
 enum FileServiceTaskType
 {
@@ -25,6 +26,7 @@ struct FileServiceTask
 {
     FileServiceTaskType type;
 
+    /** Generation checked handle of task */
     u32 id;
 
     /** 
@@ -89,21 +91,12 @@ public:
      */
     void startThread();
 
-    std::vector<FileServiceTask> tasks;
+    HandleTable<FileServiceTask> tasks;
 
 private:
-    /** Remove task by index */
-    void removeByIndex(const u32 &t_index) { tasks.erase(tasks.begin() + t_index); }
-
     /** Remove task by id */
     const void removeById(const u32 &t_taskId);
 
-    /** 
-     * Get index of task.
-     * @returns Index of task. -1 if not found.
-     */
-    const s32 getIndexOf(const u32 &t_taskId);
-
     u8 threadStack[8 * 1024] __attribute__((aligned(16)));
     u32 getThreadStackSize() { return 8 * 1024; }
     ee_thread_t thread;
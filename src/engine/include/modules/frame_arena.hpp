@@ -0,0 +1,101 @@
+/*
+# ______       ____   ___
+#   |     \/   ____| |___|    
+#   |     |   |   \  |   |       
+#-----------------------------------------------------------------------
+# Copyright 2020, tyra - https://github.com/h4570/tyra
+# Licenced under Apache License 2.0
+# Sandro Sobczyński <sandro.sobczynski@gmail.com>
+*/
+
+#ifndef _TYRA_FRAME_ARENA_
+#define _TYRA_FRAME_ARENA_
+
+#include <tamtypes.h>
+#include <packet2.h>
+#include <vector>
+
+/** Default size of one arena buffer (in bytes). */
+const u32 FRAME_ARENA_DEFAULT_SIZE = 1024 * 1024;
+
+struct FrameArenaStats
+{
+    /** Bytes allocated in frame. */
+    u32 used;
+    /** Max bytes allocated in one frame since creation. */
+    u32 highWaterMark;
+    /** Allocations, which did not fit into arena and were done on heap. */
+    u32 overflows;
+    /** Packets created, because there was no free packet to reuse. */
+    u32 packetsCreated;
+};
+
+/**
+ * Linear allocator of draw temporaries (vertex data, packets), which live until end of frame.
+ * Allocation is only a pointer bump and whole buffer is released at once in endFrame().
+ * Arena is double buffered, so DMA can still read data of previous frame,
+ * while next one is built. Packets are pooled per buffer in the same way.
+ * Allocations, which do not fit, are done on heap (and counted as overflows),
+ * so size the arena by high water mark, which is printed in debug builds.
+ */
+class FrameArena
+{
+
+public:
+    /** @param t_size Size of one buffer (in bytes). */
+    FrameArena(const u32 &t_size = FRAME_ARENA_DEFAULT_SIZE);
+    ~FrameArena();
+
+    // ----
+    // Getters
+    // ----
+
+    /** Size of one buffer (in bytes). */
+    inline u32 getSize() const { return size * sizeof(qword_t); };
+
+    /** Stats of last finished frame. High water mark is kept since creation. */
+    inline const FrameArenaStats &getStats() const { return lastFrameStats; };
+
+    /** Stats of current frame. */
+    inline const FrameArenaStats &getCurrentStats() const { return stats; };
+
+    // ----
+    //  Other
+    // ----
+
+    /** @returns 16 bytes aligned memory, valid until end of next frame. */
+    void *allocate(const u32 &t_bytes);
+
+    /** @returns 16 bytes aligned array, valid until end of next frame. */
+    template <typename T>
+    inline T *allocate(const u32 &t_count) { return static_cast<T *>(allocate(t_count * sizeof(T))); }
+
+    /**
+     * Returns empty packet, valid until end of next frame.
+     * Packets are not freed by caller. They are reused in frame after next one.
+     */
+    packet2_t *getPacket(const u16 &t_qwords, const enum Packet2Type &t_type, const enum Packet2Mode &t_mode, const u8 &t_tte);
+
+    /** Switches buffers. Data and packets of frame before previous one are released. */
+    void endFrame();
+
+private:
+    struct Packet
+    {
+        packet2_t *packet;
+        u16 qwords;
+        enum Packet2Type type;
+        enum Packet2Mode mode;
+        u8 tte, isUsed;
+    };
+    qword_t *buffers[2];
+    std::vector<qword_t *> overflows[2];
+    std::vector<Packet> packets[2];
+    /** In qwords */
+    u32 size, offset;
+    u8 context;
+    FrameArenaStats stats, lastFrameStats;
+    void resetStats();
+};
+
+#endif
@@ -0,0 +1,105 @@
+/*
+# ______       ____   ___
+#   |     \/   ____| |___|    
+#   |     |   |   \  |   |       
+#-----------------------------------------------------------------------
+# Copyright 2020, tyra - https://github.com/h4570/tyra
+# Licenced under Apache License 2.0
+# Sandro Sobczyński <sandro.sobczynski@gmail.com>
+*/
+
+#ifndef _TYRA_FRAME_CHAIN_
+#define _TYRA_FRAME_CHAIN_
+
+#include <tamtypes.h>
+#include <packet2.h>
+
+/** Default size of VIF1 DMA chain (in qwords). */
+const u32 FRAME_CHAIN_DEFAULT_CHAIN_SIZE = 32768;
+
+/** Default size of GIF data (clear, sprites, texture headers) sent via VIF1 DIRECT (in qwords). */
+const u32 FRAME_CHAIN_DEFAULT_GIF_SIZE = 8192;
+
+/** Default size of data referenced by chain, for example vertices (in qwords). */
+const u32 FRAME_CHAIN_DEFAULT_DATA_SIZE = 65535;
+
+struct FrameChainStats
+{
+    u32 chainSize;
+    u32 gifSize;
+    u32 dataSize;
+};
+
+/**
+ * Whole frame DMA chain, sent once per frame via VIF1.
+ * 3D is sent to VU1 (PATH1), clear/2D/textures are sent via VIF1 DIRECT (PATH2),
+ * so all draws are drawn in adding order.
+ * Chain, GIF data and referenced data are double buffered,
+ * so EE builds next frame, while previous one is drawn.
+ */
+class FrameChain
+{
+
+public:
+    FrameChain(const u32 &t_chainSize, const u32 &t_gifSize, const u32 &t_dataSize);
+    ~FrameChain();
+
+    // ----
+    // Getters
+    // ----
+
+    /** Chain of currently built frame. */
+    inline packet2_t *getChain() { return chains[context]; };
+
+    /** True, if kicked frame can be still drawn. */
+    inline const u8 &isFrameInProgress() const { return _isFrameInProgress; };
+
+    inline u32 getGifSpaceLeft() const { return gifSize - packet2_get_qw_count(gifPackets[context]); };
+
+    /** Used qwords of last kicked frame. */
+    inline const FrameChainStats &getStats() const { return stats; };
+
+    // ----
+    //  Other
+    // ----
+
+    /** Asserts, that given qwords count can be added to chain. */
+    void reserve(const u32 &t_qwords);
+
+    /**
+     * Returns buffer, which will be valid until this frame is drawn.
+     * For data referenced by chain (REF tags).
+     */
+    qword_t *allocate(const u32 &t_qwords);
+
+    /** Returns packet for GIF data. Data is added to chain via closeGif(). */
+    packet2_t *openGif();
+
+    /**
+     * Adds GIF data written after openGif() to chain.
+     * VIF1 waits for end of VU1 drawing (FLUSH) before it, so GS gets data in adding order.
+     */
+    void closeGif();
+
+    /** Adds reference to GIF data (for example texture image) to chain. */
+    void addGifData(const void *t_data, const u32 &t_qwords);
+
+    /** Waits until previously kicked frame is drawn. */
+    void waitForPreviousFrame();
+
+    /**
+     * Closes chain and sends it without waiting.
+     * Previous frame have to be finished (waitForPreviousFrame()).
+     * Last GIF data of chain should contain FINISH.
+     */
+    void kick();
+
+private:
+    packet2_t *chains[2], *gifPackets[2], *dataPackets[2];
+    qword_t *gifStart;
+    u32 chainSize, gifSize, dataSize;
+    u8 context, _isFrameInProgress;
+    FrameChainStats stats;
+};
+
+#endif
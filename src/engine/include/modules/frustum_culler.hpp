@@ -0,0 +1,99 @@
+/*
+# ______       ____   ___
+#   |     \/   ____| |___|    
+#   |     |   |   \  |   |       
+#-----------------------------------------------------------------------
+# Copyright 2020, tyra - https://github.com/h4570/tyra
+# Licenced under Apache License 2.0
+# Sandro Sobczyński <sandro.sobczynski@gmail.com>
+*/
+
+#ifndef _TYRA_FRUSTUM_CULLER_
+#define _TYRA_FRUSTUM_CULLER_
+
+#include <tamtypes.h>
+#include <vector>
+#include "../models/math/vector3.hpp"
+#include "../models/math/plane.hpp"
+
+/** 4 boxes in structure of arrays form, so VU0 tests them at once. */
+struct FrustumCullerBoxes
+{
+    float centerX[4], centerY[4], centerZ[4];
+    float extentX[4], extentY[4], extentZ[4];
+} __attribute__((aligned(16)));
+
+/**
+ * Batched box vs view frustum test.
+ * Boxes are kept as center and extents, so one plane test is
+ * one dot product and one dot product with absolute normal (instead of 8 corners).
+ * Four boxes are tested at once by VU0 (macro mode). On other platforms scalar code is used.
+ * Results are written into bitmask, 1 bit per box.
+ */
+class FrustumCuller
+{
+
+public:
+    FrustumCuller();
+    ~FrustumCuller();
+
+    // ----
+    // Getters
+    // ----
+
+    /** Count of added boxes. */
+    inline const u32 &getCount() const { return count; };
+
+    /** Bit "i % 32" of word "i / 32" is set, when box "i" is in frustum. Valid after cull(). */
+    inline const u32 *getMask() const { return &mask[0]; };
+
+    /** Size of getMask() array. */
+    inline u32 getMaskSize() const { return static_cast<u32>(mask.size()); };
+
+    inline u8 isVisible(const u32 &t_index) const { return (mask[t_index >> 5] >> (t_index & 31)) & 1; };
+
+    // ----
+    //  Other
+    // ----
+
+    /** @returns Index of box. */
+    u32 add(const Vector3 &t_center, const Vector3 &t_extent);
+
+    /**
+     * Adds box of bounding box vertices, scaled and moved by position.
+     * @param t_vertices 8 vertices (see BoundingBox).
+     * @returns Index of box.
+     */
+    u32 add(const Vector3 *t_vertices, const Vector3 &t_position, const float &t_scale = 1.0F);
+
+    void set(const u32 &t_index, const Vector3 &t_center, const Vector3 &t_extent);
+
+    /** Removes all boxes. Memory is kept for next frame. */
+    void clear();
+
+    /**
+     * Tests all boxes and fills bitmask.
+     * @param t_frustumPlanes 6 planes (see RenderData::frustumPlanes)
+     * @returns Count of boxes in frustum.
+     */
+    u32 cull(Plane *t_frustumPlanes);
+
+    /** Test of one box. Box outside of any plane is not in frustum. */
+    static u8 isBoxInFrustum(Plane *t_frustumPlanes, const Vector3 &t_center, const Vector3 &t_extent);
+
+    /** Center and extents of 8 vertices (see BoundingBox), scaled and moved by position. */
+    static void getBoxOfVertices(const Vector3 *t_vertices, const Vector3 &t_position, Vector3 &o_center, Vector3 &o_extent, const float &t_scale = 1.0F);
+
+private:
+    std::vector<FrustumCullerBoxes> boxes;
+    std::vector<u32> mask;
+    u32 count;
+    /**
+     * Smallest value of "distance + radius" of every box for all planes.
+     * Negative means that box is outside.
+     * @param t_planes 6x normal+distance and absolute normal+0.
+     */
+    void cullGroup(const FrustumCullerBoxes &t_boxes, const float *t_planes, float *o_results);
+};
+
+#endif
@@ -24,13 +24,14 @@
 #include "../models/light_bulb.hpp"
 #include "../models/render_data.hpp"
 #include "../models/texture.hpp"
+#include "./frame_arena.hpp"
 
 /** Class responsible for sending data packets via GIF (PATH3) */
 class GifSender
 {
 
 public:
-    GifSender(u32 t_packetSize, ScreenSettings *t_screen, Light *t_light);
+    GifSender(u32 t_packetSize, ScreenSettings *t_screen, Light *t_light, FrameArena *t_frameArena);
     ~GifSender();
 
     void initPacket(u8 context);
@@ -38,7 +39,6 @@ public:
     void addClear(zbuffer_t *t_zBuffer, color_t *t_rgb);
     void sendPacket();
     void sendClear(zbuffer_t *t_zBuffer, color_t *t_rgb);
-    static void sendTexture(Texture &texture, texbuffer_t *t_texBuffer);
 
 private:
     Light *light;
@@ -47,6 +47,7 @@ private:
     texel_t *st;
     u8 isAnyObjectAdded;
     ScreenSettings *screen;
+    FrameArena *frameArena;
     packet2_t *packets[2];
     packet2_t *currentPacket;
     u8 packetsCount;
@@ -0,0 +1,112 @@
+/*
+# ______       ____   ___
+#   |     \/   ____| |___|    
+#   |     |   |   \  |   |       
+#-----------------------------------------------------------------------
+# Copyright 2020, tyra - https://github.com/h4570/tyra
+# Licenced under Apache License 2.0
+# Sandro Sobczyński <sandro.sobczynski@gmail.com>
+*/
+
+#ifndef _TYRA_OCCLUSION_CULLER_
+#define _TYRA_OCCLUSION_CULLER_
+
+#include <tamtypes.h>
+#include <vector>
+#include "../models/math/vector3.hpp"
+#include "../models/math/matrix.hpp"
+#include "../models/screen_settings.hpp"
+
+struct OcclusionCullerStats
+{
+    /** Triangles of occluders drawn into depth buffer. */
+    u32 occluderTriangles;
+    /** Depth buffer pixels written by occluders. */
+    u32 rasterizedPixels;
+    /** Boxes tested by isVisible(). */
+    u32 testedBoxes;
+    /** Boxes, which were hidden by occluders. */
+    u32 culledBoxes;
+    /** Depth buffer pixels read by isVisible(). */
+    u32 testedPixels;
+};
+
+/**
+ * Software occlusion culling.
+ * Occluders (big meshes like walls and terrain) are drawn by EE into small depth buffer,
+ * then screen rectangles of boxes are tested against it.
+ * Buffer keeps 1/w (bigger is nearer), so there are no divisions per pixel.
+ * Code is plain C++, so it works also outside of PS2.
+ */
+class OcclusionCuller
+{
+
+public:
+    /** @param t_divider Screen width and height are divided by it to get size of depth buffer. */
+    OcclusionCuller(const ScreenSettings &t_screen, const u8 &t_divider = 8);
+    ~OcclusionCuller();
+
+    // ----
+    // Getters
+    // ----
+
+    /** True between begin() and endFrame(). */
+    inline const u8 &isActive() const { return _isActive; };
+
+    inline const u16 &getWidth() const { return width; };
+
+    inline const u16 &getHeight() const { return height; };
+
+    /** 1/w of nearest occluder per pixel. 0 means no occluder. Size of width*height. */
+    inline const float *getDepthBuffer() const { return &depth[0]; };
+
+    /** Stats of last finished frame. */
+    inline const OcclusionCullerStats &getStats() const { return lastFrameStats; };
+
+    /** Stats of current frame. */
+    inline const OcclusionCullerStats &getCurrentStats() const { return stats; };
+
+    // ----
+    //  Other
+    // ----
+
+    /**
+     * Clears depth buffer.
+     * @param t_viewProjection Projection * view matrix of current camera.
+     */
+    void begin(const Matrix &t_viewProjection);
+
+    /**
+     * Draws triangles into depth buffer. Triangles which cross near plane are skipped.
+     * @param t_model Model matrix of occluder.
+     * @param t_indices 3 indices per triangle.
+     */
+    void addOccluder(const Matrix &t_model, const Vector3 *t_vertices, const u32 *t_indices, const u32 &t_indicesCount);
+
+    /**
+     * Tests world space box against depth buffer.
+     * Box which crosses near plane or which is outside of screen is always visible.
+     * @returns False if box is fully hidden by occluders.
+     */
+    u8 isVisible(const Vector3 &t_min, const Vector3 &t_max);
+
+    /**
+     * Save stats and stop culling until next begin().
+     * Should be called by renderer.
+     */
+    void endFrame();
+
+private:
+    std::vector<float> depth;
+    u16 width, height;
+    float scaleX, scaleY, nearPlaneDist;
+    Matrix viewProjection;
+    u8 _isActive;
+    OcclusionCullerStats stats, lastFrameStats;
+    /** Screen position in pixels of depth buffer and 1/w. False if w is before near plane. */
+    u8 project(const float *t_matrix, const Vector3 &t_vertex, float *o_result);
+    void rasterize(const float *a, const float *b, const float *c);
+    void resetStats(OcclusionCullerStats &t_stats);
+};
+
+#endif
@@ -0,0 +1,128 @@
+/*
+# ______       ____   ___
+#   |     \/   ____| |___|    
+#   |     |   |   \  |   |       
+#-----------------------------------------------------------------------
+# Copyright 2020, tyra - https://github.com/h4570/tyra
+# Licenced under Apache License 2.0
+# Sandro Sobczyński <sandro.sobczynski@gmail.com>
+*/
+
+#ifndef _TYRA_RENDER_QUEUE_
+#define _TYRA_RENDER_QUEUE_
+
+#include <tamtypes.h>
+#include <draw_types.h>
+#include <vector>
+#include "../models/math/vector3.hpp"
+#include "../models/light_bulb.hpp"
+
+class Mesh;
+class Texture;
+
+struct RenderQueueItem
+{
+    /** See RenderQueue::createKey() */
+    u64 key;
+    Mesh *mesh;
+    Texture *texture;
+    u32 materialIndex;
+    /** Index of first bulb copy, see RenderQueue::getBulbs() */
+    u32 bulbsIndex;
+    u16 bulbsCount;
+    /** Mesh transform and material color from add() call, so the same mesh can be queued many times in one frame */
+    Vector3 position, rotation;
+    float scale;
+    color_t color;
+};
+
+struct RenderQueueStats
+{
+    /** Drawn mesh materials. */
+    u32 items;
+    /** Texture/program/material changes, if items would be drawn in draw() calls order. */
+    u32 unsortedStateChanges;
+    /** Texture/program/material changes of sorted queue. */
+    u32 sortedStateChanges;
+};
+
+/**
+ * Deferred list of mesh materials to draw.
+ * Items are sorted by 64bit key, so draws with the same
+ * VU1 program/texture/material are grouped.
+ */
+class RenderQueue
+{
+
+public:
+    RenderQueue();
+    ~RenderQueue();
+
+    /**
+     * Opaque:      [63] 0 | [62-56] program | [55-40] texture | [39-24] material | [23-0] depth
+     * Translucent: [63] 1 | [62-39] far to near depth | [38-32] program | [31-16] texture | [15-0] material
+     * Opaque items are drawn front to back, grouped by state.
+     * Translucent items are drawn back to front, after opaque ones.
+     * @param t_depth Any non negative, monotonic value, for example squared distance to camera.
+     */
+    static u64 createKey(const u8 &t_isTranslucent, const u8 &t_program, const u16 &t_texture, const u16 &t_material, const float &t_depth);
+
+    /** Returns key without depth bits. */
+    static u64 getStateOfKey(const u64 &t_key);
+
+    // ----
+    // Getters
+    // ----
+
+    inline u32 getItemsCount() const { return static_cast<u32>(items.size()); };
+
+    inline const u8 isEmpty() const { return items.size() == 0; };
+
+    /** Items, sorted after sort() call. */
+    inline const std::vector<RenderQueueItem> &getItems() const { return items; };
+
+    /** Stats of last sort() call. */
+    inline const RenderQueueStats &getStats() const { return stats; };
+
+    inline const u8 &isSortingEnabled() const { return _isSortingEnabled; };
+
+    /** Copies of bulbs from add() call of item. NULL, if there are no bulbs. */
+    inline LightBulb *getBulbs(const RenderQueueItem &t_item) { return t_item.bulbsCount > 0 ? &bulbs[t_item.bulbsIndex] : NULL; };
+
+    // ----
+    //  Setters
+    // ----
+
+    /** Disabled sorting means that items will be drawn in draw() calls order. */
+    void setSorting(const u8 &t_val) { _isSortingEnabled = t_val; }
+
+    // ----
+    //  Other
+    // ----
+
+    /**
+     * Takes copy of mesh position, rotation, scale, material color and bulbs,
+     * so only mesh have to live until items are drawn.
+     */
+    void add(const u64 &t_key, Mesh *t_mesh, Texture *t_texture, const u32 &t_materialIndex, LightBulb *t_bulbs, const u16 &t_bulbsCount);
+
+    /** Radix sort of items by key. Calculates stats. */
+    void sort();
+
+    /** Removes all items. Memory is kept for next frame. */
+    void clear()
+    {
+        items.clear();
+        bulbs.clear();
+    }
+
+private:
+    std::vector<RenderQueueItem> items, sortBuffer;
+    std::vector<LightBulb> bulbs;
+    RenderQueueStats stats;
+    u8 _isSortingEnabled;
+    u32 countStateChanges() const;
+    u32 addBulbs(const LightBulb *t_bulbs, const u16 &t_bulbsCount);
+};
+
+#endif
@@ -24,6 +24,16 @@
 #include "../models/screen_settings.hpp"
 #include "../models/render_data.hpp"
 #include "./texture_repository.hpp"
+#include "./texture_cache.hpp"
+#include <vector>
+#include "./render_queue.hpp"
+#include "./sprite_batch.hpp"
+#include "./frame_chain.hpp"
+#include "./scene_tree.hpp"
+#include "./frustum_culler.hpp"
+#include "./occlusion_culler.hpp"
+#include "./frame_arena.hpp"
+#include "../models/mesh_instance.hpp"
 
 /** Class responsible for intializing draw env, textures and buffers */
 class Renderer
@@ -41,6 +51,33 @@ public:
     void enableVSync() { isVSyncEnabled = true; }
     void disableVSync() { isVSyncEnabled = false; }
 
+    /**
+     * Frame chain mode. Clear, 3D, 2D, texture uploads and buffers switch
+     * are added to one DMA chain, which is sent once per frame.
+     * Chain is drawn while EE builds next frame, so frame is displayed one frame later.
+     * Call it between frames, for example in onInit().
+     */
+    void enableFrameChain();
+
+    /** Draws are sent immediately. Default. */
+    void disableFrameChain();
+
+    inline const u8 isFrameChainEnabled() const { return frameChain != NULL; }
+
+    /**
+     * Backface culling is done by VU1 program, per triangle after transform, instead of EE.
+     * Vertices are sent unculled, so meshes with strips, static and instanced meshes are culled too.
+     */
+    void enableVU1BackfaceCulling() { isBackfaceCullingOnVU1 = true; }
+
+    /** Backface culling is done by EE (only for not static meshes without strips). Default. */
+    void disableVU1BackfaceCulling() { isBackfaceCullingOnVU1 = false; }
+
+    inline const u8 &isVU1BackfaceCullingEnabled() const { return isBackfaceCullingOnVU1; }
+
+    /** Used chain/GIF/data qwords of last frame in frame chain mode. */
+    const FrameChainStats &getFrameChainStats() const { return frameChain->getStats(); }
+
     /** Reset draw wait flag. */
     inline void resetWaitFlag()
     {
@@ -61,9 +98,22 @@ public:
         resetWaitFlag();
     }
 
-    /** 2D draw. */
+    /** 2D draw. Sprite is sent immediately, in one DMA transfer. */
     void draw(Sprite &t_sprite);
 
+    /**
+     * 2D draw via sprite batch.
+     * Sprites are sent together (grouped by texture) in flushSpriteBatch() or endFrame().
+     * Order between sprites of different textures is not kept.
+     */
+    void drawBatched(Sprite &t_sprite);
+
+    /** Send all sprites added via drawBatched(). */
+    void flushSpriteBatch();
+
+    /** Sprites/texture changes/packets of last sprite batch flush. */
+    const SpriteBatchStats &getSpriteBatchStats() const { return spriteBatch->getStats(); }
+
     /// --- OBSOLETE
 
     // /**
@@ -104,17 +154,58 @@ public:
      * Draw many meshes with lighting information. 
      * Draw in array mode, can be A LOT faster than for looping! 
      * Fastest way of rendering (PATH 1, using VU1). 
-     * NOTICE: Animation supported, lighting NOT supported (at this moment)
+     * NOTICE: Animation supported, lighting supported (see drawing of one mesh)
      */
     void draw(Mesh **t_meshes, u16 t_amount, LightBulb *t_bulbs, u16 t_bulbsCount);
 
     /** 
      * Draw mesh with lighting information. 
      * Fastest way of rendering (PATH 1, using VU1).  
-     * NOTICE: Animation supported, lighting NOT supported (at this moment)
+     * Mesh is only added to render queue and drawn in endFrame() (or before next 2D draw),
+     * so it should not be deleted before that. Transform, color and bulbs are copied.
+     * NOTICE: Animation supported, lighting supported.
+     * Lighting is done per vertex by VU1, if mesh.shouldBeLighted is set.
+     * Max VU1_MAX_LIGHTS bulbs are used. Static and VU1 animated meshes are not lighted.
+     * LOD level is selected by mesh size on screen (see Mesh::generateLOD()).
      */
     void draw(Mesh &t_mesh, LightBulb *t_bulbs, u16 t_bulbsCount);
 
+    /**
+     * Draw meshes of scene tree, which are in view frustum.
+     * Whole branches of tree are culled at once, so it is faster than
+     * draw() of every mesh, when scene is big. Moved meshes should be updated in tree before.
+     * Meshes are added to render queue (see drawing of one mesh).
+     */
+    void draw(SceneTree &t_scene, LightBulb *t_bulbs, u16 t_bulbsCount);
+
+    /**
+     * Draw many copies of mesh with other transforms and colors.
+     * Vertices of every material are calculated and sent to VU1 once,
+     * then only matrix and color are sent per instance.
+     * Instances outside of view frustum are skipped (if mesh should be frustum culled).
+     * Multi material and big meshes are supported. Lighting is not.
+     * Backface culling is done only in VU1 mode (see enableVU1BackfaceCulling()).
+     * Instances are drawn immediately, without render queue.
+     * LOD level is selected by the biggest instance on screen.
+     */
+    void drawInstanced(Mesh &t_mesh, MeshInstance *t_instances, const u32 &t_count);
+
+    /**
+     * Draws mesh into occlusion depth buffer (see OcclusionCuller).
+     * Good occluders are big and simple meshes, like walls.
+     * Call it before draw() of other meshes. Until end of frame,
+     * meshes hidden behind occluders are not added to render queue.
+     * Camera have to be set before.
+     */
+    void addOccluder(Mesh &t_mesh);
+
+    /**
+     * Bakes VU1 display lists of all materials of static mesh (see Mesh::setStatic())
+     * or animation frames of mesh animated on VU1 (see Mesh::setAnimationOnVU1()).
+     * Not required, but without it, baking is done on first draw.
+     */
+    void bake(Mesh &t_mesh);
+
     /** 
      * Draw many meshes without lighting information. 
      * Draw in array mode, can be A LOT faster than for looping! 
@@ -143,24 +234,77 @@ public:
         return &textureRepo;
     };
 
+    /** State changes of last frame, with and without render queue sorting. */
+    const RenderQueueStats &getRenderQueueStats() const { return renderQueue.getStats(); }
+
+    /** Disable it to draw meshes in draw() calls order. Enabled by default. */
+    void setRenderQueueSorting(const u8 &t_val) { renderQueue.setSorting(t_val); }
+
+    /** Texture cache hits/misses/uploaded bytes of last frame. */
+    const TextureCacheStats &getTextureCacheStats() const { return textureCache.getStats(); }
+
+    /** Uploads/batches/stalls of asynchronous texture uploader in last frame. */
+    const TextureUploaderStats &getTextureUploaderStats() const { return textureCache.getUploader().getStats(); }
+
+    /** VU1 program switches and uploads of last frame. */
+    const Vu1ProgramManagerStats &getVu1ProgramStats() const { return vifSender->getProgramManager().getStats(); }
+
+    /** Occluder triangles, culled meshes and depth buffer work of last frame. */
+    const OcclusionCullerStats &getOcclusionStats() const { return occlusionCuller->getStats(); }
+
+    /** Memory of per frame temporaries (vertex data, packets) used in last frame. */
+    const FrameArenaStats &getFrameArenaStats() const { return frameArena->getStats(); }
+
+    /**
+     * Start upload of texture to VRAM, without waiting.
+     * For example texture of mesh, which will be visible soon.
+     */
+    void prefetchTexture(Texture &t_texture);
+
 private:
     // We have some GCC bug here. Just try to reorder declarations. For example move worldColor up - game will crash.
-    void changeTexture(Texture *t_tex);
-    u32 lastTextureId;
-    texbuffer_t textureBuffer;
-    u8 isTextureVRAMAllocated, isVSyncEnabled;
-    void allocateTextureBuffer(Texture *t_texture);
-    void deallocateTextureBuffer();
+    TextureCacheEntry *changeTexture(Texture *t_tex);
+    u8 isVSyncEnabled;
+    u8 isBackfaceCullingOnVU1;
+    TextureCache textureCache;
+    RenderQueue renderQueue;
+    void flushRenderQueue();
+    void drawImmediately(Mesh &t_mesh, LightBulb *t_bulbs, u16 t_bulbsCount);
+    /** Reused between draw calls, so culling does not allocate memory every frame */
+    std::vector<Mesh *> meshesInFrustum;
+    std::vector<u32> visibleProxies;
+    FrustumCuller meshesCuller;
+    std::vector<Matrix> instanceMatrices;
+    std::vector<color_t> instanceColors;
+    float setInstancesMatrices(Mesh &t_mesh, MeshInstance *t_instances, const u32 &t_count);
+    float getScreenSize(const float &t_radius, const float &t_squaredDistance);
+    u8 isSphereInFrustum(Vector3 t_center, const float &t_radius);
+    u8 isOccluded(Mesh &t_mesh);
+    void drawMaterial(Mesh &t_mesh, const u32 &t_materialIndex, Texture *t_texture, color_t *t_color, Vector3 &t_rotatedCamera, LightBulb *t_bulbs, u16 t_bulbsCount);
+    DisplayList *getDisplayList(Mesh &t_mesh, const u32 &t_materialIndex);
+    BakedAnimation *getBakedAnimation(Mesh &t_mesh, const u32 &t_materialIndex);
+    Vu1Program getProgram(Mesh &t_mesh, MeshMaterial &t_material, const u8 &t_areBulbsSet);
+    Vector3 setMeshMatrices(Mesh &t_mesh);
+    void setMipmapLOD(lod_t &o_lod, Mesh &t_mesh, const u8 &t_mipmapsCount);
     void flipBuffers();
+    void setFrameChainOfModules(FrameChain *t_frameChain);
+    void addClearToFrameChain();
+    void kickFrameChain(float fps);
+    void displayPreviousFrame();
     void beginFrameIfNeeded();
     u8 isFrameEmpty;
-    Matrix perspective, camRotation;
+    Matrix perspective, viewProjection, camRotation;
+    u8 isViewProjectionSet;
     Light light;
     RenderData renderData;
     TextureRepository textureRepo;
     ScreenSettings *screen;
     GifSender *gifSender;
     VifSender *vifSender;
+    SpriteBatch *spriteBatch;
+    OcclusionCuller *occlusionCuller;
+    FrameArena *frameArena;
+    FrameChain *frameChain;
     packet2_t *flipPacket;
     color_t worldColor;
     void allocateBuffers(int t_screenW, int t_screenH);
@@ -0,0 +1,134 @@
+/*
+# ______       ____   ___
+#   |     \/   ____| |___|    
+#   |     |   |   \  |   |       
+#-----------------------------------------------------------------------
+# Copyright 2020, tyra - https://github.com/h4570/tyra
+# Licenced under Apache License 2.0
+# Sandro Sobczyński <sandro.sobczynski@gmail.com>
+*/
+
+#ifndef _TYRA_SCENE_TREE_
+#define _TYRA_SCENE_TREE_
+
+#include <tamtypes.h>
+#include <vector>
+#include "../models/math/vector3.hpp"
+#include "../models/math/plane.hpp"
+
+class Mesh;
+
+/** Invalid proxy/node index */
+const u32 SCENE_TREE_NULL = 0xFFFFFFFF;
+
+struct SceneTreeStats
+{
+    /** Nodes tested against frustum in last getVisible() call. */
+    u32 nodesVisited;
+    /** Box/plane tests done in last getVisible() call. */
+    u32 planeTests;
+    /** Proxies reinserted, because they moved out of their fat box. */
+    u32 reinserts;
+};
+
+/**
+ * Bounding volume hierarchy of meshes (dynamic AABB tree).
+ * Every mesh is a leaf with "fat" box (enlarged by margin), so small moves
+ * do not change the tree. Only when mesh leaves its fat box, leaf is reinserted
+ * and boxes of its ancestors are refitted.
+ * Frustum culling goes from root. Planes, which fully contain node,
+ * are not tested again in its children. When node is inside all planes,
+ * whole subtree is added without tests.
+ */
+class SceneTree
+{
+
+public:
+    /** @param t_margin Value which enlarges leaf boxes in every direction. */
+    SceneTree(const float &t_margin = 1.0F);
+    ~SceneTree();
+
+    // ----
+    // Getters
+    // ----
+
+    inline Mesh *getMesh(const u32 &t_proxy) const { return nodes[t_proxy].mesh; };
+
+    /** Count of added meshes. */
+    inline const u32 &getCount() const { return leavesCount; };
+
+    /** Depth of the tree. 0 if empty. */
+    u32 getHeight() const;
+
+    /** Stats of last getVisible() call and reinserts since creation. */
+    inline const SceneTreeStats &getStats() const { return stats; };
+
+    // ----
+    //  Other
+    // ----
+
+    /**
+     * Adds mesh with bounds, which are calculated from its position and current bounding box.
+     * Bounds are independent from rotation.
+     * @returns Proxy used by update() and remove().
+     */
+    u32 add(Mesh *t_mesh);
+
+    /** Adds mesh with given world space bounds. */
+    u32 add(Mesh *t_mesh, const Vector3 &t_min, const Vector3 &t_max);
+
+    void remove(const u32 &t_proxy);
+
+    /**
+     * Call it, when mesh moved.
+     * @returns True if tree was changed.
+     */
+    u8 update(const u32 &t_proxy);
+
+    /** Updates with given world space bounds. */
+    u8 update(const u32 &t_proxy, const Vector3 &t_min, const Vector3 &t_max);
+
+    /** Calls update() for every mesh. */
+    void updateAll();
+
+    /** Builds balanced tree from scratch (median split). Useful after loading of level. */
+    void rebuild();
+
+    /**
+     * Writes proxies of meshes, which boxes are in frustum.
+     * Does not allocate memory.
+     * @param t_frustumPlanes 6 planes (see RenderData::frustumPlanes)
+     * @param o_proxies Output array.
+     * @param t_max Size of output array.
+     * @returns Count of written proxies.
+     */
+    u32 getVisible(Plane *t_frustumPlanes, u32 *o_proxies, const u32 &t_max);
+
+private:
+    struct Node
+    {
+        Vector3 min, max;
+        Mesh *mesh;
+        /** Parent or next free node */
+        u32 parent;
+        u32 left, right;
+        u32 height;
+        inline u8 isLeaf() const { return left == SCENE_TREE_NULL; };
+    };
+    std::vector<Node> nodes;
+    std::vector<u32> rebuildLeaves;
+    u32 root, freeList, leavesCount;
+    float margin;
+    SceneTreeStats stats;
+
+    u32 allocateNode();
+    void freeNode(const u32 &t_node);
+    void insertLeaf(const u32 &t_leaf);
+    void removeLeaf(const u32 &t_leaf);
+    void refit(u32 t_node);
+    u32 buildTopDown(const u32 &t_begin, const u32 &t_end);
+    void getMeshBounds(Mesh *t_mesh, Vector3 &o_min, Vector3 &o_max) const;
+    void setFatBox(const u32 &t_leaf, const Vector3 &t_min, const Vector3 &t_max);
+};
+
+#endif
@@ -0,0 +1,103 @@
+/*
+# ______       ____   ___
+#   |     \/   ____| |___|    
+#   |     |   |   \  |   |       
+#-----------------------------------------------------------------------
+# Copyright 2020, tyra - https://github.com/h4570/tyra
+# Licenced under Apache License 2.0
+# Sandro Sobczyński <sandro.sobczynski@gmail.com>
+*/
+
+#ifndef _TYRA_SPRITE_BATCH_
+#define _TYRA_SPRITE_BATCH_
+
+#include <tamtypes.h>
+#include <draw_types.h>
+#include <draw_buffers.h>
+#include <packet2.h>
+#include <vector>
+#include "../models/sprite.hpp"
+#include "../models/texture.hpp"
+#include "../models/screen_settings.hpp"
+#include "./texture_cache.hpp"
+#include "./frame_chain.hpp"
+
+struct SpriteBatchItem
+{
+    texrect_t rect;
+    Texture *texture;
+    /** Used only by not paletted textures. Paletted ones use CLUT from texture cache. */
+    clutbuffer_t clut;
+};
+
+struct SpriteBatchStats
+{
+    /** Sprites drawn by last flush() calls. */
+    u32 sprites;
+    /** TEX0 register changes. */
+    u32 textureChanges;
+    /** DMA transfers. */
+    u32 packets;
+};
+
+/**
+ * Collects sprites and sends them as textured SPRITE primitives in one GIF packet.
+ * Sprites are grouped by texture (CLUT is taken from texture),
+ * so TEX0 is set once per texture. XY offset and blending are set once per packet.
+ * Sprites of the same texture are drawn in add() calls order.
+ */
+class SpriteBatch
+{
+
+public:
+    SpriteBatch(ScreenSettings *t_screen);
+    ~SpriteBatch();
+
+    /** Calculates rectangle (position, size, texture coords, color) of sprite. */
+    static void getRect(Sprite &t_sprite, Texture &t_texture, texrect_t &o_rect);
+
+    // ----
+    // Getters
+    // ----
+
+    inline u32 getCount() const { return static_cast<u32>(items.size()); };
+
+    inline const u8 isEmpty() const { return items.size() == 0; };
+
+    /** Stats of last flush() call. */
+    inline const SpriteBatchStats &getStats() const { return stats; };
+
+    // ----
+    //  Other
+    // ----
+
+    void add(Sprite &t_sprite, Texture &t_texture);
+
+    /**
+     * Sends all sprites and clears batch.
+     * New packet is started only when packet is full or
+     * when texture is not in VRAM (upload could overwrite texture of sprites not sent yet).
+     */
+    void flush(TextureCache &t_textureCache);
+
+    /**
+     * Sprites will be added to frame chain, instead of sending. NULL to send immediately.
+     * Do not call this method unless you know what you do.
+     * Should be called by renderer, between frames.
+     */
+    void setFrameChain(FrameChain *t_frameChain) { frameChain = t_frameChain; }
+
+private:
+    ScreenSettings *screen;
+    std::vector<SpriteBatchItem> items;
+    packet2_t *packets[2], *packet;
+    FrameChain *frameChain;
+    u8 context;
+    SpriteBatchStats stats;
+    u8 hasSpace(const u32 &t_qwords);
+    void beginPacket();
+    void sendPacket();
+    void addTexture(Texture &t_texture, TextureCacheEntry &t_entry, clutbuffer_t &t_clut);
+};
+
+#endif
@@ -0,0 +1,161 @@
+/*
+# ______       ____   ___
+#   |     \/   ____| |___|    
+#   |     |   |   \  |   |       
+#-----------------------------------------------------------------------
+# Copyright 2020, tyra - https://github.com/h4570/tyra
+# Licenced under Apache License 2.0
+# Sandro Sobczyński <sandro.sobczynski@gmail.com>
+*/
+
+#ifndef _TYRA_TEXTURE_CACHE_
+#define _TYRA_TEXTURE_CACHE_
+
+#include <tamtypes.h>
+#include <draw_buffers.h>
+#include <vector>
+#include "../models/texture.hpp"
+#include "../models/vram_allocator.hpp"
+#include "./texture_uploader.hpp"
+
+struct TextureCacheStats
+{
+    /** Texture was already in VRAM. */
+    u32 hits;
+    /** Texture had to be uploaded. */
+    u32 misses;
+    /** Textures removed from VRAM to make space. */
+    u32 evictions;
+    /** Bytes of texture data sent via GIF. */
+    u32 uploadedBytes;
+    /** Times, when draw had to wait for texture upload. */
+    u32 uploadStalls;
+};
+
+/** VRAM words for CLUT of 8bit palette texture (256 colors, 16x16 PSMCT32). */
+const u32 TEXTURE_CACHE_CLUT8_SIZE = 256;
+
+/** VRAM words for CLUT of 4bit palette texture (16 colors, 8x2 PSMCT32, one block). */
+const u32 TEXTURE_CACHE_CLUT4_SIZE = 64;
+
+struct TextureCacheEntry
+{
+    u32 textureId;
+    texbuffer_t buffer;
+    /** Used only by paletted textures. */
+    clutbuffer_t clut;
+    /** Mip levels in VRAM, without base level. */
+    u8 mipmapsCount;
+    /** VRAM addresses of mip levels 1-6. */
+    u32 mipmapAddresses[TEXTURE_MAX_MIPMAPS];
+    /** Buffer widths of mip levels 1-6. */
+    u32 mipmapWidths[TEXTURE_MAX_MIPMAPS];
+    /** GS MIPTBP1 (levels 1-3) and MIPTBP2 (levels 4-6) register values. */
+    u64 miptbp1, miptbp2;
+    /** Uploader batch, which contains this texture. */
+    u32 uploadBatch;
+};
+
+/**
+ * Class responsible for keeping many textures in VRAM
+ * left after framebuffers and zbuffer.
+ * Least recently used textures are evicted, when there is no free space.
+ * Uploads are asynchronous (see TextureUploader), so textures
+ * can be prefetched while VU1 is drawing previous meshes.
+ */
+class TextureCache
+{
+
+public:
+    TextureCache();
+    ~TextureCache();
+
+    /**
+     * Set VRAM range for textures (in words).
+     * Do not call this method unless you know what you do.
+     * Should be called by renderer, after allocation of frame/z buffers.
+     */
+    void init(const u32 &t_startAddress, const u32 &t_endAddress);
+
+    // ----
+    // Getters
+    // ----
+
+    /** Stats of last finished frame. */
+    inline const TextureCacheStats &getStats() const { return lastFrameStats; };
+
+    /** Stats of current (not finished) frame. */
+    inline const TextureCacheStats &getCurrentStats() const { return stats; };
+
+    inline u32 getResidentCount() const { return static_cast<u32>(entries.size()); };
+
+    inline const VramAllocator &getAllocator() const { return allocator; };
+
+    inline const TextureUploader &getUploader() const { return uploader; };
+
+    /**
+     * Returns index of entry.
+     * -1 if not found.
+     */
+    const s32 getIndexOfEntry(const u32 &t_textureId) const
+    {
+        for (u32 i = 0; i < entries.size(); i++)
+            if (entries[i].textureId == t_textureId)
+                return i;
+        return -1;
+    };
+
+    const u8 isResident(const u32 &t_textureId) const { return getIndexOfEntry(t_textureId) != -1; }
+
+    // ----
+    //  Other
+    // ----
+
+    /**
+     * Returns entry (texture buffer, CLUT, mipmaps) of resident texture.
+     * If texture is not in VRAM, it will be uploaded (with CLUT and mip levels).
+     * Waits until upload of texture is finished, so texture can be drawn just after.
+     * Returned pointer is valid until next use()/prefetch() call.
+     */
+    TextureCacheEntry *use(Texture &t_texture);
+
+    /**
+     * Allocates VRAM and queues upload of texture, without waiting.
+     * Upload starts after flushUploads() or when uploader packet is full.
+     * Returned pointer is valid until next use()/prefetch() call.
+     */
+    TextureCacheEntry *prefetch(Texture &t_texture);
+
+    /** Start transfer of queued uploads. Not blocking. */
+    void flushUploads() { uploader.flush(); }
+
+    /**
+     * Textures will be uploaded via frame chain. NULL to upload via GIF.
+     * Do not call this method unless you know what you do.
+     * Should be called by renderer, between frames.
+     */
+    void setFrameChain(FrameChain *t_frameChain) { uploader.setFrameChain(t_frameChain); }
+
+    /** Remove texture from VRAM. For example after texture deletion. */
+    void invalidate(const u32 &t_textureId);
+
+    /**
+     * Save stats and begin next frame.
+     * Do not call this method unless you know what you do.
+     * Should be called by renderer.
+     */
+    void endFrame();
+
+private:
+    VramAllocator allocator;
+    TextureUploader uploader;
+    std::vector<TextureCacheEntry> entries;
+    TextureCacheStats stats, lastFrameStats;
+    void resetStats(TextureCacheStats &t_stats);
+    void removeEvictedEntries();
+    void setBuffer(texbuffer_t &t_buffer, Texture &t_texture, const u32 &t_address);
+    void setClut(clutbuffer_t &t_clut, Texture &t_texture, const u32 &t_address);
+    u32 setMipmaps(TextureCacheEntry &t_entry, Texture &t_texture, const u32 &t_address);
+};
+
+#endif
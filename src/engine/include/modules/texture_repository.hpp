@@ -18,6 +18,7 @@
 #include "../models/mesh_frame.hpp"
 #include "../loaders/bmp_loader.hpp"
 #include "../loaders/png_loader.hpp"
+#include "../utils/handle_table.hpp"
 
 enum TextureFormat
 {
@@ -25,6 +26,13 @@ enum TextureFormat
     PNG
 };
 
+struct TextureRepositoryLink
+{
+    /** Mesh material/sprite id */
+    u32 id;
+    Texture *texture;
+};
+
 /** Class responsible for intializing draw env, textures and buffers */
 class TextureRepository
 {
@@ -43,28 +51,45 @@ public:
     u32 getTexturesCount() const { return static_cast<u32>(textures.size()); };
 
     /** 
-     * Returns single texture.
+     * Returns single texture in O(1).
      * NULL if not found.
      * @param t_id
      * For 3D: Mesh material id. 
      * For 2D: Sprite id. 
      */
-    Texture *getBySpriteOrMesh(const u32 &t_id)
+    Texture *getBySpriteOrMesh(const u32 &t_id) const
     {
-        for (u32 i = 0; i < textures.size(); i++)
-            if (textures[i]->isLinkedWith(t_id))
-                return textures[i];
+        const HandleType type = Handle::getType(t_id);
+        if (type >= HANDLE_TYPES_COUNT) // stale or foreign handle
+            return NULL;
+        const std::vector<TextureRepositoryLink> &table = links[type];
+        const u16 index = Handle::getIndex(t_id);
+        if (index < table.size() && table[index].id == t_id)
+            return table[index].texture;
         return NULL;
     }
 
     /** 
-     * Returns single texture.
+     * Returns single texture in O(1).
      * NULL if not found.
      */
     Texture *getByTextureId(const u32 &t_id) const
+    {
+        Texture *texture = Texture::getById(t_id);
+        if (texture != NULL && texture->getRepository() == this)
+            return texture;
+        return NULL;
+    }
+
+    /** 
+     * Returns single texture.
+     * NULL if not found.
+     * @param t_nameHash Hash of name, for example Hash::fnv1a("water")
+     */
+    Texture *getByNameHash(const u32 &t_nameHash) const
     {
         for (u32 i = 0; i < textures.size(); i++)
-            if (t_id == textures[i]->getId())
+            if (textures[i]->getNameHash() == t_nameHash)
                 return textures[i];
         return NULL;
     }
@@ -100,6 +125,7 @@ public:
 
     /** 
      * Add linked textures in given subpath for mesh material names.
+     * Mipmaps are generated, if mesh has enabled mipmapping.
      * @param t_path Relative path where textures should be searched.
      * @param t_format if you want to use BMP, be sure that you have 
      * BMP with RGB 888 24bit, without color information.
@@ -110,7 +136,14 @@ public:
      * Remove texture from repository.
      * Texture is NOT destructed.
      */
-    void removeByIndex(const u32 &t_index) { textures.erase(textures.begin() + t_index); }
+    void removeByIndex(const u32 &t_index)
+    {
+        textures[t_index]->setRepository(NULL);
+        const std::vector<TextureLink> &texLinks = textures[t_index]->getTextureLinks();
+        for (u32 i = 0; i < texLinks.size(); i++)
+            unlink(texLinks[i].id, textures[t_index]);
+        textures.erase(textures.begin() + t_index);
+    }
 
     /** 
      * Remove texture from repository.
@@ -123,8 +156,24 @@ public:
         removeByIndex(index);
     }
 
+    /** 
+     * Resolve mesh material/sprite id to texture.
+     * Do not call this method unless you know what you do.
+     * Should be called by texture.
+     */
+    void link(const u32 &t_id, Texture *t_texture);
+
+    /** 
+     * Remove link, if it points to given texture.
+     * Do not call this method unless you know what you do.
+     * Should be called by texture.
+     */
+    void unlink(const u32 &t_id, Texture *t_texture);
+
 private:
     std::vector<Texture *> textures;
+    /** Links per handle type, indexed by handle index */
+    std::vector<TextureRepositoryLink> links[HANDLE_TYPES_COUNT];
     BmpLoader bmpLoader;
     PngLoader pngLoader;
 };
@@ -0,0 +1,116 @@
+/*
+# ______       ____   ___
+#   |     \/   ____| |___|    
+#   |     |   |   \  |   |       
+#-----------------------------------------------------------------------
+# Copyright 2020, tyra - https://github.com/h4570/tyra
+# Licenced under Apache License 2.0
+# Sandro Sobczyński <sandro.sobczynski@gmail.com>
+*/
+
+#ifndef _TYRA_TEXTURE_UPLOADER_
+#define _TYRA_TEXTURE_UPLOADER_
+
+#include <tamtypes.h>
+#include <packet2.h>
+#include "../models/texture.hpp"
+#include "./frame_chain.hpp"
+
+struct TextureCacheEntry;
+
+struct TextureUploaderStats
+{
+    /** Textures sent via PATH3. */
+    u32 uploads;
+    /** Batches (DMA transfers) sent. */
+    u32 batches;
+    /** Times, when EE had to wait for unsent or unfinished upload. */
+    u32 stalls;
+};
+
+/**
+ * Asynchronous texture upload via GIF (PATH3).
+ * Uploads are collected into batch (DMA chain with image transfers + TEXFLUSH),
+ * which is sent without waiting, so VU1 (PATH1) can draw in the meantime.
+ * Before draw of texture, waitFor() of its batch have to be called.
+ * In frame chain mode textures are added to frame chain instead (via VIF1 DIRECT),
+ * so they are uploaded in order with draws and waiting is not needed.
+ */
+class TextureUploader
+{
+
+public:
+    TextureUploader();
+    ~TextureUploader();
+
+    // ----
+    // Getters
+    // ----
+
+    /** Count of textures in batch, which was not sent yet. */
+    inline const u32 &getPendingCount() const { return pendingCount; };
+
+    /** Stats of last finished frame. */
+    inline const TextureUploaderStats &getStats() const { return lastFrameStats; };
+
+    /** True, if texture of given batch can be already sampled by GS. */
+    inline const u8 isCompleted(const u32 &t_batch) const { return t_batch <= completedBatch; };
+
+    // ----
+    //  Other
+    // ----
+
+    /**
+     * Add texture (with CLUT and mip levels) to current batch.
+     * Texture data have to be valid until batch is completed.
+     * Returns number of batch.
+     */
+    u32 add(Texture &t_texture, const TextureCacheEntry &t_entry);
+
+    /**
+     * Next batch will be sent after VU1 finish drawing.
+     * Needed when VRAM of texture used by pending draws is overwritten.
+     */
+    void waitForVU1BeforeSend() { _isVU1WaitNeeded = true; }
+
+    /**
+     * Textures will be added to frame chain. NULL to use GIF (PATH3).
+     * Do not call this method unless you know what you do.
+     * Should be called by renderer, between frames.
+     */
+    void setFrameChain(FrameChain *t_frameChain);
+
+    /** Send current batch without waiting for its end. */
+    void flush();
+
+    /**
+     * Wait until given batch is transferred. Sends it, if it was not sent yet.
+     * Current batch without textures is treated as completed.
+     */
+    void waitFor(const u32 &t_batch);
+
+    /** Send and wait for all batches, including the one in transfer. */
+    void waitForAll();
+
+    /**
+     * Save stats and begin next frame.
+     * Do not call this method unless you know what you do.
+     * Should be called by texture cache.
+     */
+    void endFrame();
+
+private:
+    packet2_t *packets[2];
+    FrameChain *frameChain;
+    u8 context, _isVU1WaitNeeded;
+    /** Batch which is collected now. Batches up to completedBatch are in GS. */
+    u32 currentBatch, sentBatch, completedBatch, pendingCount;
+    TextureUploaderStats stats, lastFrameStats;
+    void resetStats(TextureUploaderStats &t_stats);
+    void waitForVU1();
+    void updateCompletedBatch();
+    void addToFrameChain(Texture &t_texture, const TextureCacheEntry &t_entry);
+    void addImageToFrameChain(const void *t_data, const u32 &t_size, const u16 &t_width, const u16 &t_height, const u32 &t_psm, const u32 &t_address, const u32 &t_bufferWidth);
+};
+
+#endif
@@ -19,31 +19,95 @@
 #include "../models/mesh.hpp"
 #include "../models/math/matrix.hpp"
 #include "../models/math/vector3.hpp"
+#include "./texture_cache.hpp"
+#include "./frame_chain.hpp"
+#include "./frame_arena.hpp"
+#include "./display_list.hpp"
+#include "./baked_animation.hpp"
+#include "./vu1_program_manager.hpp"
+
+/** Directional lights (bulbs) supported by VU1 lit program. Ambient light is additional. */
+const u16 VU1_MAX_LIGHTS = 3;
 
 /** Class responsible for sending 3D objects via VIF (PATH 1) */
 class VifSender
 {
 
 public:
-    VifSender(Light *t_light);
+    /** @param t_frameArena Source of per frame packets */
+    VifSender(Light *t_light, FrameArena *t_frameArena);
     ~VifSender();
 
     // TODO refactor
-    void drawMesh(RenderData *t_renderData, Matrix t_perspective, u32 vertCount2, VECTOR *vertices, VECTOR *normals, VECTOR *coordinates, Mesh &t_mesh, LightBulb *t_bulbs, u16 t_bulbsCount, texbuffer_t *textureBuffer, color_t *t_color, u8 t_rgbaOnly);
-    void calcMatrix(const RenderData &t_renderData, const Vector3 &t_position, const Vector3 &t_rotation);
+    void drawMesh(RenderData *t_renderData, Matrix t_perspective, u32 vertCount2, VECTOR *vertices, VECTOR *normals, VECTOR *coordinates, Mesh &t_mesh, LightBulb *t_bulbs, u16 t_bulbsCount, TextureCacheEntry *t_texture, clutbuffer_t *t_clut, lod_t *t_lod, color_t *t_color, Vu1Program t_program);
+    /**
+     * Draws the same vertices many times, with other matrices and colors.
+     * Vertices of every VU1 buffer are uploaded only twice (once per double buffer),
+     * then only matrix and color are changed.
+     * @param t_program Triangles program, draw3D or its clipping variant.
+     */
+    void drawInstances(RenderData *t_renderData, u32 t_vertCount, VECTOR *t_vertices, VECTOR *t_coordinates, Mesh &t_mesh, Matrix *t_matrices, color_t *t_colors, const u32 &t_instancesCount, TextureCacheEntry *t_texture, clutbuffer_t *t_clut, lod_t *t_lod, Vu1Program t_program);
+    /**
+     * Bakes vertices of static mesh material into VU1 packages.
+     * Caller owns returned display list.
+     */
+    DisplayList *createDisplayList(const u32 &t_vertCount, VECTOR *t_vertices, VECTOR *t_coordinates, Vu1Program t_program);
+    /** Sends only headers of packages, baked vertices are unpacked via CALL tags. */
+    void drawDisplayList(RenderData *t_renderData, DisplayList &t_displayList, TextureCacheEntry *t_texture, clutbuffer_t *t_clut, lod_t *t_lod, color_t *t_color);
+    /**
+     * Sends only headers and interpolation of packages.
+     * Both frames are unpacked via REF tags and interpolated by VU1.
+     */
+    void drawBakedAnimation(RenderData *t_renderData, BakedAnimation &t_animation, const u32 &t_currentFrame, const u32 &t_nextFrame, const float &t_interpolation, TextureCacheEntry *t_texture, clutbuffer_t *t_clut, lod_t *t_lod, color_t *t_color);
+    /** Sets model and model view projection matrix. */
+    void calcMatrix(const RenderData &t_renderData, const Matrix &t_model);
     void drawTheSameWithOtherMatrices(const RenderData &t_renderData, Mesh **t_meshes, const u32 &t_skip, const u32 &t_count);
     void enableWait() { isDrawWaitEnabled = true; }
     void disableWait() { isDrawWaitEnabled = false; }
 
+    /**
+     * Backface culling of next draws is done by VU1 program (screen space winding).
+     * Vertices should be sent unculled then.
+     */
+    void setBackfaceCulling(const u8 &t_val) { isBackfaceCullingEnabled = t_val; }
+
+    /**
+     * Meshes will be added to frame chain, instead of sending.
+     * NULL to send immediately.
+     */
+    void setFrameChain(FrameChain *t_frameChain) { frameChain = t_frameChain; }
+
+    /** Uploads and switches of VU1 programs. */
+    Vu1ProgramManager &getProgramManager() { return programManager; }
+
 private:
     u32 lastVertCount; // needed for drawTheSameWithOtherMatrices()
-    u8 isLastRGBAOnly; // needed for drawTheSameWithOtherMatrices()
+    Vu1Program lastProgram; // needed for drawTheSameWithOtherMatrices()
     u8 isDrawWaitEnabled;
+    u8 isBackfaceCullingEnabled;
     Light *light;
-    void uploadMicroProgram();
+    FrameChain *frameChain;
+    Vu1ProgramManager programManager;
+    /** Transposed light directions (3), light colors (3) and ambient. Set per drawMesh() */
+    VECTOR lights[7] __attribute__((aligned(16)));
+    void setLights(Mesh &t_mesh, LightBulb *t_bulbs, u16 t_bulbsCount);
     void setDoubleBufferAddStaticData();
-    void drawVertices(Mesh &t_mesh, u32 t_start, u32 t_end, VECTOR *t_vertices, VECTOR *t_coordinates, prim_t *t_prim, texbuffer_t *t_textureBuffer, u8 t_addDrawWait, color_t *t_color, u8 t_rgbaOnly);
+    void reservePacket(const u32 &t_qwords);
+    void sendCurrentPacket();
+    u32 getFlags(u8 t_addDrawWait);
+    void addQuantizedPackages(DisplayList &t_displayList, const u32 &t_vertCount, VECTOR *t_vertices, VECTOR *t_coordinates, const u32 &t_vertsPerBuff);
+    void addInstance(color_t *t_color, const u32 &t_vertCount, u8 t_addDrawWait, Vu1Program t_program);
+    u32 addHeader(const u32 &t_vertCount, prim_t *t_prim, TextureCacheEntry *t_texture, clutbuffer_t *t_clut, lod_t *t_lod, u8 t_addDrawWait, color_t *t_color, Vu1Program t_program);
+    /** See Vu1ProgramVariant */
+    template <u8 t_features>
+    void drawInstancesVariant(RenderData *t_renderData, u32 t_vertCount, VECTOR *t_vertices, VECTOR *t_coordinates, Matrix *t_matrices, color_t *t_colors, const u32 &t_instancesCount, TextureCacheEntry *t_texture, clutbuffer_t *t_clut, lod_t *t_lod);
+    /** See Vu1ProgramVariant */
+    template <u8 t_features>
+    void drawMeshVariant(RenderData *t_renderData, u32 t_vertCount, VECTOR *t_vertices, VECTOR *t_normals, VECTOR *t_coordinates, Mesh &t_mesh, TextureCacheEntry *t_texture, clutbuffer_t *t_clut, lod_t *t_lod, color_t *t_color);
+    template <u8 t_features>
+    void drawVertices(u32 t_start, u32 t_end, VECTOR *t_vertices, VECTOR *t_normals, VECTOR *t_coordinates, prim_t *t_prim, TextureCacheEntry *t_texture, clutbuffer_t *t_clut, lod_t *t_lod, u8 t_addDrawWait, color_t *t_color);
     packet2_t *packets[2] __attribute__((aligned(64)));
+    FrameArena *frameArena;
     packet2_t *currPacket;
     /** 
      * OpenGL name: Model
@@ -55,6 +119,8 @@ private:
      * Sony name: local screen
      */
     Matrix modelViewProj;
+    /** Dequantization of last drawn quantized display list. Needed for drawTheSameWithOtherMatrices() */
+    Matrix dequantization;
     u8 context;
     VECTOR position, rotation;
     u32 vertCount;
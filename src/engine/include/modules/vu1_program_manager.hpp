@@ -0,0 +1,173 @@
+/*
+# ______       ____   ___
+#   |     \/   ____| |___|    
+#   |     |   |   \  |   |       
+#-----------------------------------------------------------------------
+# Copyright 2020, tyra - https://github.com/h4570/tyra
+# Licenced under Apache License 2.0
+# Sandro Sobczyński <sandro.sobczynski@gmail.com>
+*/
+
+#ifndef _TYRA_VU1_PROGRAM_MANAGER_
+#define _TYRA_VU1_PROGRAM_MANAGER_
+
+#include <tamtypes.h>
+#include <packet2.h>
+
+/** Features of VU1 program. Every combination is a separate microprogram, so VU1 has no per vertex branches. */
+enum Vu1Feature
+{
+    /** Texture coordinates are sent and perspective corrected. Without it only RGBA is drawn */
+    VU1_FEATURE_STQ = 1,
+    /** Triangle strips (see MeshMaterial::getStripFaces()) */
+    VU1_FEATURE_STRIP = 2,
+    /** Interpolation of two baked animation frames (see BakedAnimation) */
+    VU1_FEATURE_LERP = 4,
+    /** Gouraud shading from normals and lights (see Light::calculateLight()) */
+    VU1_FEATURE_LIT = 8,
+    /** Guard band and near/far plane clipping of triangles (see Mesh::shouldBeClipped) */
+    VU1_FEATURE_CLIP = 16,
+    /** Vertices and STs are unpacked from s16 and dequantized by VU1 (see VertexQuantizer) */
+    VU1_FEATURE_QUANTIZED = 32
+};
+
+/** VU1 microprograms (combinations of Vu1Feature). Used also in render queue sort key. */
+enum Vu1Program
+{
+    VU1_PROGRAM_DRAW3D_RGBA = 0,
+    VU1_PROGRAM_DRAW3D = VU1_FEATURE_STQ,
+    VU1_PROGRAM_DRAW3D_STRIP_RGBA = VU1_FEATURE_STRIP,
+    VU1_PROGRAM_DRAW3D_STRIP = VU1_FEATURE_STRIP | VU1_FEATURE_STQ,
+    VU1_PROGRAM_DRAW3D_LERP_RGBA = VU1_FEATURE_LERP,
+    VU1_PROGRAM_DRAW3D_LERP = VU1_FEATURE_LERP | VU1_FEATURE_STQ,
+    VU1_PROGRAM_DRAW3D_LIT_RGBA = VU1_FEATURE_LIT,
+    VU1_PROGRAM_DRAW3D_LIT = VU1_FEATURE_LIT | VU1_FEATURE_STQ,
+    VU1_PROGRAM_DRAW3D_CLIP_RGBA = VU1_FEATURE_CLIP,
+    VU1_PROGRAM_DRAW3D_CLIP = VU1_FEATURE_CLIP | VU1_FEATURE_STQ,
+    VU1_PROGRAM_DRAW3D_QUANTIZED_RGBA = VU1_FEATURE_QUANTIZED,
+    VU1_PROGRAM_DRAW3D_QUANTIZED = VU1_FEATURE_QUANTIZED | VU1_FEATURE_STQ
+};
+
+/** Size of table indexed by Vu1Program. Not every index is valid program. */
+const u8 VU1_PROGRAMS_TABLE_SIZE = 64;
+
+/** VU1 micro memory size in 64bit instructions. */
+const u32 VU1_MICRO_MEMORY_SIZE = 2048;
+
+const u32 VU1_PACKAGE_VERTS_PER_BUFF = 96; // Remember to modify buffer size in vu1 also
+/** Lerp program gets two frames and lit program gets normals, so less vertices fit into VU1 buffer */
+const u32 VU1_LARGE_PACKAGE_VERTS_PER_BUFF = 78;
+/** Clip program keeps free space for new vertices and clip polygons at the end of VU1 buffer */
+const u32 VU1_CLIP_PACKAGE_VERTS_PER_BUFF = 48;
+/** Quantized program header has one more qword (dequantization of STs) */
+const u32 VU1_QUANTIZED_PACKAGE_VERTS_PER_BUFF = 93;
+
+/**
+ * Vertices sent again at start of next package.
+ * Package [start, end) is followed by [end - 2, ...), so first triangle of next package
+ * is made of last two vertices of previous one and the next vertex.
+ * The same for lists (packages have 3n + 2 vertices) and strips (parity is in vertex flags).
+ */
+const u32 VU1_PACKAGE_OVERLAP = 3;
+
+/** Returns end (exclusive) of package which begins at t_start. */
+inline u32 getVu1PackageEnd(const u32 &t_start, const u32 &t_vertCount, const u32 &t_vertsPerBuff = VU1_PACKAGE_VERTS_PER_BUFF)
+{
+    return t_start + (t_vertsPerBuff - 1) > t_vertCount ? t_vertCount : t_start + (t_vertsPerBuff - 1);
+}
+
+/** Returns start of package after package which ends at t_end. t_vertCount if there is no next package. */
+inline u32 getVu1NextPackageStart(const u32 &t_end, const u32 &t_vertCount)
+{
+    return t_end == t_vertCount ? t_vertCount : t_end + 1 - VU1_PACKAGE_OVERLAP;
+}
+
+/**
+ * Compile time description of VU1 program.
+ * Used by VifSender templates, so packing code of every program has no runtime checks.
+ */
+template <u8 t_features>
+class Vu1ProgramVariant
+{
+
+public:
+    static const Vu1Program program = static_cast<Vu1Program>(t_features);
+    static const u8 hasSTQ = (t_features & VU1_FEATURE_STQ) != 0;
+    static const u8 hasNormals = (t_features & VU1_FEATURE_LIT) != 0;
+    static const u8 isStrip = (t_features & VU1_FEATURE_STRIP) != 0;
+    static const u8 isQuantized = (t_features & VU1_FEATURE_QUANTIZED) != 0;
+    static const u32 vertsPerBuff = (t_features & VU1_FEATURE_CLIP) ? VU1_CLIP_PACKAGE_VERTS_PER_BUFF : (t_features & (VU1_FEATURE_LERP | VU1_FEATURE_LIT)) ? VU1_LARGE_PACKAGE_VERTS_PER_BUFF : (t_features & VU1_FEATURE_QUANTIZED) ? VU1_QUANTIZED_PACKAGE_VERTS_PER_BUFF : VU1_PACKAGE_VERTS_PER_BUFF;
+
+private:
+    Vu1ProgramVariant();
+};
+
+struct Vu1ProgramManagerStats
+{
+    /** Draws, which needed other program than previous one. */
+    u32 switches;
+    /** Programs sent to VU1 micro memory. */
+    u32 uploads;
+    /** Times, when micro memory was full and all programs were removed. */
+    u32 evictions;
+};
+
+/**
+ * Class responsible for VU1 micro memory.
+ * Programs are uploaded lazily (MPG), just before their first draw,
+ * so only used variants take space. When there is no space, all programs are evicted.
+ */
+class Vu1ProgramManager
+{
+
+public:
+    Vu1ProgramManager();
+    ~Vu1ProgramManager();
+
+    // ----
+    // Getters
+    // ----
+
+    /** Stats of last finished frame. */
+    inline const Vu1ProgramManagerStats &getStats() const { return lastFrameStats; };
+
+    inline const u8 isResident(const Vu1Program &t_program) const { return programs[t_program].isResident; };
+
+    /** Qwords, which use() will add to packet. 0 if program is resident. */
+    u32 getUploadSize(const Vu1Program &t_program) const;
+
+    // ----
+    //  Other
+    // ----
+
+    /**
+     * Adds program upload to chain packet, if program is not in micro memory.
+     * Returns address for MSCAL.
+     */
+    u32 use(packet2_t *t_packet, const Vu1Program &t_program);
+
+    /**
+     * Save stats and begin next frame.
+     * Do not call this method unless you know what you do.
+     * Should be called by renderer.
+     */
+    void endFrame();
+
+private:
+    struct Vu1ProgramEntry
+    {
+        u32 *start, *end;
+        u32 address;
+        u8 isResident;
+    };
+    Vu1ProgramEntry programs[VU1_PROGRAMS_TABLE_SIZE];
+    /** First free instruction of micro memory. */
+    u32 freeAddress;
+    u8 currentProgram;
+    Vu1ProgramManagerStats stats, lastFrameStats;
+    void setProgram(const Vu1Program &t_program, u32 *t_start, u32 *t_end);
+    void evictAll();
+    void resetStats(Vu1ProgramManagerStats &t_stats);
+};
+
+#endif
@@ -0,0 +1,168 @@
+/*
+# ______       ____   ___
+#   |     \/   ____| |___|    
+#   |     |   |   \  |   |       
+#-----------------------------------------------------------------------
+# Copyright 2020, tyra - https://github.com/h4570/tyra
+# Licenced under Apache License 2.0
+# Sandro Sobczyński <sandro.sobczynski@gmail.com>
+*/
+
+#ifndef _TYRA_HANDLE_TABLE_
+#define _TYRA_HANDLE_TABLE_
+
+#include <tamtypes.h>
+#include <vector>
+#include "./debug.hpp"
+
+/** Max 15 types, type is stored in 4 bits of handle. */
+enum HandleType
+{
+    HANDLE_TYPE_NONE = 0,
+    HANDLE_TYPE_TEXTURE,
+    HANDLE_TYPE_MESH,
+    HANDLE_TYPE_MESH_FRAME,
+    HANDLE_TYPE_MESH_MATERIAL,
+    HANDLE_TYPE_SPRITE,
+    HANDLE_TYPE_FILE_TASK,
+    HANDLE_TYPE_AUDIO_LISTENER,
+    HANDLE_TYPES_COUNT
+};
+
+/** Never a valid handle */
+const u32 HANDLE_NONE = 0;
+const u32 HANDLE_MAX_GENERATION = 0xFFF;
+const u32 HANDLE_MAX_INDEX = 0xFFFF;
+
+/** Handle layout: [31-28] type | [27-16] generation | [15-0] index. */
+class Handle
+{
+
+public:
+    static inline u32 create(const HandleType &t_type, const u16 &t_generation, const u16 &t_index)
+    {
+        return ((u32)t_type << 28) | ((u32)(t_generation & HANDLE_MAX_GENERATION) << 16) | (u32)t_index;
+    }
+
+    static inline HandleType getType(const u32 &t_handle) { return static_cast<HandleType>(t_handle >> 28); }
+
+    static inline u16 getGeneration(const u32 &t_handle) { return (t_handle >> 16) & HANDLE_MAX_GENERATION; }
+
+    static inline u16 getIndex(const u32 &t_handle) { return t_handle & HANDLE_MAX_INDEX; }
+
+private:
+    Handle();
+};
+
+/**
+ * Items stored in dense array, accessed in O(1) via generation checked handles.
+ * Removed slot gets new generation, so old handles of it become invalid.
+ * Removing swaps last item into the removed place, so item order is not kept.
+ */
+template <class T>
+class HandleTable
+{
+
+public:
+    HandleTable(const HandleType &t_type) : type(t_type) {}
+    ~HandleTable() {}
+
+    // ----
+    // Getters
+    // ----
+
+    inline u32 getCount() const { return static_cast<u32>(items.size()); }
+
+    /** Dense array of items. Size of getCount() */
+    inline std::vector<T> &getAll() { return items; }
+
+    /** Handle of item at dense index. */
+    inline const u32 &getHandleAt(const u32 &t_denseIndex) const { return handles[t_denseIndex]; }
+
+    inline const HandleType &getType() const { return type; }
+
+    const u8 isValid(const u32 &t_handle) const
+    {
+        const u16 index = Handle::getIndex(t_handle);
+        return Handle::getType(t_handle) == type &&
+               index < slots.size() &&
+               slots[index].generation == Handle::getGeneration(t_handle) &&
+               slots[index].denseIndex != NO_DENSE_INDEX;
+    }
+
+    /**
+     * Returns item.
+     * NULL if handle was removed or belongs to other table.
+     */
+    T *get(const u32 &t_handle)
+    {
+        if (!isValid(t_handle))
+            return NULL;
+        return &items[slots[Handle::getIndex(t_handle)].denseIndex];
+    }
+
+    // ----
+    //  Other
+    // ----
+
+    /** Returns new handle. */
+    u32 add(const T &t_item)
+    {
+        u16 index;
+        if (freeSlots.size() > 0)
+        {
+            index = freeSlots.back();
+            freeSlots.pop_back();
+        }
+        else
+        {
+            assertMsg(slots.size() < HANDLE_MAX_INDEX, "Handle table is full!");
+            index = static_cast<u16>(slots.size());
+            HandleTableSlot slot;
+            slot.generation = 0;
+            slots.push_back(slot);
+        }
+        slots[index].denseIndex = static_cast<u16>(items.size());
+        const u32 handle = Handle::create(type, slots[index].generation, index);
+        items.push_back(t_item);
+        handles.push_back(handle);
+        return handle;
+    }
+
+    /** Returns false, if handle was not valid. */
+    u8 remove(const u32 &t_handle)
+    {
+        if (!isValid(t_handle))
+            return false;
+        const u16 index = Handle::getIndex(t_handle);
+        const u16 denseIndex = slots[index].denseIndex;
+        const u16 lastDenseIndex = static_cast<u16>(items.size() - 1);
+        if (denseIndex != lastDenseIndex)
+        {
+            items[denseIndex] = items[lastDenseIndex];
+            handles[denseIndex] = handles[lastDenseIndex];
+            slots[Handle::getIndex(handles[denseIndex])].denseIndex = denseIndex;
+        }
+        items.pop_back();
+        handles.pop_back();
+        slots[index].denseIndex = NO_DENSE_INDEX;
+        slots[index].generation = (slots[index].generation + 1) & HANDLE_MAX_GENERATION;
+        freeSlots.push_back(index);
+        return true;
+    }
+
+private:
+    static const u16 NO_DENSE_INDEX = 0xFFFF;
+    struct HandleTableSlot
+    {
+        u16 generation;
+        u16 denseIndex;
+    };
+    HandleType type;
+    std::vector<T> items;
+    std::vector<u32> handles;
+    std::vector<HandleTableSlot> slots;
+    std::vector<u16> freeSlots;
+};
+
+#endif
@@ -0,0 +1,34 @@
+/*
+# ______       ____   ___
+#   |     \/   ____| |___|    
+#   |     |   |   \  |   |       
+#-----------------------------------------------------------------------
+# Copyright 2020, tyra - https://github.com/h4570/tyra
+# Licenced under Apache License 2.0
+# Sandro Sobczyński <sandro.sobczynski@gmail.com>
+*/
+
+#ifndef _TYRA_HASH_
+#define _TYRA_HASH_
+
+#include <tamtypes.h>
+
+class Hash
+{
+
+public:
+    /**
+     * FNV-1a hash of string.
+     * Can be calculated at compile time, so it can be used in switch case:
+     * switch (Hash::fnv1a(name)) { case Hash::fnv1a("water"): ... }
+     */
+    constexpr static u32 fnv1a(const char *t_text, const u32 t_hash = 2166136261U)
+    {
+        return *t_text == '\0' ? t_hash : fnv1a(t_text + 1, (t_hash ^ static_cast<u8>(*t_text)) * 16777619U);
+    }
+
+private:
+    Hash();
+};
+
+#endif
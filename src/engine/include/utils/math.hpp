@@ -42,6 +42,18 @@ public:
     static inline s32 min(s32 a, s32 b) { return (a < b) ? a : b; }
     static inline float min(float a, float b) { return (a < b) ? a : b; }
 
+    /** Fast log2 (exponent + linear mantissa). Max error ~0.09. x have to be > 0 */
+    static inline float log2(float x)
+    {
+        union
+        {
+            float f;
+            u32 i;
+        } bits;
+        bits.f = x;
+        return (float)((s32)(bits.i >> 23) - 127) + (float)(bits.i & 0x7FFFFF) / 8388608.0F;
+    }
+
 private:
     Math();
 };
@@ -0,0 +1,45 @@
+/*
+# ______       ____   ___
+#   |     \/   ____| |___|    
+#   |     |   |   \  |   |       
+#-----------------------------------------------------------------------
+# Copyright 2020, tyra - https://github.com/h4570/tyra
+# Licenced under Apache License 2.0
+# Sandro Sobczyński <sandro.sobczynski@gmail.com>
+*/
+
+#ifndef _TYRA_MESH_SIMPLIFIER_
+#define _TYRA_MESH_SIMPLIFIER_
+
+#include <tamtypes.h>
+#include "../models/math/vector3.hpp"
+
+/** 
+ * Quadric error metric simplification (Garland & Heckbert) of triangle list.
+ * Only half-edge collapses are done (vertex is moved into its neighbour),
+ * so simplified faces are valid for vertices of every animation frame.
+ * Errors are summed from all given frames. Borders of mesh are kept by penalty planes.
+ * Pure EE/host code. It is slow, so use it at loading time, not every frame.
+ */
+class MeshSimplifier
+{
+
+public:
+    /**
+     * @param t_frames Vertices of animation frames. Every frame have t_vertexCount vertices.
+     * @param t_facesCount Count of faces (3 per triangle).
+     * @param t_lockedVertices Vertices which can't be removed (for example shared with other material). Can be NULL.
+     * @param t_targetFacesCount Simplification stops when there is no more faces than this value.
+     * @param o_vertexFaces, o_stFaces, o_normalFaces Output faces. Have to be at least t_facesCount long.
+     * @returns Count of output faces. Never bigger than t_facesCount.
+     */
+    static u32 simplify(const Vector3 *const *t_frames, const u32 &t_framesCount, const u32 &t_vertexCount,
+                        const u32 *t_vertexFaces, const u32 *t_stFaces, const u32 *t_normalFaces, const u32 &t_facesCount,
+                        const u8 *t_lockedVertices, const u32 &t_targetFacesCount,
+                        u32 *o_vertexFaces, u32 *o_stFaces, u32 *o_normalFaces);
+
+private:
+    MeshSimplifier();
+};
+
+#endif
@@ -0,0 +1,42 @@
+/*
+# ______       ____   ___
+#   |     \/   ____| |___|    
+#   |     |   |   \  |   |       
+#-----------------------------------------------------------------------
+# Copyright 2020, tyra - https://github.com/h4570/tyra
+# Licenced under Apache License 2.0
+# Sandro Sobczyński <sandro.sobczynski@gmail.com>
+*/
+
+#ifndef _TYRA_QUANTIZER_
+#define _TYRA_QUANTIZER_
+
+#include <tamtypes.h>
+
+/** 
+ * Median cut color quantization.
+ * Used for conversion of truecolor images to 16/256 colors palette textures.
+ * Pure EE/host code, so it is used by tools/quantizer too.
+ */
+class Quantizer
+{
+
+public:
+    /**
+     * Reduces colors to palette of max given colors count.
+     * If image has not more unique colors than t_maxColors, result is lossless.
+     * @param t_pixels RGBA pixels, 4 bytes per pixel.
+     * @param o_palette RGBA colors, have to be at least t_maxColors * 4 bytes.
+     * @param o_indexes Palette index of every pixel, 1 byte per pixel.
+     * @returns Number of used palette colors.
+     */
+    static u32 medianCut(const u8 *t_pixels, const u32 &t_pixelsCount, const u32 &t_maxColors, u8 *o_palette, u8 *o_indexes);
+
+    /** Returns index of palette color nearest (RGBA squared distance) to given RGBA color. */
+    static u8 findNearest(const u8 *t_palette, const u32 &t_colorsCount, const u8 *t_color);
+
+private:
+    Quantizer();
+};
+
+#endif
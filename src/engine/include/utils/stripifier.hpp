@@ -0,0 +1,40 @@
+/*
+# ______       ____   ___
+#   |     \/   ____| |___|    
+#   |     |   |   \  |   |       
+#-----------------------------------------------------------------------
+# Copyright 2020, tyra - https://github.com/h4570/tyra
+# Licenced under Apache License 2.0
+# Sandro Sobczyński <sandro.sobczynski@gmail.com>
+*/
+
+#ifndef _TYRA_STRIPIFIER_
+#define _TYRA_STRIPIFIER_
+
+#include <tamtypes.h>
+
+/** 
+ * Greedy conversion of triangle list into triangle strips.
+ * Strips are not joined by degenerate triangles. First two vertices
+ * of every strip are marked as restart, so they are sent with ADC bit.
+ * Winding of input triangles is kept (with usual reversal of every second strip triangle).
+ * Pure EE/host code.
+ */
+class Stripifier
+{
+
+public:
+    /**
+     * Corners are the same vertex, when their vertex, st and normal indexes are equal.
+     * @param t_facesCount Count of faces (3 per triangle).
+     * @param o_faces Indexes of input faces in strip order. Have to be at least t_facesCount long.
+     * @param o_restarts 1 for first two vertices of every strip. Have to be at least t_facesCount long.
+     * @returns Count of strip vertices. Never bigger than t_facesCount.
+     */
+    static u32 generate(const u32 *t_vertexFaces, const u32 *t_stFaces, const u32 *t_normalFaces, const u32 &t_facesCount, u32 *o_faces, u8 *o_restarts);
+
+private:
+    Stripifier();
+};
+
+#endif
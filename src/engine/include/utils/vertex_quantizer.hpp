@@ -0,0 +1,51 @@
+/*
+# ______       ____   ___
+#   |     \/   ____| |___|    
+#   |     |   |   \  |   |       
+#-----------------------------------------------------------------------
+# Copyright 2020, tyra - https://github.com/h4570/tyra
+# Licenced under Apache License 2.0
+# Sandro Sobczyński <sandro.sobczynski@gmail.com>
+*/
+
+
+#ifndef _TYRA_VERTEX_QUANTIZER_
+#define _TYRA_VERTEX_QUANTIZER_
+
+#include <tamtypes.h>
+#include <math3d.h>
+
+/** Max absolute value of quantized component. -32768 is not used, so range is symmetric. */
+const s16 VERTEX_QUANTIZER_MAX = 32767;
+
+/** 
+ * Conversion of vertices and texture coords into signed 16 bit fixed point.
+ * Values are stored relative to their bounding box: value = quantized * scale + offset.
+ * Max error of dequantized value is half of scale (per component).
+ * Pure EE/host code.
+ */
+class VertexQuantizer
+{
+
+public:
+    /**
+     * Calculates scale and offset, which map bounding box of values into s16 range.
+     * @param t_components Count of used components (3 for vertices, 2 for texture coords).
+     */
+    static void getBounds(const VECTOR *t_values, const u32 &t_count, const u8 &t_components, VECTOR o_scale, VECTOR o_offset);
+
+    /** Writes x, y, z, 1 per vertex (VIF V4-16 unpack). w is 1, so vertex can be multiplied by matrix directly. */
+    static void quantizeVertices(const VECTOR *t_vertices, const u32 &t_count, const VECTOR t_scale, const VECTOR t_offset, s16 *o_result);
+
+    /** Writes s, t per texture coord (VIF V2-16 unpack). */
+    static void quantizeCoordinates(const VECTOR *t_coordinates, const u32 &t_count, const VECTOR t_scale, const VECTOR t_offset, s16 *o_result);
+
+    static s16 quantize(const float &t_value, const float &t_scale, const float &t_offset);
+
+    inline static float dequantize(const s16 &t_value, const float &t_scale, const float &t_offset) { return t_value * t_scale + t_offset; }
+
+private:
+    VertexQuantizer();
+};
+
+#endif
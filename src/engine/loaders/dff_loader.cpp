@@ -48,6 +48,7 @@ void DffLoader::load(MeshFrame *o_result, char *t_filename, float t_scale, u8 t_
     fclose(file);
     serialize(o_result, t_invertT, data, t_scale);
     o_result->calculateBoundingBoxes();
+    o_result->generateStrips();
     delete[] path;
     consoleLog("Dff file loaded!");
 }
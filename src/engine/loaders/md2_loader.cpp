@@ -80,16 +80,23 @@ MeshFrame *MD2Loader::load(u32 &o_framesCount, char *t_subpath, char *t_nameWith
 
     MeshFrame *resultFrames = new MeshFrame[framesCount];
 
+    // Faces and STs are the same in all frames, so only first frame owns them
+    resultFrames[0].allocateSTs(stsCount);
+    resultFrames[0].allocateMaterials(1);
+    MeshMaterial &material = resultFrames[0].getMaterial(0);
+    material.allocateFaces(trianglesCount * 3);
+    material.setName(t_nameWithoutExtension);
+    material.setSTsPresent(true);
+    material.setNormalsPresent(true);
+
     frame_t *frame;
     Vector3 tempVec = Vector3();
     for (u32 j = 0; j < framesCount; j++)
     {
         resultFrames[j].allocateVertices(vertexCount);
         resultFrames[j].allocateNormals(vertexCount); // can be optimized
-        resultFrames[j].allocateSTs(stsCount);
-        resultFrames[j].allocateMaterials(1);
-        resultFrames[j].getMaterial(0).allocateFaces(trianglesCount * 3);
-        resultFrames[j].getMaterial(0).setName(t_nameWithoutExtension);
+        if (j > 0)
+            resultFrames[j].shareTopologyFrom(&resultFrames[0]);
         frame = (frame_t *)&framesBuffer[header.framesize * j];
         for (u32 i = 0; i < vertexCount; i++)
         {
@@ -117,8 +124,7 @@ MeshFrame *MD2Loader::load(u32 &o_framesCount, char *t_subpath, char *t_nameWith
             (float)texCoord->t / header.skinheight);
         if (t_invertT)
             tempPoint.y = 1.0F - tempPoint.y;
-        for (u32 j = 0; j < framesCount; j++)
-            resultFrames[j].setST(i, tempPoint);
+        resultFrames[0].setST(i, tempPoint);
     }
 
     triangle_t *triangle;
@@ -127,21 +133,23 @@ MeshFrame *MD2Loader::load(u32 &o_framesCount, char *t_subpath, char *t_nameWith
         triangle = (triangle_t *)&trianglesBuffer[sizeof(triangle_t) * i];
         for (u8 j = 0; j < 3; j++)
         {
-            for (u32 x = 0; x < framesCount; x++)
-            {
-                resultFrames[x].getMaterial(0).setSTsPresent(true);
-                resultFrames[x].getMaterial(0).setNormalsPresent(true);
-                resultFrames[x].getMaterial(0).setVertexFace((i * 3) + j, triangle->index_xyz[j]);
-                resultFrames[x].getMaterial(0).setSTFace((i * 3) + j, triangle->index_st[j]);
-                resultFrames[x].getMaterial(0).setNormalFace((i * 3) + j, triangle->index_xyz[j]);
-            }
+            material.setVertexFace((i * 3) + j, triangle->index_xyz[j]);
+            material.setSTFace((i * 3) + j, triangle->index_st[j]);
+            material.setNormalFace((i * 3) + j, triangle->index_xyz[j]);
         }
     }
 
+#ifndef NDEBUG
+    // 3 face arrays + STs + material, which other frames would have without sharing
+    const u32 sharedSize = trianglesCount * 3 * 3 * sizeof(u32) + stsCount * sizeof(Point) + sizeof(MeshMaterial);
+    printf("LOG: MD2 frames: %u, shared topology saved: %u bytes\n", framesCount, sharedSize * (framesCount - 1));
+#endif
+
     consoleLog("MD2 file loaded!");
     delete[] finalPath;
     o_framesCount = framesCount;
     for (u32 i = 0; i < framesCount; i++)
         resultFrames[i].calculateBoundingBoxes();
+    resultFrames[0].generateStrips(); // frames share faces, so strips of first one are used
     return resultFrames;
 }
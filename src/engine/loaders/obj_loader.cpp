@@ -12,7 +12,13 @@
 
 #include "../include/utils/debug.hpp"
 #include "../include/utils/string.hpp"
-#include <string.h>
+#include "../include/utils/hash.hpp"
+
+constexpr u32 OBJ_VERTEX = Hash::fnv1a("v");
+constexpr u32 OBJ_ST = Hash::fnv1a("vt");
+constexpr u32 OBJ_NORMAL = Hash::fnv1a("vn");
+constexpr u32 OBJ_MATERIAL = Hash::fnv1a("usemtl");
+constexpr u32 OBJ_FACE = Hash::fnv1a("f");
 
 // ----
 // Constructors/Destructors
@@ -43,31 +49,32 @@ void ObjLoader::load(MeshFrame *o_result, char *t_filename, float t_scale, u8 t_
         int res = fscanf(file, "%s", lineHeader);
         if (res != EOF)
         {
-            if (strcmp(lineHeader, "v") == 0)
+            const u32 header = Hash::fnv1a(lineHeader);
+            if (header == OBJ_VERTEX)
             {
                 fscanf(file, "%f %f %f\n", &vector.x, &vector.y, &vector.z);
                 o_result->setVertex(verticesI++, vector * t_scale);
             }
-            else if (strcmp(lineHeader, "vt") == 0)
+            else if (header == OBJ_ST)
             {
                 fscanf(file, "%f %f\n", &point.x, &point.y);
                 if (t_invertT)
                     point.y = 1.0F - point.y;
                 o_result->setST(cordsI++, point);
             }
-            else if (strcmp(lineHeader, "vn") == 0)
+            else if (header == OBJ_NORMAL)
             {
                 fscanf(file, "%f %f %f\n", &vector.x, &vector.y, &vector.z);
                 o_result->setNormal(normalsI++, vector);
             }
-            else if (strcmp(lineHeader, "usemtl") == 0)
+            else if (header == OBJ_MATERIAL)
             {
                 char temp[30];
                 fscanf(file, "%s\n", temp);
                 o_result->getMaterial(++materialsI).setName(temp);
                 faceI = 0;
             }
-            else if (strcmp(lineHeader, "f") == 0)
+            else if (header == OBJ_FACE)
             {
                 int *x = &res; // random assignment, to disable compilation warning
                 fpos_t start;
@@ -176,6 +183,7 @@ void ObjLoader::load(MeshFrame *o_result, char *t_filename, float t_scale, u8 t_
     }
 
     o_result->calculateBoundingBoxes();
+    o_result->generateStrips();
     fclose(file);
     delete[] path;
 }
@@ -194,13 +202,14 @@ void ObjLoader::allocateObjMemory(FILE *t_file, MeshFrame *o_result)
         int res = fscanf(t_file, "%s", lineHeader);
         if (res != EOF)
         {
-            if (strcmp(lineHeader, "v") == 0)
+            const u32 header = Hash::fnv1a(lineHeader);
+            if (header == OBJ_VERTEX)
                 vertexCount += 1;
-            else if (strcmp(lineHeader, "vt") == 0)
+            else if (header == OBJ_ST)
                 stsCount += 1;
-            else if (strcmp(lineHeader, "vn") == 0)
+            else if (header == OBJ_NORMAL)
                 normalsCount += 1;
-            else if (strcmp(lineHeader, "usemtl") == 0)
+            else if (header == OBJ_MATERIAL)
                 materialsCount += 1;
         }
         else
@@ -222,7 +231,8 @@ void ObjLoader::allocateObjMemory(FILE *t_file, MeshFrame *o_result)
         int res = fscanf(t_file, "%s", lineHeader);
         if (res != EOF)
         {
-            if (strcmp(lineHeader, "usemtl") == 0)
+            const u32 header = Hash::fnv1a(lineHeader);
+            if (header == OBJ_MATERIAL)
             {
                 if (currentMatI >= 0) // Skip -1
                 {
@@ -231,7 +241,7 @@ void ObjLoader::allocateObjMemory(FILE *t_file, MeshFrame *o_result)
                 }
                 currentMatI++;
             }
-            else if (strcmp(lineHeader, "f") == 0)
+            else if (header == OBJ_FACE)
                 facesCounter += 3;
         }
         else
@@ -27,6 +27,26 @@ PngLoader::~PngLoader() {}
 // Methods
 // ----
 
+/** Copies PLTE (and tRNS alpha, if present) into texture CLUT */
+static void loadPalette(Texture &o_texture, png_structp t_png, png_infop t_info)
+{
+    png_colorp palette;
+    int paletteCount = 0;
+    png_get_PLTE(t_png, t_info, &palette, &paletteCount);
+    png_bytep alphas = NULL;
+    int alphasCount = 0;
+    if (png_get_valid(t_png, t_info, PNG_INFO_tRNS))
+        png_get_tRNS(t_png, t_info, &alphas, &alphasCount, NULL);
+    const int colorsCount = paletteCount < o_texture.getClutColorsCount() ? paletteCount : o_texture.getClutColorsCount();
+    for (int i = 0; i < colorsCount; i++)
+        o_texture.setClutColor(
+            i,
+            palette[i].red,
+            palette[i].green,
+            palette[i].blue,
+            i < alphasCount ? ((int)alphas[i] * 128 / 255) : 128);
+}
+
 /**
  * @param t_name Without extension. Example "skyfall2"
  * @param t_extension With dot and extension. Example ".png"
@@ -61,16 +81,25 @@ void PngLoader::load(Texture &o_texture, char *t_subfolder, char *t_name, char *
     png_get_IHDR(png_ptr, info_ptr, &width, &height, &bit_depth, &color_type, &interlace_type, NULL, NULL);
     png_set_strip_16(png_ptr);
 
-    if (color_type == PNG_COLOR_TYPE_PALETTE)
-        png_set_expand(png_ptr);
-
-    if (color_type == PNG_COLOR_TYPE_GRAY && bit_depth < 8)
-        png_set_expand(png_ptr);
+    const u8 isPalette = color_type == PNG_COLOR_TYPE_PALETTE;
+    if (isPalette)
+    {
+        // Palette is not expanded. Indexes are loaded as PSMT4/PSMT8
+        if (bit_depth < 4)
+            png_set_packing(png_ptr);
+        else if (bit_depth == 4)
+            png_set_packswap(png_ptr); // GS wants first pixel in low nibble
+    }
+    else
+    {
+        if (color_type == PNG_COLOR_TYPE_GRAY && bit_depth < 8)
+            png_set_expand(png_ptr);
 
-    if (png_get_valid(png_ptr, info_ptr, PNG_INFO_tRNS))
-        png_set_tRNS_to_alpha(png_ptr);
+        if (png_get_valid(png_ptr, info_ptr, PNG_INFO_tRNS))
+            png_set_tRNS_to_alpha(png_ptr);
 
-    png_set_filler(png_ptr, 0xff, PNG_FILLER_AFTER);
+        png_set_filler(png_ptr, 0xff, PNG_FILLER_AFTER);
+    }
 
     png_read_update_info(png_ptr, info_ptr);
 
@@ -84,13 +113,19 @@ void PngLoader::load(Texture &o_texture, char *t_subfolder, char *t_name, char *
     case PNG_COLOR_TYPE_RGB:
         type = TEX_TYPE_RGB;
         break;
+    case PNG_COLOR_TYPE_PALETTE:
+        type = bit_depth == 4 ? TEX_TYPE_PALETTE4 : TEX_TYPE_PALETTE8;
+        break;
     default:
-        assertMsg(true == false, "This png format is not supported! RGB/RGBA only.");
+        assertMsg(true == false, "This png format is not supported! RGB/RGBA/Palette only.");
     }
 
     o_texture.setSize(width, height, type);
     printf("PNGLoader - width: %d | height: %d\n", width, height);
 
+    if (isPalette)
+        loadPalette(o_texture, png_ptr, info_ptr);
+
     size_t row_bytes = png_get_rowbytes(png_ptr, info_ptr);
     png_byte *row_pointers[height];
     for (row = 0; row < height; row++)
@@ -100,20 +135,28 @@ void PngLoader::load(Texture &o_texture, char *t_subfolder, char *t_name, char *
 
     u32 x = 0;
 
-    for (i = 0; i < height; i++)
-        for (j = 0; j < width; j++)
-        {
-            o_texture.setData(x, row_pointers[i][4 * j]);
-            o_texture.setData(x + 1, row_pointers[i][4 * j + 1]);
-            o_texture.setData(x + 2, row_pointers[i][4 * j + 2]);
-            if (type == TEX_TYPE_RGBA)
+    if (isPalette)
+    {
+        const u32 indexesRowBytes = type == TEX_TYPE_PALETTE4 ? width / 2 : width;
+        for (i = 0; i < height; i++)
+            for (j = 0; j < indexesRowBytes; j++)
+                o_texture.setData(x++, row_pointers[i][j]);
+    }
+    else
+        for (i = 0; i < height; i++)
+            for (j = 0; j < width; j++)
             {
-                o_texture.setData(x + 3, ((int)row_pointers[i][4 * j + 3] * 128 / 255));
-                x += 4;
+                o_texture.setData(x, row_pointers[i][4 * j]);
+                o_texture.setData(x + 1, row_pointers[i][4 * j + 1]);
+                o_texture.setData(x + 2, row_pointers[i][4 * j + 2]);
+                if (type == TEX_TYPE_RGBA)
+                {
+                    o_texture.setData(x + 3, ((int)row_pointers[i][4 * j + 3] * 128 / 255));
+                    x += 4;
+                }
+                else if (type == TEX_TYPE_RGB)
+                    x += 3;
             }
-            else if (type == TEX_TYPE_RGB)
-                x += 3;
-        }
 
     for (row = 0; row < height; row++)
         delete[] row_pointers[row];
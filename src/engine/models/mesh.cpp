@@ -16,7 +16,20 @@
 #include "../include/models/texture.hpp"
 #include "../include/utils/debug.hpp"
 #include "../include/utils/string.hpp"
-#include <cstdlib>
+#include "../include/utils/handle_table.hpp"
+#include "../include/modules/display_list.hpp"
+#include "../include/modules/baked_animation.hpp"
+#include "../include/modules/frustum_culler.hpp"
+#include "../include/utils/mesh_simplifier.hpp"
+#include "../include/utils/math.hpp"
+#include <cstring>
+
+/** Function scoped, so it is constructed before any global mesh */
+static HandleTable<Mesh *> &getHandles()
+{
+    static HandleTable<Mesh *> handles(HANDLE_TYPE_MESH);
+    return handles;
+}
 
 // ----
 // Constructors/Destructors
@@ -24,14 +37,24 @@
 
 Mesh::Mesh()
 {
-    id = rand() % 1000000;
+    id = getHandles().add(this);
     shouldBeFrustumCulled = true;
     shouldBeBackfaceCulled = false;
     shouldBeLighted = false;
+    shouldBeClipped = false;
     _areFramesAllocated = false;
     _isMother = false;
+    _isStatic = false;
+    _isQuantized = false;
+    _isAnimatedOnVU1 = false;
+    displayLists = NULL;
+    displayListsCount = 0;
+    bakedAnimations = NULL;
+    bakedAnimationsCount = 0;
     scale = 1.0F;
     framesCount = 0;
+    lodLevelsCount = 1;
+    lodLevel = 0;
     animState.startFrame = 0;
     animState.endFrame = 0;
     animState.interpolation = 0.0F;
@@ -46,8 +69,12 @@ Mesh::Mesh()
 
 Mesh::~Mesh()
 {
+    getHandles().remove(id);
     if (_areFramesAllocated)
         delete[] frames;
+    deleteLODLevels();
+    deleteDisplayLists();
+    deleteBakedAnimations();
 }
 
 // ----
@@ -66,6 +93,7 @@ void Mesh::loadObj(char *t_subfolder, char *t_objFile, const float &t_scale, con
     delete[] part1;
     delete[] finalPath;
     _isMother = true;
+    frames[0].bakeDrawData();
 }
 
 void Mesh::loadObj(char *t_subfolder, char *t_objFile, const float &t_scale, const u32 &t_framesCount, const u8 &t_invertT)
@@ -88,6 +116,14 @@ void Mesh::loadObj(char *t_subfolder, char *t_objFile, const float &t_scale, con
             char *part5 = String::createConcatenated(part2, part4);      // "folder/object_000001"
             char *finalPath = String::createConcatenated(part5, ".obj"); // "folder/object_000001.obj"
             loader.load(&frames[i], finalPath, t_scale, t_invertT);
+            // Exporters write the same faces and STs into every frame file, so first frame ones are shared
+            if (i > 0)
+            {
+                if (frames[i].hasTheSameTopology(frames[0]))
+                    frames[i].shareTopologyFrom(&frames[0]);
+                else
+                    consoleLog("Frame faces are different than first frame ones, so they are not shared!");
+            }
             delete[] part3;
             delete[] part4;
             delete[] part5;
@@ -111,6 +147,7 @@ void Mesh::loadDff(char *t_subfolder, char *t_dffFile, const float &t_scale, con
     delete[] part1;
     delete[] dffPath;
     _isMother = true;
+    frames[0].bakeDrawData();
 }
 
 void Mesh::loadMD2(char *t_subfolder, char *t_md2File, const float &t_scale, const u8 &t_invertT)
@@ -118,6 +155,9 @@ void Mesh::loadMD2(char *t_subfolder, char *t_md2File, const float &t_scale, con
     MD2Loader loader = MD2Loader();
     frames = loader.load(framesCount, t_subfolder, t_md2File, t_scale, t_invertT);
     _isMother = true;
+    // Animated meshes are interpolated every frame, so only not animated ones are baked
+    if (framesCount == 1)
+        frames[0].bakeDrawData();
 }
 
 void Mesh::loadFrom(const Mesh &t_mesh)
@@ -126,7 +166,152 @@ void Mesh::loadFrom(const Mesh &t_mesh)
     frames = new MeshFrame[framesCount];
     _areFramesAllocated = true;
     for (u32 i = 0; i < framesCount; i++)
+    {
         frames[i].copyFrom(&t_mesh.getFrame(i));
+        if (t_mesh.getFrame(i).isTopologyShared())
+            frames[i].shareTopologyFrom(&frames[0]);
+    }
+    lodLevelsCount = t_mesh.lodLevelsCount;
+    for (u32 level = 1; level < lodLevelsCount; level++)
+    {
+        lodFrames[level] = new MeshFrame[framesCount];
+        for (u32 i = 0; i < framesCount; i++)
+        {
+            lodFrames[level][i].copyFrom(&t_mesh.lodFrames[level][i]);
+            if (t_mesh.lodFrames[level][i].isTopologyShared())
+                lodFrames[level][i].shareTopologyFrom(&lodFrames[level][0]);
+        }
+        lodScreenSizes[level] = t_mesh.lodScreenSizes[level];
+    }
+}
+
+void Mesh::generateLOD(const u32 &t_levelsCount, const float &t_ratio, const float &t_screenSize)
+{
+    assertMsg(framesCount > 0, "Cant generate LOD, because no mesh data was loaded!");
+    assertMsg(t_levelsCount > 0 && t_levelsCount <= MESH_MAX_LOD_LEVELS, "Wrong LOD levels count!");
+    assertMsg(t_ratio > 0.0F && t_ratio < 1.0F, "LOD ratio should be between 0.0F and 1.0F!");
+    deleteLODLevels();
+    const u32 &materialsCount = getMaterialsCount();
+    const u32 &vertexCount = frames[0].getVertexCount();
+
+    // Vertices used by many materials are locked, so there will be no holes between materials
+    const u32 noMaterial = 0xFFFFFFFF;
+    u32 *vertexMaterials = new u32[vertexCount];
+    u8 *lockedVertices = new u8[vertexCount];
+    for (u32 i = 0; i < vertexCount; i++)
+    {
+        vertexMaterials[i] = noMaterial;
+        lockedVertices[i] = false;
+    }
+    for (u32 i = 0; i < materialsCount; i++)
+    {
+        MeshMaterial &material = getMaterial(i);
+        for (u32 j = 0; j < material.getFacesCount(); j++)
+        {
+            const u32 &vertex = material.getVertexFace(j);
+            if (vertexMaterials[vertex] == noMaterial)
+                vertexMaterials[vertex] = i;
+            else if (vertexMaterials[vertex] != i)
+                lockedVertices[vertex] = true;
+        }
+    }
+    delete[] vertexMaterials;
+
+    const Vector3 **frameVertices = new const Vector3 *[framesCount];
+    for (u32 i = 0; i < framesCount; i++)
+        frameVertices[i] = frames[i].getVertices();
+
+    float ratio = 1.0F;
+    for (u32 level = 1; level < t_levelsCount; level++)
+    {
+        ratio *= t_ratio;
+        lodFrames[level] = new MeshFrame[framesCount];
+        for (u32 i = 0; i < framesCount; i++)
+        {
+            lodFrames[level][i].copyFrom(&frames[i]);
+            if (frames[i].isTopologyShared())
+                lodFrames[level][i].shareTopologyFrom(&lodFrames[level][0]);
+        }
+        // Every level is simplified from previous one, so it is faster and levels are similar
+        MeshFrame *previous = level == 1 ? frames : lodFrames[level - 1];
+        for (u32 i = 0; i < materialsCount; i++)
+        {
+            MeshMaterial &source = previous[0].getMaterial(i);
+            MeshMaterial &target = lodFrames[level][0].getMaterial(i);
+            const u32 &sourceCount = source.getFacesCount();
+            u32 *vertexFaces = new u32[sourceCount];
+            u32 *stFaces = new u32[sourceCount];
+            u32 *normalFaces = new u32[sourceCount];
+            const u32 targetCount = static_cast<u32>(getMaterial(i).getFacesCount() * ratio);
+            const u32 count = MeshSimplifier::simplify(
+                frameVertices, framesCount, vertexCount,
+                source.getVertexFaces(), source.getSTFaces(), source.getNormalFaces(), sourceCount,
+                lockedVertices, targetCount, vertexFaces, stFaces, normalFaces);
+
+            // Shrink arrays to result size
+            u32 *resultVertexFaces = new u32[count];
+            u32 *resultSTFaces = new u32[count];
+            u32 *resultNormalFaces = new u32[count];
+            for (u32 j = 0; j < count; j++)
+            {
+                resultVertexFaces[j] = vertexFaces[j];
+                resultSTFaces[j] = stFaces[j];
+                resultNormalFaces[j] = normalFaces[j];
+            }
+            delete[] vertexFaces;
+            delete[] stFaces;
+            delete[] normalFaces;
+
+            target.setFaces(resultVertexFaces, resultSTFaces, resultNormalFaces, count);
+            if (getMaterial(i).areStripsPresent() && count > 0)
+                target.generateStrips();
+            for (u32 j = 1; j < framesCount; j++)
+                if (!lodFrames[level][j].isTopologyShared())
+                    lodFrames[level][j].getMaterial(i).referenceFacesFrom(target);
+        }
+        if (framesCount == 1)
+            lodFrames[level][0].bakeDrawData();
+        lodScreenSizes[level] = t_screenSize / static_cast<float>(1 << (level - 1));
+    }
+    lodLevelsCount = t_levelsCount;
+
+    delete[] frameVertices;
+    delete[] lockedVertices;
+}
+
+void Mesh::updateLOD(const float &t_screenSize)
+{
+    // Level "i" is used below lodScreenSizes[i]
+    while (lodLevel + 1 < lodLevelsCount && t_screenSize < lodScreenSizes[lodLevel + 1] * (1.0F - MESH_LOD_HYSTERESIS))
+        lodLevel++;
+    while (lodLevel > 0 && t_screenSize > lodScreenSizes[lodLevel] * (1.0F + MESH_LOD_HYSTERESIS))
+        lodLevel--;
+}
+
+void Mesh::setLODLevel(const u32 &t_level)
+{
+    assertMsg(t_level < lodLevelsCount, "LOD level value is too high. Valid range: (0, getLODLevelsCount()-1)");
+    lodLevel = t_level;
+}
+
+void Mesh::deleteLODLevels()
+{
+    // Display lists and baked animations are kept per level
+    deleteDisplayLists();
+    deleteBakedAnimations();
+    for (u32 level = 1; level < lodLevelsCount; level++)
+        delete[] lodFrames[level];
+    lodLevelsCount = 1;
+    lodLevel = 0;
+}
+
+float Mesh::getCurrentBoundingRadius() const
+{
+    const Vector3 *box = getCurrentBoundingBoxVertices();
+    float result = 0.0F;
+    for (u8 i = 0; i < 8; i++)
+        result = Math::max(result, box[i].length());
+    return result * scale;
 }
 
 void Mesh::playAnimation(const u32 &t_startFrame, const u32 &t_endFrame)
@@ -187,8 +372,9 @@ u32 Mesh::getDrawData(u32 t_materialIndex, VECTOR *o_vertices, VECTOR *o_normals
         : "r"(ONE_VEC));
 
     u32 addedFaces = 0;
-#define CURR_FRAME frames[animState.currentFrame]
-#define NEXT_FRAME frames[animState.nextFrame]
+// Frames of LOD level have the same vertices, but simplified faces
+#define CURR_FRAME getLODFrames()[animState.currentFrame]
+#define NEXT_FRAME getLODFrames()[animState.nextFrame]
 
     MeshMaterial *material = &CURR_FRAME.getMaterial(t_materialIndex); // cache
     u32 *vertFaces = material->getVertexFaces();                       // cache
@@ -199,6 +385,29 @@ u32 Mesh::getDrawData(u32 t_materialIndex, VECTOR *o_vertices, VECTOR *o_normals
     Point *sts = CURR_FRAME.getSTs();                                  // cache
     Vector3 *normals = CURR_FRAME.getNormals();                        // cache
 
+    if (material->isDrawDataBaked() && animState.currentFrame == animState.nextFrame)
+    {
+        // Baked data have no gathers and "w" fixups, only backface culling is left
+        VECTOR *bakedVertices = material->getDrawVertices();       // cache
+        VECTOR *bakedNormals = material->getDrawNormals();         // cache
+        VECTOR *bakedCoordinates = material->getDrawCoordinates(); // cache
+        for (u32 faceI = 0; faceI < material->getFacesCount(); faceI += 3)
+        {
+            if (shouldBeBackfaceCulled)
+            {
+                for (u8 i = 0; i < 3; i++)
+                    calc3Vectors[i].set(bakedVertices[faceI + i][0], bakedVertices[faceI + i][1], bakedVertices[faceI + i][2]);
+                if (Vector3::shouldBeBackfaceCulled(&t_cameraPos, &calc3Vectors[2], &calc3Vectors[1], &calc3Vectors[0]))
+                    continue;
+            }
+            memcpy(o_vertices[addedFaces], bakedVertices[faceI], sizeof(VECTOR) * 3);
+            memcpy(o_normals[addedFaces], bakedNormals[faceI], sizeof(VECTOR) * 3);
+            memcpy(o_coordinates[addedFaces], bakedCoordinates[faceI], sizeof(VECTOR) * 3);
+            addedFaces += 3;
+        }
+        return addedFaces;
+    }
+
     for (u32 faceI = 0; faceI < material->getFacesCount(); faceI += 3)
     {
         if (animState.currentFrame != animState.nextFrame)
@@ -336,36 +545,209 @@ u32 Mesh::getDrawData(u32 t_materialIndex, VECTOR *o_vertices, VECTOR *o_normals
     return addedFaces;
 }
 
-u8 Mesh::isInFrustum(Plane *t_frustumPlanes)
+/** Restart flag in vertex "w" bits. It is GS ADC bit, so VU1 strip program uses it directly */
+const u32 MESH_STRIP_RESTART_BIT = 0x8000;
+
+/**
+ * Winding flags in vertex "w" bits. Every second strip triangle has reversed winding.
+ * They are masks of MAC sign flags (x, y), which VU1 backface culling tests.
+ */
+const u32 MESH_STRIP_EVEN_TRIANGLE_BIT = 0x80;
+const u32 MESH_STRIP_ODD_TRIANGLE_BIT = 0x40;
+
+u32 Mesh::getStripDrawData(u32 t_materialIndex, VECTOR *o_vertices, VECTOR *o_normals, VECTOR *o_coordinates)
 {
-    Vector3 boxCalcTemp;
-    u8 boxResult = 1, boxIn = 0, boxOut = 0;
-    const Vector3 *currentBoundingBox = getCurrentBoundingBoxVertices();
-    for (int i = 0; i < 6; i++)
+    MeshMaterial *strips = &getLODFrames()[0].getMaterial(t_materialIndex); // strips are generated only for first frame
+    MeshMaterial *material = &CURR_FRAME.getMaterial(t_materialIndex); // cache
+    u32 *stripFaces = strips->getStripFaces();                         // cache
+    u8 *stripRestarts = strips->getStripRestarts();                    // cache
+    u32 *vertFaces = material->getVertexFaces();                       // cache
+    u32 *normalFaces = material->getNormalFaces();                     // cache
+    u32 *stFaces = material->getSTFaces();                             // cache
+    Vector3 *verts = CURR_FRAME.getVertices();                         // cache
+    Vector3 *nextVerts = NEXT_FRAME.getVertices();                     // cache
+    Point *sts = CURR_FRAME.getSTs();                                  // cache
+    Vector3 *normals = CURR_FRAME.getNormals();                        // cache
+    const u8 isInterpolated = animState.currentFrame != animState.nextFrame;
+    // Strip faces are indexes of faces, so baked data is read with one gather instead of three
+    const u8 isBaked = material->isDrawDataBaked() && !isInterpolated;
+    const u32 count = strips->getStripFacesCount();
+    u32 stripTriangle = 0;
+    for (u32 i = 0; i < count; i++)
     {
-        boxOut = 0;
-        boxIn = 0;
-        // for each corner of the box do ...
-        // get out of the cycle as soon as a box as corners
-        // both inside and out of the frustum
-        for (int y = 0; y < 8 && (boxIn == 0 || boxOut == 0); y++)
+        const u32 face = stripFaces[i];
+        u32 flags = MESH_STRIP_RESTART_BIT;
+        if (stripRestarts[i])
+            stripTriangle = 0;
+        else
+            flags = stripTriangle++ & 1 ? MESH_STRIP_ODD_TRIANGLE_BIT : MESH_STRIP_EVEN_TRIANGLE_BIT;
+        if (isBaked)
         {
-            boxCalcTemp.set(
-                currentBoundingBox[y].x + position.x,
-                currentBoundingBox[y].y + position.y,
-                currentBoundingBox[y].z + position.z);
-            if (t_frustumPlanes[i].distanceTo(boxCalcTemp) < 0)
-                boxOut++;
-            else
-                boxIn++;
+            memcpy(o_vertices[i], material->getDrawVertices()[face], sizeof(VECTOR));
+            memcpy(&o_vertices[i][3], &flags, sizeof(u32));
+            memcpy(o_normals[i], material->getDrawNormals()[face], sizeof(VECTOR));
+            memcpy(o_coordinates[i], material->getDrawCoordinates()[face], sizeof(VECTOR));
+            continue;
         }
-        //if all corners are out
-        if (boxIn == 0)
-            return 0;
-        else if (boxOut)
-            boxResult = 1;
+        const Vector3 &vert = verts[vertFaces[face]];
+        if (isInterpolated)
+        {
+            const Vector3 &nextVert = nextVerts[vertFaces[face]];
+            o_vertices[i][0] = vert.x + (nextVert.x - vert.x) * animState.interpolation;
+            o_vertices[i][1] = vert.y + (nextVert.y - vert.y) * animState.interpolation;
+            o_vertices[i][2] = vert.z + (nextVert.z - vert.z) * animState.interpolation;
+        }
+        else
+        {
+            o_vertices[i][0] = vert.x;
+            o_vertices[i][1] = vert.y;
+            o_vertices[i][2] = vert.z;
+        }
+        memcpy(&o_vertices[i][3], &flags, sizeof(u32));
+        o_normals[i][0] = normals[normalFaces[face]].x;
+        o_normals[i][1] = normals[normalFaces[face]].y;
+        o_normals[i][2] = normals[normalFaces[face]].z;
+        o_normals[i][3] = 1.0F;
+        o_coordinates[i][0] = sts[stFaces[face]].x;
+        o_coordinates[i][1] = sts[stFaces[face]].y;
+        o_coordinates[i][2] = 1.0F;
+        o_coordinates[i][3] = 1.0F;
+    }
+    return count;
+}
+
+u32 Mesh::getFrameDrawData(const u32 &t_frame, u32 t_materialIndex, VECTOR *o_vertices, VECTOR *o_coordinates)
+{
+    MeshMaterial *material = &getLODFrames()[0].getMaterial(t_materialIndex); // faces of all frames are the same
+    u32 *vertFaces = material->getVertexFaces();                      // cache
+    u32 *stFaces = material->getSTFaces();                            // cache
+    Vector3 *verts = frames[t_frame].getVertices();                   // cache
+    Point *sts = frames[0].getSTs();                                  // cache
+    const u32 count = material->getFacesCount();
+    for (u32 i = 0; i < count; i++)
+    {
+        o_vertices[i][0] = verts[vertFaces[i]].x;
+        o_vertices[i][1] = verts[vertFaces[i]].y;
+        o_vertices[i][2] = verts[vertFaces[i]].z;
+        o_vertices[i][3] = 1.0F;
+        if (o_coordinates == NULL)
+            continue;
+        o_coordinates[i][0] = sts[stFaces[i]].x;
+        o_coordinates[i][1] = sts[stFaces[i]].y;
+        o_coordinates[i][2] = 1.0F;
+        o_coordinates[i][3] = 1.0F;
+    }
+    return count;
+}
+
+u32 Mesh::getBakedDrawData(const u32 &t_materialIndex, VECTOR *&o_vertices, VECTOR *&o_normals, VECTOR *&o_coordinates)
+{
+    MeshMaterial *material = &getLODFrames()[0].getMaterial(t_materialIndex);
+    if (!material->isDrawDataBaked() || animState.currentFrame != animState.nextFrame)
+        return 0;
+    o_vertices = material->getDrawVertices();
+    o_normals = material->getDrawNormals();
+    o_coordinates = material->getDrawCoordinates();
+    return material->getFacesCount();
+}
+
+u8 Mesh::isInFrustum(Plane *t_frustumPlanes)
+{
+    Vector3 center, extent;
+    FrustumCuller::getBoxOfVertices(getCurrentBoundingBoxVertices(), position, center, extent, scale);
+    return FrustumCuller::isBoxInFrustum(t_frustumPlanes, center, extent);
+}
+
+void Mesh::setMipmapping(const float &t_distance)
+{
+    mipmapDistance = t_distance;
+    // Switch between non mipmap and mipmap filters of the same kind
+    if (isMipmappingEnabled())
+    {
+        if (lod.min_filter == LOD_MIN_NEAREST)
+            lod.min_filter = LOD_MIN_NEAR_MIPMAP_NEAR;
+        else if (lod.min_filter == LOD_MIN_LINEAR)
+            lod.min_filter = LOD_MIN_LINE_MIPMAP_LINE;
+    }
+    else if (lod.min_filter >= LOD_MIN_LINE_MIPMAP_NEAR)
+        lod.min_filter = LOD_MIN_LINEAR;
+    else if (lod.min_filter >= LOD_MIN_NEAR_MIPMAP_NEAR)
+        lod.min_filter = LOD_MIN_NEAREST;
+}
+
+void Mesh::setStatic(const u8 &t_val)
+{
+    assertMsg(!t_val || framesCount == 1, "Only not animated mesh can be static!");
+    deleteDisplayLists();
+    _isStatic = t_val;
+}
+
+void Mesh::setQuantized(const u8 &t_val)
+{
+    deleteDisplayLists();
+    _isQuantized = t_val;
+}
+
+void Mesh::setDisplayList(const u32 &t_materialIndex, DisplayList *t_displayList)
+{
+    assertMsg(_isStatic, "Display list can be set only for static mesh!");
+    if (displayLists == NULL)
+    {
+        displayListsCount = getMaterialsCount() * lodLevelsCount;
+        displayLists = new DisplayList *[displayListsCount];
+        for (u32 i = 0; i < displayListsCount; i++)
+            displayLists[i] = NULL;
     }
-    return boxResult;
+    const u32 index = lodLevel * getMaterialsCount() + t_materialIndex;
+    if (displayLists[index] != NULL)
+        delete displayLists[index];
+    displayLists[index] = t_displayList;
+}
+
+void Mesh::deleteDisplayLists()
+{
+    if (displayLists == NULL)
+        return;
+    for (u32 i = 0; i < displayListsCount; i++)
+        if (displayLists[i] != NULL)
+            delete displayLists[i];
+    delete[] displayLists;
+    displayLists = NULL;
+    displayListsCount = 0;
+}
+
+void Mesh::setAnimationOnVU1(const u8 &t_val)
+{
+    deleteBakedAnimations();
+    _isAnimatedOnVU1 = t_val;
+}
+
+void Mesh::setBakedAnimation(const u32 &t_materialIndex, BakedAnimation *t_bakedAnimation)
+{
+    assertMsg(_isAnimatedOnVU1, "Baked animation can be set only for mesh animated on VU1!");
+    if (bakedAnimations == NULL)
+    {
+        bakedAnimationsCount = getMaterialsCount() * lodLevelsCount;
+        bakedAnimations = new BakedAnimation *[bakedAnimationsCount];
+        for (u32 i = 0; i < bakedAnimationsCount; i++)
+            bakedAnimations[i] = NULL;
+    }
+    const u32 index = lodLevel * getMaterialsCount() + t_materialIndex;
+    if (bakedAnimations[index] != NULL)
+        delete bakedAnimations[index];
+    bakedAnimations[index] = t_bakedAnimation;
+}
+
+void Mesh::deleteBakedAnimations()
+{
+    if (bakedAnimations == NULL)
+        return;
+    for (u32 i = 0; i < bakedAnimationsCount; i++)
+        if (bakedAnimations[i] != NULL)
+            delete bakedAnimations[i];
+    delete[] bakedAnimations;
+    bakedAnimations = NULL;
+    bakedAnimationsCount = 0;
 }
 
 /** Sets texture level of details settings and CLUT settings */
@@ -375,8 +757,10 @@ void Mesh::setDefaultLODAndClut()
     lod.max_level = 0;
     lod.mag_filter = LOD_MAG_NEAREST;
     lod.min_filter = LOD_MIN_NEAREST;
+    lod.mipmap_select = LOD_MIPMAP_REGISTER;
     lod.l = 0;
     lod.k = 0.0F;
+    mipmapDistance = 0.0F;
 
     clut.storage_mode = CLUT_STORAGE_MODE1;
     clut.start = 0;
@@ -8,9 +8,17 @@
 # Sandro Sobczyński <sandro.sobczynski@gmail.com>
 */
 
-#include <cstdlib>
 #include "../include/models/mesh_frame.hpp"
 #include "../include/utils/debug.hpp"
+#include "../include/utils/handle_table.hpp"
+#include <string.h>
+
+/** Function scoped, so it is constructed before any global mesh frame */
+static HandleTable<MeshFrame *> &getHandles()
+{
+    static HandleTable<MeshFrame *> handles(HANDLE_TYPE_MESH_FRAME);
+    return handles;
+}
 
 // ----
 // Constructors/Destructors
@@ -18,7 +26,7 @@
 
 MeshFrame::MeshFrame()
 {
-    id = rand() % 1000000;
+    id = getHandles().add(this);
     vertexCount = 0;
     stsCount = 0;
     normalsCount = 0;
@@ -27,14 +35,16 @@ MeshFrame::MeshFrame()
     _areVerticesAllocated = false;
     _areNormalsAllocated = false;
     _areMaterialsAllocated = false;
+    _isTopologyShared = false;
     _isMother = true;
 }
 
 MeshFrame::~MeshFrame()
 {
+    getHandles().remove(id);
     if (_isMother)
     {
-        if (_areSTsAllocated)
+        if (_areSTsAllocated && !_isTopologyShared)
             delete[] sts;
         if (_areVerticesAllocated)
             delete[] vertices;
@@ -42,7 +52,7 @@ MeshFrame::~MeshFrame()
             delete[] normals;
         delete boundingBoxObj;
     }
-    if (_areMaterialsAllocated)
+    if (_areMaterialsAllocated && !_isTopologyShared)
         delete[] materials;
 }
 
@@ -82,11 +92,26 @@ void MeshFrame::allocateMaterials(const u32 &t_val)
     _areMaterialsAllocated = true;
 }
 
+void MeshFrame::generateStrips()
+{
+    assertMsg(_areMaterialsAllocated, "Can't generate strips, because materials were not allocated!");
+    for (u32 i = 0; i < materialsCount; i++)
+        materials[i].generateStrips();
+}
+
+void MeshFrame::bakeDrawData()
+{
+    assertMsg(_areMaterialsAllocated, "Can't bake draw data, because materials were not allocated!");
+    for (u32 i = 0; i < materialsCount; i++)
+        materials[i].bakeDrawData(vertices, normals, sts);
+}
+
 void MeshFrame::calculateBoundingBoxes()
 {
     assertMsg(_areVerticesAllocated, "Can't calculate bounding box, because vertices were not allocated!");
-    for (u32 i = 0; i < materialsCount; i++)
-        materials[i].calculateBoundingBox(vertices, vertexCount);
+    if (!_isTopologyShared) // shared materials have boxes of their owner frame
+        for (u32 i = 0; i < materialsCount; i++)
+            materials[i].calculateBoundingBox(vertices, vertexCount);
 
     float lowX, lowY, lowZ, hiX, hiY, hiZ;
     lowX = hiX = vertices[0].x;
@@ -149,3 +174,46 @@ void MeshFrame::copyFrom(MeshFrame *t_refCopy)
 
     _isMother = false;
 }
+
+void MeshFrame::shareTopologyFrom(MeshFrame *t_frame)
+{
+    assertMsg(t_frame != this && !t_frame->_isTopologyShared, "Topology can be shared only from frame which owns it!");
+    if (!_isTopologyShared)
+    {
+        if (_areMaterialsAllocated)
+            delete[] materials;
+        if (_isMother && _areSTsAllocated)
+            delete[] sts;
+    }
+    stsCount = t_frame->stsCount;
+    materialsCount = t_frame->materialsCount;
+    sts = t_frame->sts;
+    materials = t_frame->materials;
+    _areSTsAllocated = t_frame->_areSTsAllocated;
+    _areMaterialsAllocated = t_frame->_areMaterialsAllocated;
+    _isTopologyShared = true;
+}
+
+u8 MeshFrame::hasTheSameTopology(const MeshFrame &t_frame) const
+{
+    if (stsCount != t_frame.stsCount || materialsCount != t_frame.materialsCount)
+        return false;
+    for (u32 i = 0; i < stsCount; i++)
+        if (sts[i].x != t_frame.sts[i].x || sts[i].y != t_frame.sts[i].y)
+            return false;
+    for (u32 i = 0; i < materialsCount; i++)
+    {
+        const MeshMaterial &a = materials[i];
+        const MeshMaterial &b = t_frame.materials[i];
+        if (a.getFacesCount() != b.getFacesCount() ||
+            a.areSTsPresent() != b.areSTsPresent() ||
+            a.areNormalsPresent() != b.areNormalsPresent())
+            return false;
+        const u32 size = sizeof(u32) * a.getFacesCount();
+        if (memcmp(a.getVertexFaces(), b.getVertexFaces(), size) != 0 ||
+            (a.areSTsPresent() && memcmp(a.getSTFaces(), b.getSTFaces(), size) != 0) ||
+            (a.areNormalsPresent() && memcmp(a.getNormalFaces(), b.getNormalFaces(), size) != 0))
+            return false;
+    }
+    return true;
+}
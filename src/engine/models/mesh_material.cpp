@@ -12,7 +12,16 @@
 #include "../include/models/bounding_box.hpp"
 #include "../include/utils/debug.hpp"
 #include "../include/utils/string.hpp"
-#include <cstdlib>
+#include "../include/utils/handle_table.hpp"
+#include "../include/utils/stripifier.hpp"
+#include "../include/modules/frustum_culler.hpp"
+
+/** Function scoped, so it is constructed before any global mesh material */
+static HandleTable<MeshMaterial *> &getHandles()
+{
+    static HandleTable<MeshMaterial *> handles(HANDLE_TYPE_MESH_MATERIAL);
+    return handles;
+}
 
 // ----
 // Constructors/Destructors
@@ -20,10 +29,15 @@
 
 MeshMaterial::MeshMaterial()
 {
-    id = rand() % 1000000;
+    id = getHandles().add(this);
     facesCount = 0;
+    stripFacesCount = 0;
+    drawData = NULL;
+    nameHash = 0;
     _isNameSet = false;
     _areFacesAllocated = false;
+    _areFacesOwned = true;
+    _isDrawDataOwned = false;
     _isBoundingBoxCalculated = false;
     _areSTsPresent = false;
     _areNormalsPresent = false;
@@ -33,17 +47,12 @@ MeshMaterial::MeshMaterial()
 
 MeshMaterial::~MeshMaterial()
 {
-    if (_isMother)
-    {
-        if (_areFacesAllocated)
-        {
-            delete[] vertexFaces;
-            delete[] stFaces;
-            delete[] normalFaces;
-        }
-        if (_isNameSet)
-            delete[] name;
-    }
+    getHandles().remove(id);
+    if (_areFacesOwned)
+        deleteFaces();
+    deleteDrawData();
+    if (_isMother && _isNameSet)
+        delete[] name;
 }
 
 // ----
@@ -60,43 +69,139 @@ void MeshMaterial::allocateFaces(const u32 &t_val)
     _areFacesAllocated = true;
 }
 
-void MeshMaterial::setName(char *t_val)
+void MeshMaterial::setFaces(u32 *t_vertexFaces, u32 *t_stFaces, u32 *t_normalFaces, const u32 &t_count)
 {
-    assertMsg(!_isNameSet, "Can't set name, because was already set!");
-    name = String::createCopy(t_val);
-    _isNameSet = true;
+    if (_areFacesOwned)
+        deleteFaces();
+    deleteDrawData();
+    vertexFaces = t_vertexFaces;
+    stFaces = t_stFaces;
+    normalFaces = t_normalFaces;
+    facesCount = t_count;
+    stripFacesCount = 0;
+    _areFacesAllocated = true;
+    _areFacesOwned = true;
 }
 
-u8 MeshMaterial::isInFrustum(Plane *t_frustumPlanes, const Vector3 &position)
+void MeshMaterial::referenceFacesFrom(const MeshMaterial &t_material)
 {
-    Vector3 boxCalcTemp;
-    u8 boxResult = 1, boxIn = 0, boxOut = 0;
+    if (_areFacesOwned)
+        deleteFaces();
+    deleteDrawData();
+    vertexFaces = t_material.vertexFaces;
+    stFaces = t_material.stFaces;
+    normalFaces = t_material.normalFaces;
+    facesCount = t_material.facesCount;
+    stripFaces = t_material.stripFaces;
+    stripRestarts = t_material.stripRestarts;
+    stripFacesCount = t_material.stripFacesCount;
+    drawData = t_material.drawData;
+    _areFacesAllocated = t_material._areFacesAllocated;
+    _areFacesOwned = false;
+}
 
-    for (u8 i = 0; i < 6; i++)
+void MeshMaterial::deleteFaces()
+{
+    if (_areFacesAllocated)
+    {
+        delete[] vertexFaces;
+        delete[] stFaces;
+        delete[] normalFaces;
+    }
+    if (stripFacesCount > 0)
     {
-        boxOut = 0;
-        boxIn = 0;
-        // for each corner of the box do ...
-        // get out of the cycle as soon as a box as corners
-        // both inside and out of the frustum
-        for (u8 y = 0; y < 8 && (boxIn == 0 || boxOut == 0); y++)
+        delete[] stripFaces;
+        delete[] stripRestarts;
+    }
+    _areFacesAllocated = false;
+    stripFacesCount = 0;
+}
+
+void MeshMaterial::deleteDrawData()
+{
+    if (_isDrawDataOwned)
+        delete[] drawData;
+    drawData = NULL;
+    _isDrawDataOwned = false;
+}
+
+void MeshMaterial::bakeDrawData(Vector3 *t_vertices, Vector3 *t_normals, Point *t_sts)
+{
+    assertMsg(_areFacesAllocated, "Can't bake draw data, because faces were not allocated!");
+    deleteDrawData();
+    drawData = new VECTOR[facesCount * 3];
+    _isDrawDataOwned = true;
+    VECTOR *vertices = getDrawVertices();
+    VECTOR *normals = getDrawNormals();
+    VECTOR *coordinates = getDrawCoordinates();
+    for (u32 i = 0; i < facesCount; i++)
+    {
+        const Vector3 &vertex = t_vertices[vertexFaces[i]];
+        vertices[i][0] = vertex.x;
+        vertices[i][1] = vertex.y;
+        vertices[i][2] = vertex.z;
+        vertices[i][3] = 1.0F;
+        if (_areNormalsPresent)
         {
-            boxCalcTemp.set(
-                boundingBoxObj->getVertex(y).x + position.x,
-                boundingBoxObj->getVertex(y).y + position.y,
-                boundingBoxObj->getVertex(y).z + position.z);
-            if (t_frustumPlanes[i].distanceTo(boxCalcTemp) < 0)
-                boxOut++;
-            else
-                boxIn++;
+            const Vector3 &normal = t_normals[normalFaces[i]];
+            normals[i][0] = normal.x;
+            normals[i][1] = normal.y;
+            normals[i][2] = normal.z;
         }
-        //if all corners are out
-        if (boxIn == 0)
-            return 0;
-        else if (boxOut)
-            boxResult = 1;
+        else
+            normals[i][0] = normals[i][1] = normals[i][2] = 0.0F;
+        normals[i][3] = 1.0F;
+        if (_areSTsPresent)
+        {
+            const Point &st = t_sts[stFaces[i]];
+            coordinates[i][0] = st.x;
+            coordinates[i][1] = st.y;
+        }
+        else
+            coordinates[i][0] = coordinates[i][1] = 0.0F;
+        coordinates[i][2] = 1.0F;
+        coordinates[i][3] = 1.0F;
+    }
+}
+
+void MeshMaterial::generateStrips()
+{
+    assertMsg(_areFacesAllocated, "Can't generate strips, because faces were not allocated!");
+    assertMsg(stripFacesCount == 0, "Can't generate strips, because were already generated!");
+    u32 *faces = new u32[facesCount];
+    u8 *restarts = new u8[facesCount];
+    const u32 count = Stripifier::generate(vertexFaces, stFaces, normalFaces, facesCount, faces, restarts);
+    if (count == 0 || count >= facesCount)
+    {
+        delete[] faces;
+        delete[] restarts;
+        return;
+    }
+    stripFacesCount = count;
+    stripFaces = new u32[count];
+    stripRestarts = new u8[count];
+    for (u32 i = 0; i < count; i++)
+    {
+        stripFaces[i] = faces[i];
+        stripRestarts[i] = restarts[i];
     }
-    return boxResult;
+    delete[] faces;
+    delete[] restarts;
+}
+
+void MeshMaterial::setName(char *t_val)
+{
+    assertMsg(!_isNameSet, "Can't set name, because was already set!");
+    name = String::createCopy(t_val);
+    nameHash = Hash::fnv1a(t_val);
+    _isNameSet = true;
+}
+
+u8 MeshMaterial::isInFrustum(Plane *t_frustumPlanes, const Vector3 &position, const float &t_scale)
+{
+    Vector3 center, extent;
+    FrustumCuller::getBoxOfVertices(boundingBoxObj->getVertices(), position, center, extent, t_scale);
+    return FrustumCuller::isBoxInFrustum(t_frustumPlanes, center, extent);
 }
 
 void MeshMaterial::calculateBoundingBox(Vector3 *t_vertices, u32 t_vertCount)
@@ -144,6 +249,7 @@ void MeshMaterial::copyFrom(MeshMaterial *t_refCopy)
 {
     _isNameSet = true;
     name = t_refCopy->name;
+    nameHash = t_refCopy->nameHash;
 
     _isBoundingBoxCalculated = true;
     boundingBoxObj = t_refCopy->boundingBoxObj;
@@ -152,9 +258,14 @@ void MeshMaterial::copyFrom(MeshMaterial *t_refCopy)
     stFaces = t_refCopy->stFaces;
     normalFaces = t_refCopy->normalFaces;
     facesCount = t_refCopy->facesCount;
+    stripFaces = t_refCopy->stripFaces;
+    stripRestarts = t_refCopy->stripRestarts;
+    stripFacesCount = t_refCopy->stripFacesCount;
+    drawData = t_refCopy->drawData;
     _areSTsPresent = t_refCopy->_areSTsPresent;
     _areNormalsPresent = t_refCopy->_areNormalsPresent;
     _areFacesAllocated = true;
+    _areFacesOwned = false;
 
     _isMother = false;
 }
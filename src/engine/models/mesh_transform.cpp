@@ -0,0 +1,80 @@
+/*
+# ______       ____   ___
+#   |     \/   ____| |___|    
+#   |     |   |   \  |   |       
+#-----------------------------------------------------------------------
+# Copyright 2020, tyra - https://github.com/h4570/tyra
+# Licenced under Apache License 2.0
+# Sandro Sobczyński <sandro.sobczynski@gmail.com>
+*/
+
+#include "../include/models/mesh_transform.hpp"
+#include "../include/utils/math.hpp"
+
+// ----
+// Constructors/Destructors
+// ----
+
+MeshTransform::MeshTransform()
+{
+    scale = 1.0F;
+    isRotationDirty = true;
+    compose(model, position, rotation, scale);
+}
+
+// ----
+// Methods
+// ----
+
+const Matrix &MeshTransform::get(const Vector3 &t_position, const Vector3 &t_rotation, const float &t_scale)
+{
+    if (isRotationDirty || t_rotation.x != rotation.x || t_rotation.y != rotation.y || t_rotation.z != rotation.z || t_scale != scale)
+    {
+        rotation = t_rotation;
+        scale = t_scale;
+        setRotation(model, rotation, scale);
+        isRotationDirty = false;
+    }
+    if (t_position.x != position.x || t_position.y != position.y || t_position.z != position.z)
+    {
+        position = t_position;
+        model.data[12] = position.x;
+        model.data[13] = position.y;
+        model.data[14] = position.z;
+    }
+    return model;
+}
+
+void MeshTransform::compose(Matrix &o_model, const Vector3 &t_position, const Vector3 &t_rotation, const float &t_scale)
+{
+    setRotation(o_model, t_rotation, t_scale);
+    o_model.data[12] = t_position.x;
+    o_model.data[13] = t_position.y;
+    o_model.data[14] = t_position.z;
+}
+
+/** Sets upper 3x3 to Rx * Ry * Rz * scale and last row to 0, 0, 0, 1 (column major) */
+void MeshTransform::setRotation(Matrix &o_model, const Vector3 &t_rotation, const float &t_scale)
+{
+    const float cx = Math::cos(t_rotation.x), sx = Math::sin(t_rotation.x);
+    const float cy = Math::cos(t_rotation.y), sy = Math::sin(t_rotation.y);
+    const float cz = Math::cos(t_rotation.z), sz = Math::sin(t_rotation.z);
+    float *data = o_model.data;
+
+    data[0] = cy * cz * t_scale;
+    data[1] = (cx * sz + sx * sy * cz) * t_scale;
+    data[2] = (sx * sz - cx * sy * cz) * t_scale;
+    data[3] = 0.0F;
+
+    data[4] = -cy * sz * t_scale;
+    data[5] = (cx * cz - sx * sy * sz) * t_scale;
+    data[6] = (sx * cz + cx * sy * sz) * t_scale;
+    data[7] = 0.0F;
+
+    data[8] = sy * t_scale;
+    data[9] = -sx * cy * t_scale;
+    data[10] = cx * cy * t_scale;
+    data[11] = 0.0F;
+
+    data[15] = 1.0F;
+}
@@ -11,7 +11,14 @@
 #include "../include/models/sprite.hpp"
 #include "../include/utils/debug.hpp"
 #include "../include/utils/string.hpp"
-#include <cstdlib>
+#include "../include/utils/handle_table.hpp"
+
+/** Function scoped, so it is constructed before any global sprite */
+static HandleTable<Sprite *> &getHandles()
+{
+    static HandleTable<Sprite *> handles(HANDLE_TYPE_SPRITE);
+    return handles;
+}
 
 // ----
 // Constructors/Destructors
@@ -19,7 +26,7 @@
 
 Sprite::Sprite()
 {
-    id = rand() % 1000000;
+    id = getHandles().add(this);
     _isSizeSet = false;
     _flipH = false;
     _flipV = false;
@@ -29,7 +36,7 @@ Sprite::Sprite()
     setDefaultLODAndClut();
 }
 
-Sprite::~Sprite() {}
+Sprite::~Sprite() { getHandles().remove(id); }
 
 // ----
 // Methods
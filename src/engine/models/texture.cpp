@@ -9,17 +9,30 @@
 */
 
 #include "../include/models/texture.hpp"
+#include "../include/modules/texture_repository.hpp"
 #include "../include/utils/string.hpp"
-#include <cstdlib>
+#include "../include/utils/handle_table.hpp"
+#include "../include/utils/quantizer.hpp"
 #include <draw_sampling.h>
 
+/** Function scoped, so it is constructed before any global texture */
+static HandleTable<Texture *> &getHandles()
+{
+    static HandleTable<Texture *> handles(HANDLE_TYPE_TEXTURE);
+    return handles;
+}
+
 // ----
 // Constructors/Destructors
 // ----
 
 Texture::Texture()
 {
-    id = rand() % 1000000;
+    id = getHandles().add(this);
+    nameHash = 0;
+    repository = NULL;
+    clut = NULL;
+    mipmapsCount = 0;
     _isSizeSet = false;
     _isNameSet = false;
     setDefaultWrapSettings();
@@ -27,19 +40,33 @@ Texture::Texture()
 
 Texture::~Texture()
 {
+    if (repository != NULL)
+        for (u32 i = 0; i < texLinks.size(); i++)
+            repository->unlink(texLinks[i].id, this);
+    getHandles().remove(id);
     if (getTextureLinksCount() > 0)
         texLinks.clear();
     if (_isNameSet)
         delete[] name;
     if (_isSizeSet)
         delete[] data;
+    if (clut != NULL)
+        delete[] clut;
+    for (u8 i = 0; i < mipmapsCount; i++)
+        delete[] mipmaps[i];
 }
 
 // ----
 // Methods
 // ----
 
-void Texture::setSize(const u8 &t_width, const u8 &t_height, const TextureType &t_type)
+Texture *Texture::getById(const u32 &t_id)
+{
+    Texture **result = getHandles().get(t_id);
+    return result != NULL ? *result : NULL;
+}
+
+void Texture::setSize(const u16 &t_width, const u16 &t_height, const TextureType &t_type)
 {
     assertMsg(!_isSizeSet, "Can't set size, because was already set!");
     assertMsg(t_width <= 256 && t_height <= 256, "Given texture can be too big for PS2. Please strict to 256x256 max. Prefer 128x128.");
@@ -47,13 +74,140 @@ void Texture::setSize(const u8 &t_width, const u8 &t_height, const TextureType &
     height = t_height;
     _type = t_type;
     data = new unsigned char[getDataSize()];
+    if (isPaletted())
+        clut = new unsigned char[getClutSize()](); // Unused colors are transparent black
     _isSizeSet = true;
 }
 
+void Texture::setClutColor(const u8 &t_index, const u8 &t_r, const u8 &t_g, const u8 &t_b, const u8 &t_a)
+{
+    assertMsg(t_index < getClutColorsCount(), "Palette color index out of range!");
+    const u32 offset = (_type == TEX_TYPE_PALETTE8 ? getClutIndexCSM1(t_index) : t_index) * 4;
+    clut[offset] = t_r;
+    clut[offset + 1] = t_g;
+    clut[offset + 2] = t_b;
+    clut[offset + 3] = t_a;
+}
+
+void Texture::generateMipmaps(const u8 &t_maxCount)
+{
+    assertMsg(_isSizeSet, "Can't generate mipmaps, because texture size was not set!");
+    assertMsg(mipmapsCount == 0, "Can't generate mipmaps, because were already generated!");
+    while (mipmapsCount < t_maxCount && mipmapsCount < TEXTURE_MAX_MIPMAPS &&
+           getMipmapWidth(mipmapsCount + 1) >= TEXTURE_MIN_MIPMAP_SIZE &&
+           getMipmapHeight(mipmapsCount + 1) >= TEXTURE_MIN_MIPMAP_SIZE)
+    {
+        const u8 level = mipmapsCount + 1;
+        const unsigned char *source = getMipmapData(level - 1);
+        const u16 sourceWidth = getMipmapWidth(level - 1);
+        const u16 levelWidth = getMipmapWidth(level);
+        const u16 levelHeight = getMipmapHeight(level);
+        unsigned char *result = new unsigned char[getMipmapDataSize(level)];
+        for (u16 y = 0; y < levelHeight; y++)
+            for (u16 x = 0; x < levelWidth; x++)
+            {
+                u32 sum[4] = {0, 0, 0, 0};
+                u8 rgba[4];
+                for (u8 i = 0; i < 4; i++)
+                {
+                    getPixel(source, (y * 2 + (i >> 1)) * sourceWidth + x * 2 + (i & 1), rgba);
+                    for (u8 c = 0; c < 4; c++)
+                        sum[c] += rgba[c];
+                }
+                for (u8 c = 0; c < 4; c++)
+                    rgba[c] = (sum[c] + 2) / 4;
+                setPixel(result, y * levelWidth + x, rgba);
+            }
+        mipmaps[mipmapsCount++] = result;
+    }
+}
+
+u32 Texture::getBufferWidth(const u8 &t_level) const
+{
+    const u32 minWidth = isPaletted() ? 128 : 64;
+    const u32 levelWidth = getMipmapWidth(t_level);
+    return levelWidth < minWidth ? minWidth : ((levelWidth + 63) / 64) * 64;
+}
+
+u32 Texture::getVramSize(const u8 &t_level) const
+{
+    u32 pageWidth, pageHeight;
+    switch (_type)
+    {
+    case TEX_TYPE_PALETTE4:
+        pageWidth = 128, pageHeight = 128;
+        break;
+    case TEX_TYPE_PALETTE8:
+        pageWidth = 128, pageHeight = 64;
+        break;
+    default: // PSMCT32 and PSMCT24
+        pageWidth = 64, pageHeight = 32;
+        break;
+    }
+    const u32 pagesX = (getBufferWidth(t_level) + pageWidth - 1) / pageWidth;
+    const u32 pagesY = (getMipmapHeight(t_level) + pageHeight - 1) / pageHeight;
+    return pagesX * pagesY * TEXTURE_GS_PAGE_SIZE;
+}
+
+/** Returns RGBA of pixel. For paletted textures color is taken from CLUT */
+void Texture::getPixel(const unsigned char *t_data, const u32 &t_index, u8 *o_rgba) const
+{
+    const unsigned char *color;
+    switch (_type)
+    {
+    case TEX_TYPE_RGB:
+        o_rgba[0] = t_data[t_index * 3];
+        o_rgba[1] = t_data[t_index * 3 + 1];
+        o_rgba[2] = t_data[t_index * 3 + 2];
+        o_rgba[3] = 128;
+        return;
+    case TEX_TYPE_PALETTE8:
+        color = &clut[getClutIndexCSM1(t_data[t_index]) * 4];
+        break;
+    case TEX_TYPE_PALETTE4:
+        color = &clut[((t_data[t_index / 2] >> ((t_index & 1) * 4)) & 0xF) * 4];
+        break;
+    default:
+        color = &t_data[t_index * 4];
+        break;
+    }
+    for (u8 c = 0; c < 4; c++)
+        o_rgba[c] = color[c];
+}
+
+/** Sets pixel. For paletted textures nearest CLUT color is used */
+void Texture::setPixel(unsigned char *t_data, const u32 &t_index, const u8 *t_rgba)
+{
+    u8 index;
+    switch (_type)
+    {
+    case TEX_TYPE_RGB:
+        for (u8 c = 0; c < 3; c++)
+            t_data[t_index * 3 + c] = t_rgba[c];
+        break;
+    case TEX_TYPE_PALETTE8:
+        // CSM1 swizzle is its own inverse
+        t_data[t_index] = getClutIndexCSM1(Quantizer::findNearest(clut, getClutColorsCount(), t_rgba));
+        break;
+    case TEX_TYPE_PALETTE4:
+        index = Quantizer::findNearest(clut, getClutColorsCount(), t_rgba);
+        if (t_index & 1)
+            t_data[t_index / 2] = (t_data[t_index / 2] & 0x0F) | (index << 4);
+        else
+            t_data[t_index / 2] = (t_data[t_index / 2] & 0xF0) | index;
+        break;
+    default:
+        for (u8 c = 0; c < 4; c++)
+            t_data[t_index * 4 + c] = t_rgba[c];
+        break;
+    }
+}
+
 void Texture::setName(char *t_val)
 {
     assertMsg(!_isNameSet, "Can't set name, because was already set!");
     name = String::createCopy(t_val);
+    nameHash = Hash::fnv1a(t_val);
     _isNameSet = true;
 }
 
@@ -73,9 +227,26 @@ void Texture::setWrapSettings(const WrapSettings t_horizontal, const WrapSetting
     wrapSettings.vertical = t_vertical;
 }
 
+void Texture::setRepository(TextureRepository *t_repository)
+{
+    repository = t_repository;
+    if (repository != NULL)
+        for (u32 i = 0; i < texLinks.size(); i++)
+            repository->link(texLinks[i].id, this);
+}
+
 void Texture::addLink(const u32 &t_id)
 {
     TextureLink link;
     link.id = t_id;
     texLinks.push_back(link);
+    if (repository != NULL)
+        repository->link(t_id, this);
+}
+
+void Texture::removeLinkByIndex(const u32 &t_index)
+{
+    if (repository != NULL)
+        repository->unlink(texLinks[t_index].id, this);
+    texLinks.erase(texLinks.begin() + t_index);
 }
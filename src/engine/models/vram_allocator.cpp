@@ -0,0 +1,127 @@
+/*
+# ______       ____   ___
+#   |     \/   ____| |___|    
+#   |     |   |   \  |   |       
+#-----------------------------------------------------------------------
+# Copyright 2020, tyra - https://github.com/h4570/tyra
+# Licenced under Apache License 2.0
+# Sandro Sobczyński <sandro.sobczynski@gmail.com>
+*/
+
+#include "../include/models/vram_allocator.hpp"
+#include "../include/utils/debug.hpp"
+
+// ----
+// Constructors/Destructors
+// ----
+
+VramAllocator::VramAllocator()
+{
+    start = 0;
+    end = 0;
+    alignment = 1;
+    currentFrame = 0;
+    _isCurrentFrameSlotEvicted = false;
+}
+
+VramAllocator::~VramAllocator() {}
+
+// ----
+// Methods
+// ----
+
+void VramAllocator::init(const u32 &t_start, const u32 &t_end, const u32 &t_alignment)
+{
+    assertMsg(t_alignment > 0, "VRAM alignment can't be zero!");
+    alignment = t_alignment;
+    start = align(t_start);
+    end = t_end > start ? t_end : start;
+    currentFrame = 0;
+    _isCurrentFrameSlotEvicted = false;
+    slots.clear();
+    evictedKeys.clear();
+}
+
+u32 VramAllocator::getFreeWords() const
+{
+    u32 used = 0;
+    for (u32 i = 0; i < slots.size(); i++)
+        used += slots[i].size;
+    return (end - start) - used;
+}
+
+s32 VramAllocator::use(const u32 &t_key)
+{
+    s32 index = getIndexOfSlot(t_key);
+    if (index == -1)
+        return -1;
+    slots[index].lastUsedFrame = currentFrame;
+    return slots[index].address;
+}
+
+s32 VramAllocator::allocate(const u32 &t_key, const u32 &t_size)
+{
+    evictedKeys.clear();
+    _isCurrentFrameSlotEvicted = false;
+    s32 address = use(t_key);
+    if (address != -1)
+        return address;
+    const u32 size = align(t_size);
+    if (size == 0 || size > end - start)
+        return -1;
+    u32 insertIndex;
+    while ((address = findGap(size, insertIndex)) == -1)
+        evictLeastRecentlyUsed();
+    VramSlot slot;
+    slot.key = t_key;
+    slot.address = address;
+    slot.size = size;
+    slot.lastUsedFrame = currentFrame;
+    slots.insert(slots.begin() + insertIndex, slot);
+    return address;
+}
+
+void VramAllocator::release(const u32 &t_key)
+{
+    s32 index = getIndexOfSlot(t_key);
+    if (index != -1)
+        slots.erase(slots.begin() + index);
+}
+
+/**
+ * Returns address of first gap which fits given size, -1 if there is no such gap.
+ * o_insertIndex is set to index, at which new slot should be inserted.
+ */
+s32 VramAllocator::findGap(const u32 &t_size, u32 &o_insertIndex) const
+{
+    u32 gapStart = start;
+    for (u32 i = 0; i < slots.size(); i++)
+    {
+        if (slots[i].address - gapStart >= t_size)
+        {
+            o_insertIndex = i;
+            return gapStart;
+        }
+        gapStart = slots[i].address + slots[i].size;
+    }
+    if (end - gapStart >= t_size)
+    {
+        o_insertIndex = static_cast<u32>(slots.size());
+        return gapStart;
+    }
+    return -1;
+}
+
+/** Removes slot with oldest last use. Lowest address wins on tie. */
+void VramAllocator::evictLeastRecentlyUsed()
+{
+    assertMsg(slots.size() > 0, "Nothing to evict from VRAM!");
+    u32 oldest = 0;
+    for (u32 i = 1; i < slots.size(); i++)
+        if (slots[i].lastUsedFrame < slots[oldest].lastUsedFrame)
+            oldest = i;
+    if (slots[oldest].lastUsedFrame == currentFrame)
+        _isCurrentFrameSlotEvicted = true;
+    evictedKeys.push_back(slots[oldest].key);
+    slots.erase(slots.begin() + oldest);
+}
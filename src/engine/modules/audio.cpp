@@ -12,7 +12,6 @@
 #include "../include/utils/string.hpp"
 #include "../include/utils/debug.hpp"
 #include <loadfile.h>
-#include <cstdlib>
 
 // ----
 // Constructors/Destructors
@@ -20,7 +19,7 @@
 
 Audio *audioRef;
 
-Audio::Audio()
+Audio::Audio() : songListeners(HANDLE_TYPE_AUDIO_LISTENER)
 {
     // We must set it to 0 on songStop();
     realVolume = 100;
@@ -84,25 +83,13 @@ void Audio::setSongVolume(const u8 &t_vol)
 
 u32 Audio::addSongListener(AudioListener *t_listener)
 {
-    AudioListenerRef *ref = new AudioListenerRef;
-    ref->id = rand() % 1000000;
-    ref->listener = t_listener;
-    songListeners.push_back(ref);
-    return ref->id;
+    return songListeners.add(t_listener);
 }
 
 void Audio::removeSongListener(const u32 &t_id)
 {
-    s32 index = -1;
-    for (u32 i = 0; i < songListeners.size(); i++)
-        if (songListeners[i]->id == t_id)
-        {
-            index = i;
-            break;
-        }
-    assertMsg(index != -1, "Cant remove listener because given id was not found!");
-    delete songListeners[index];
-    songListeners.erase(songListeners.begin() + index);
+    u8 removed = songListeners.remove(t_id);
+    assertMsg(removed, "Cant remove listener because given id was not found!");
 }
 
 // ADPCM
@@ -195,7 +182,7 @@ void Audio::threadLoop()
         {
             printf("Running again.\n");
             for (u32 i = 0; i < getSongListenersCount(); i++)
-                songListeners[i]->listener->onAudioFinish();
+                songListeners.getAll()[i]->onAudioFinish();
             rewindSongToStart();
         }
         else
@@ -211,7 +198,7 @@ void Audio::threadLoop()
         WaitSema(fillbufferSema); // wait until previous chunk wasn't finished
         audsrv_play_audio(wavChunk, chunkReadStatus);
         for (u32 i = 0; i < getSongListenersCount(); i++)
-            songListeners[i]->listener->onAudioTick();
+            songListeners.getAll()[i]->onAudioTick();
     }
 
     chunkReadStatus = fread(wavChunk, 1, sizeof(wavChunk), wav);
@@ -0,0 +1,35 @@
+/*
+# ______       ____   ___
+#   |     \/   ____| |___|    
+#   |     |   |   \  |   |       
+#-----------------------------------------------------------------------
+# Copyright 2020, tyra - https://github.com/h4570/tyra
+# Licenced under Apache License 2.0
+# Sandro Sobczyński <sandro.sobczynski@gmail.com>
+*/
+
+#include "../include/modules/baked_animation.hpp"
+
+// ----
+// Constructors/Destructors
+// ----
+
+BakedAnimation::BakedAnimation(const u32 &t_vertCount, const u32 &t_framesCount, const u8 &t_rgbaOnly)
+{
+    vertCount = t_vertCount;
+    framesCount = t_framesCount;
+    _isRGBAOnly = t_rgbaOnly;
+    frames = new VECTOR *[framesCount];
+    for (u32 i = 0; i < framesCount; i++)
+        frames[i] = new VECTOR[vertCount];
+    coordinates = t_rgbaOnly ? NULL : new VECTOR[vertCount];
+}
+
+BakedAnimation::~BakedAnimation()
+{
+    for (u32 i = 0; i < framesCount; i++)
+        delete[] frames[i];
+    delete[] frames;
+    if (coordinates != NULL)
+        delete[] coordinates;
+}
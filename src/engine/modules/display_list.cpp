@@ -0,0 +1,69 @@
+/*
+# ______       ____   ___
+#   |     \/   ____| |___|    
+#   |     |   |   \  |   |       
+#-----------------------------------------------------------------------
+# Copyright 2020, tyra - https://github.com/h4570/tyra
+# Licenced under Apache License 2.0
+# Sandro Sobczyński <sandro.sobczynski@gmail.com>
+*/
+
+#include "../include/modules/display_list.hpp"
+#include "../include/utils/debug.hpp"
+#include <cstring>
+
+/** CALLed chain of package: 2 data refs and RET */
+const u32 DISPLAY_LIST_PACKAGE_CHAIN_SIZE = 3;
+
+// ----
+// Constructors/Destructors
+// ----
+
+DisplayList::DisplayList(const u32 &t_vertCount, const u32 &t_packagesCount, const Vu1Program &t_program, const u32 &t_quantizedSize)
+{
+    assertMsg(t_packagesCount * DISPLAY_LIST_PACKAGE_CHAIN_SIZE < 0xFFFF, "Mesh material is too big for display list!");
+    vertCount = t_vertCount;
+    program = t_program;
+    vertices = NULL;
+    coordinates = NULL;
+    quantizedData = NULL;
+    dequantization.identity();
+    stDequantization[0] = stDequantization[1] = 1.0F;
+    stDequantization[2] = stDequantization[3] = 0.0F;
+    if (isQuantized())
+    {
+        quantizedData = new qword_t[t_quantizedSize];
+        // Padding after data of unpack is read by VIF as commands, so it have to be NOPs
+        memset(quantizedData, 0, t_quantizedSize * sizeof(qword_t));
+    }
+    else
+    {
+        vertices = new VECTOR[vertCount];
+        coordinates = isRGBAOnly() ? NULL : new VECTOR[vertCount];
+    }
+    chain = packet2_create(t_packagesCount * DISPLAY_LIST_PACKAGE_CHAIN_SIZE, P2_TYPE_NORMAL, P2_MODE_CHAIN, true);
+    packages.reserve(t_packagesCount);
+}
+
+DisplayList::~DisplayList()
+{
+    if (vertices != NULL)
+        delete[] vertices;
+    if (coordinates != NULL)
+        delete[] coordinates;
+    if (quantizedData != NULL)
+        delete[] quantizedData;
+    packet2_free(chain);
+}
+
+// ----
+// Methods
+// ----
+
+void DisplayList::addPackage(qword_t *t_chain, const u32 &t_vertCount)
+{
+    DisplayListPackage package;
+    package.chain = t_chain;
+    package.vertCount = t_vertCount;
+    packages.push_back(package);
+}
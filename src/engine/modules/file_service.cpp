@@ -11,7 +11,6 @@
 #include "../include/modules/file_service.hpp"
 #include "../include/utils/string.hpp"
 #include "../include/utils/debug.hpp"
-#include <cstdlib>
 
 // ----
 // Constructors/Destructors
@@ -19,7 +18,7 @@
 
 FileService *fsRef;
 
-FileService::FileService() {}
+FileService::FileService() : tasks(HANDLE_TYPE_FILE_TASK) {}
 
 FileService::~FileService() {}
 
@@ -30,41 +29,32 @@ FileService::~FileService() {}
 u32 FileService::addReadChunk(FILE *t_file, void *t_destination, const u32 &t_size, const u32 &t_n)
 {
     FileServiceTask task;
-    task.id = rand() % 1000000;
     task.file = t_file;
     task.destination = t_destination;
     task.size = t_size;
     task.n = t_n;
     task.readStatus = -2137;
-    tasks.push_back(task);
-    return task.id;
+    u32 id = tasks.add(task);
+    tasks.get(id)->id = id;
+    return id;
 }
 
 s32 FileService::isTaskDone(const u32 &t_taskId)
 {
-    s32 taskIndex = getIndexOf(t_taskId);
-    assertMsg(taskIndex != -1, "Task was not found!");
-    s32 result = tasks[taskIndex].readStatus;
+    FileServiceTask *task = tasks.get(t_taskId);
+    assertMsg(task != NULL, "Task was not found!");
+    s32 result = task->readStatus;
     if (result != -2137)
-        removeByIndex(taskIndex);
+        tasks.remove(t_taskId);
     return result;
 }
 
 const void FileService::removeById(const u32 &t_taskId)
 {
-    s32 index = getIndexOf(t_taskId);
-    assertMsg(index != -1, "Cant remove task, because it was not found!");
-    removeByIndex(index);
+    u8 removed = tasks.remove(t_taskId);
+    assertMsg(removed, "Cant remove task, because it was not found!");
 }
 
-const s32 FileService::getIndexOf(const u32 &t_taskId)
-{
-    for (u32 i = 0; i < tasks.size(); i++)
-        if (tasks[i].id == t_taskId)
-            return i;
-    return -1;
-};
-
 // Other
 
 void FileService::startThread()
@@ -87,13 +77,14 @@ void FileService::startThread()
 void FileService::threadLoop()
 {
     // This will cause an error
-    // printf("\n\n\n\n\nsize:%d\n", tasks.size());
-    // for (size_t i = 0; i < tasks.size(); i++)
+    // printf("\n\n\n\n\nsize:%d\n", tasks.getCount());
+    // std::vector<FileServiceTask> &all = tasks.getAll();
+    // for (size_t i = 0; i < all.size(); i++)
     // {
-    //     switch (tasks[i].type)
+    //     switch (all[i].type)
     //     {
     //     case ReadChunk:
-    //         tasks[i].readStatus = fread(tasks[i].destination, tasks[i].n, tasks[i].size, tasks[i].file);
+    //         all[i].readStatus = fread(all[i].destination, all[i].n, all[i].size, all[i].file);
     //         break;
 
     //     default:
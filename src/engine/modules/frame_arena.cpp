@@ -0,0 +1,112 @@
+/*
+# ______       ____   ___
+#   |     \/   ____| |___|    
+#   |     |   |   \  |   |       
+#-----------------------------------------------------------------------
+# Copyright 2020, tyra - https://github.com/h4570/tyra
+# Licenced under Apache License 2.0
+# Sandro Sobczyński <sandro.sobczynski@gmail.com>
+*/
+
+#include "../include/modules/frame_arena.hpp"
+#include "../include/utils/debug.hpp"
+#include "../include/utils/math.hpp"
+#include <stdio.h>
+
+// ----
+// Constructors/Destructors
+// ----
+
+FrameArena::FrameArena(const u32 &t_size)
+{
+    size = (t_size + sizeof(qword_t) - 1) / sizeof(qword_t);
+    buffers[0] = new qword_t[size];
+    buffers[1] = new qword_t[size];
+    offset = 0;
+    context = 0;
+    stats.highWaterMark = 0;
+    resetStats();
+    lastFrameStats = stats;
+}
+
+FrameArena::~FrameArena()
+{
+    for (u8 i = 0; i < 2; i++)
+    {
+        delete[] buffers[i];
+        for (u32 j = 0; j < overflows[i].size(); j++)
+            delete[] overflows[i][j];
+        for (u32 j = 0; j < packets[i].size(); j++)
+            packet2_free(packets[i][j].packet);
+    }
+}
+
+// ----
+// Methods
+// ----
+
+void *FrameArena::allocate(const u32 &t_bytes)
+{
+    const u32 qwords = (t_bytes + sizeof(qword_t) - 1) / sizeof(qword_t);
+    stats.used += qwords * sizeof(qword_t);
+    stats.highWaterMark = Math::max(stats.highWaterMark, stats.used);
+    if (offset + qwords <= size)
+    {
+        qword_t *result = buffers[context] + offset;
+        offset += qwords;
+        return result;
+    }
+    qword_t *result = new qword_t[qwords];
+    overflows[context].push_back(result);
+    stats.overflows++;
+    return result;
+}
+
+packet2_t *FrameArena::getPacket(const u16 &t_qwords, const enum Packet2Type &t_type, const enum Packet2Mode &t_mode, const u8 &t_tte)
+{
+    std::vector<Packet> &pool = packets[context];
+    for (u32 i = 0; i < pool.size(); i++)
+    {
+        Packet &item = pool[i];
+        if (item.isUsed || item.qwords < t_qwords || item.type != t_type || item.mode != t_mode || item.tte != t_tte)
+            continue;
+        item.isUsed = true;
+        packet2_reset(item.packet, false);
+        return item.packet;
+    }
+    Packet item;
+    item.packet = packet2_create(t_qwords, t_type, t_mode, t_tte);
+    item.qwords = t_qwords;
+    item.type = t_type;
+    item.mode = t_mode;
+    item.tte = t_tte;
+    item.isUsed = true;
+    pool.push_back(item);
+    stats.packetsCreated++;
+    return item.packet;
+}
+
+void FrameArena::endFrame()
+{
+#ifndef NDEBUG
+    if (stats.highWaterMark > lastFrameStats.highWaterMark)
+        printf("LOG: Frame arena high water mark: %u of %u bytes, overflows: %u\n", stats.highWaterMark, getSize(), stats.overflows);
+#endif
+    lastFrameStats = stats;
+    resetStats();
+    context ^= 1;
+    offset = 0;
+    // Buffer of frame before previous one is not read by DMA anymore
+    for (u32 i = 0; i < overflows[context].size(); i++)
+        delete[] overflows[context][i];
+    overflows[context].clear();
+    for (u32 i = 0; i < packets[context].size(); i++)
+        packets[context][i].isUsed = false;
+}
+
+void FrameArena::resetStats()
+{
+    stats.used = 0;
+    stats.overflows = 0;
+    stats.packetsCreated = 0;
+}
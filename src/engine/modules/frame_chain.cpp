@@ -0,0 +1,133 @@
+/*
+# ______       ____   ___
+#   |     \/   ____| |___|    
+#   |     |   |   \  |   |       
+#-----------------------------------------------------------------------
+# Copyright 2020, tyra - https://github.com/h4570/tyra
+# Licenced under Apache License 2.0
+# Sandro Sobczyński <sandro.sobczynski@gmail.com>
+*/
+
+#include "../include/modules/frame_chain.hpp"
+
+#include <dma.h>
+#include <draw.h>
+#include <gs_privileged.h>
+#include <packet2_utils.h>
+#include "../include/utils/debug.hpp"
+
+/** END tag with VIF codes */
+const u32 FRAME_CHAIN_END_SIZE = 1;
+/** VIF DIRECT immediate is 16 bit */
+const u32 FRAME_CHAIN_MAX_DIRECT_SIZE = 65535;
+
+// ----
+// Constructors/Destructors
+// ----
+
+FrameChain::FrameChain(const u32 &t_chainSize, const u32 &t_gifSize, const u32 &t_dataSize)
+    : chainSize(t_chainSize), gifSize(t_gifSize), dataSize(t_dataSize)
+{
+    consoleLog("Initializing frame chain");
+    for (u8 i = 0; i < 2; i++)
+    {
+        chains[i] = packet2_create(t_chainSize, P2_TYPE_NORMAL, P2_MODE_CHAIN, true);
+        gifPackets[i] = packet2_create(t_gifSize, P2_TYPE_NORMAL, P2_MODE_NORMAL, false);
+        dataPackets[i] = packet2_create(t_dataSize, P2_TYPE_NORMAL, P2_MODE_NORMAL, false);
+    }
+    context = 0;
+    _isFrameInProgress = false;
+    gifStart = gifPackets[0]->next;
+    stats.chainSize = 0;
+    stats.gifSize = 0;
+    stats.dataSize = 0;
+    consoleLog("Frame chain initialized!");
+}
+
+FrameChain::~FrameChain()
+{
+    waitForPreviousFrame();
+    for (u8 i = 0; i < 2; i++)
+    {
+        packet2_free(chains[i]);
+        packet2_free(gifPackets[i]);
+        packet2_free(dataPackets[i]);
+    }
+}
+
+// ----
+// Methods
+// ----
+
+void FrameChain::reserve(const u32 &t_qwords)
+{
+    assertMsg(packet2_get_qw_count(chains[context]) + t_qwords + FRAME_CHAIN_END_SIZE <= chainSize, "Frame chain is full!");
+}
+
+qword_t *FrameChain::allocate(const u32 &t_qwords)
+{
+    packet2_t *data = dataPackets[context];
+    assertMsg(packet2_get_qw_count(data) + t_qwords <= dataSize, "Frame chain data buffer is full!");
+    qword_t *result = data->next;
+    packet2_update(data, data->next + t_qwords);
+    return result;
+}
+
+packet2_t *FrameChain::openGif()
+{
+    gifStart = gifPackets[context]->next;
+    return gifPackets[context];
+}
+
+void FrameChain::closeGif()
+{
+    packet2_t *gif = gifPackets[context];
+    assertMsg(packet2_get_qw_count(gif) <= gifSize, "Frame chain GIF buffer is full!");
+    const u32 qwords = gif->next - gifStart;
+    if (qwords == 0)
+        return;
+    assertMsg(qwords <= FRAME_CHAIN_MAX_DIRECT_SIZE, "Too much GIF data for one DIRECT!");
+    reserve(1);
+    packet2_t *chain = chains[context];
+    packet2_chain_ref(chain, gifStart, qwords, 0, 0, 0);
+    packet2_vif_flush(chain, 0);
+    packet2_vif_direct(chain, qwords, 0);
+    gifStart = gif->next;
+}
+
+void FrameChain::addGifData(const void *t_data, const u32 &t_qwords)
+{
+    assertMsg(t_qwords <= FRAME_CHAIN_MAX_DIRECT_SIZE, "Too much GIF data for one DIRECT!");
+    reserve(1);
+    packet2_t *chain = chains[context];
+    packet2_chain_ref(chain, t_data, t_qwords, 0, 0, 0);
+    packet2_vif_nop(chain, 0);
+    packet2_vif_direct(chain, t_qwords, 0);
+}
+
+void FrameChain::waitForPreviousFrame()
+{
+    if (!_isFrameInProgress)
+        return;
+    dma_channel_wait(DMA_CHANNEL_VIF1, 0);
+    draw_wait_finish();
+    _isFrameInProgress = false;
+}
+
+void FrameChain::kick()
+{
+    assertMsg(!_isFrameInProgress, "Previous frame have to be finished before kick!");
+    packet2_t *chain = chains[context];
+    stats.chainSize = packet2_get_qw_count(chain);
+    stats.gifSize = packet2_get_qw_count(gifPackets[context]);
+    stats.dataSize = packet2_get_qw_count(dataPackets[context]);
+    packet2_utils_vu_add_end_tag(chain);
+    *GS_REG_CSR |= 2; // Reset FINISH, so only FINISH at the end of this frame is waited for
+    dma_channel_send_packet2(chain, DMA_CHANNEL_VIF1, true);
+    _isFrameInProgress = true;
+    context = !context;
+    packet2_reset(chains[context], false);
+    packet2_reset(gifPackets[context], false);
+    packet2_reset(dataPackets[context], false);
+    gifStart = gifPackets[context]->next;
+}
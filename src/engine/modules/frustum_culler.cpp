@@ -0,0 +1,198 @@
+/*
+# ______       ____   ___
+#   |     \/   ____| |___|    
+#   |     |   |   \  |   |       
+#-----------------------------------------------------------------------
+# Copyright 2020, tyra - https://github.com/h4570/tyra
+# Licenced under Apache License 2.0
+# Sandro Sobczyński <sandro.sobczynski@gmail.com>
+*/
+
+#include "../include/modules/frustum_culler.hpp"
+#include "../include/utils/math.hpp"
+
+#ifdef _EE
+/**
+ * ACC = center . normal + 1 * distance + extent . abs(normal)
+ * Planes are in vf16 (normal, distance) and vf17 (abs normal), boxes in vf10-vf15, ones in vf20
+ */
+#define FRUSTUM_CULLER_VU0_PLANE(t_offset, t_absOffset, t_output) \
+    "lqc2         $vf16, " #t_offset "(%1)  \n\t"                 \
+    "lqc2         $vf17, " #t_absOffset "(%1)  \n\t"              \
+    "vmulax.xyzw  $ACC, $vf10, $vf16 \n\t"                        \
+    "vmadday.xyzw $ACC, $vf11, $vf16 \n\t"                        \
+    "vmaddaz.xyzw $ACC, $vf12, $vf16 \n\t"                        \
+    "vmaddaw.xyzw $ACC, $vf20, $vf16 \n\t"                        \
+    "vmaddax.xyzw $ACC, $vf13, $vf17 \n\t"                        \
+    "vmadday.xyzw $ACC, $vf14, $vf17 \n\t"                        \
+    "vmaddz.xyzw  " t_output ", $vf15, $vf17 \n\t"
+#endif
+
+// ----
+// Constructors/Destructors
+// ----
+
+FrustumCuller::FrustumCuller() { count = 0; }
+
+FrustumCuller::~FrustumCuller() {}
+
+// ----
+// Methods
+// ----
+
+u32 FrustumCuller::add(const Vector3 &t_center, const Vector3 &t_extent)
+{
+    if ((count & 3) == 0)
+    {
+        FrustumCullerBoxes empty;
+        for (u8 i = 0; i < 4; i++)
+        {
+            empty.centerX[i] = empty.centerY[i] = empty.centerZ[i] = 0.0F;
+            empty.extentX[i] = empty.extentY[i] = empty.extentZ[i] = 0.0F;
+        }
+        boxes.push_back(empty);
+    }
+    if ((count & 31) == 0)
+        mask.push_back(0);
+    set(count, t_center, t_extent);
+    return count++;
+}
+
+u32 FrustumCuller::add(const Vector3 *t_vertices, const Vector3 &t_position, const float &t_scale)
+{
+    Vector3 center, extent;
+    getBoxOfVertices(t_vertices, t_position, center, extent, t_scale);
+    return add(center, extent);
+}
+
+void FrustumCuller::set(const u32 &t_index, const Vector3 &t_center, const Vector3 &t_extent)
+{
+    FrustumCullerBoxes &group = boxes[t_index >> 2];
+    const u8 lane = t_index & 3;
+    group.centerX[lane] = t_center.x;
+    group.centerY[lane] = t_center.y;
+    group.centerZ[lane] = t_center.z;
+    group.extentX[lane] = t_extent.x;
+    group.extentY[lane] = t_extent.y;
+    group.extentZ[lane] = t_extent.z;
+}
+
+void FrustumCuller::clear()
+{
+    boxes.clear();
+    mask.clear();
+    count = 0;
+}
+
+u32 FrustumCuller::cull(Plane *t_frustumPlanes)
+{
+    float planes[6 * 8] __attribute__((aligned(16)));
+    for (u8 i = 0; i < 6; i++)
+    {
+        const Vector3 &normal = t_frustumPlanes[i].normal;
+        float *plane = &planes[i * 8];
+        plane[0] = normal.x;
+        plane[1] = normal.y;
+        plane[2] = normal.z;
+        plane[3] = t_frustumPlanes[i].distance;
+        plane[4] = normal.x < 0.0F ? -normal.x : normal.x;
+        plane[5] = normal.y < 0.0F ? -normal.y : normal.y;
+        plane[6] = normal.z < 0.0F ? -normal.z : normal.z;
+        plane[7] = 0.0F;
+    }
+    float results[4] __attribute__((aligned(16)));
+    u32 visibleCount = 0;
+    for (u32 i = 0; i < mask.size(); i++)
+        mask[i] = 0;
+    for (u32 i = 0; i < boxes.size(); i++)
+    {
+        cullGroup(boxes[i], planes, results);
+        u32 bits = 0;
+        for (u8 j = 0; j < 4; j++)
+            if (results[j] >= 0.0F)
+                bits |= 1 << j;
+        mask[i >> 3] |= bits << ((i & 7) * 4);
+    }
+    // Unused lanes of last group
+    if (count & 31)
+        mask[count >> 5] &= (1 << (count & 31)) - 1;
+    for (u32 i = 0; i < mask.size(); i++)
+        for (u32 bits = mask[i]; bits != 0; bits &= bits - 1)
+            visibleCount++;
+    return visibleCount;
+}
+
+void FrustumCuller::cullGroup(const FrustumCullerBoxes &t_boxes, const float *t_planes, float *o_results)
+{
+#ifdef _EE
+    asm volatile( // VU0 Macro program
+        "lqc2         $vf10, 0x00(%0)  \n\t"
+        "lqc2         $vf11, 0x10(%0)  \n\t"
+        "lqc2         $vf12, 0x20(%0)  \n\t"
+        "lqc2         $vf13, 0x30(%0)  \n\t"
+        "lqc2         $vf14, 0x40(%0)  \n\t"
+        "lqc2         $vf15, 0x50(%0)  \n\t"
+        "vsub.xyzw    $vf20, $vf0, $vf0 \n\t"
+        "vaddw.xyzw   $vf20, $vf20, $vf0 \n\t"
+        FRUSTUM_CULLER_VU0_PLANE(0x00, 0x10, "$vf19")
+        FRUSTUM_CULLER_VU0_PLANE(0x20, 0x30, "$vf18")
+        "vmini.xyzw   $vf19, $vf19, $vf18 \n\t"
+        FRUSTUM_CULLER_VU0_PLANE(0x40, 0x50, "$vf18")
+        "vmini.xyzw   $vf19, $vf19, $vf18 \n\t"
+        FRUSTUM_CULLER_VU0_PLANE(0x60, 0x70, "$vf18")
+        "vmini.xyzw   $vf19, $vf19, $vf18 \n\t"
+        FRUSTUM_CULLER_VU0_PLANE(0x80, 0x90, "$vf18")
+        "vmini.xyzw   $vf19, $vf19, $vf18 \n\t"
+        FRUSTUM_CULLER_VU0_PLANE(0xA0, 0xB0, "$vf18")
+        "vmini.xyzw   $vf19, $vf19, $vf18 \n\t"
+        "sqc2         $vf19, 0x00(%2)  \n\t"
+        :
+        : "r"(&t_boxes), "r"(t_planes), "r"(o_results)
+        : "memory");
+#else
+    for (u8 i = 0; i < 4; i++)
+    {
+        float result = 0.0F;
+        for (u8 j = 0; j < 6; j++)
+        {
+            const float *plane = &t_planes[j * 8];
+            const float distance = t_boxes.centerX[i] * plane[0] + t_boxes.centerY[i] * plane[1] + t_boxes.centerZ[i] * plane[2] + plane[3];
+            const float radius = t_boxes.extentX[i] * plane[4] + t_boxes.extentY[i] * plane[5] + t_boxes.extentZ[i] * plane[6];
+            if (j == 0 || distance + radius < result)
+                result = distance + radius;
+        }
+        o_results[i] = result;
+    }
+#endif
+}
+
+u8 FrustumCuller::isBoxInFrustum(Plane *t_frustumPlanes, const Vector3 &t_center, const Vector3 &t_extent)
+{
+    for (u8 i = 0; i < 6; i++)
+    {
+        const Vector3 &normal = t_frustumPlanes[i].normal;
+        const float distance = t_frustumPlanes[i].distance + normal.x * t_center.x + normal.y * t_center.y + normal.z * t_center.z;
+        const float radius = (normal.x < 0.0F ? -normal.x : normal.x) * t_extent.x +
+                             (normal.y < 0.0F ? -normal.y : normal.y) * t_extent.y +
+                             (normal.z < 0.0F ? -normal.z : normal.z) * t_extent.z;
+        if (distance + radius < 0.0F)
+            return false;
+    }
+    return true;
+}
+
+void FrustumCuller::getBoxOfVertices(const Vector3 *t_vertices, const Vector3 &t_position, Vector3 &o_center, Vector3 &o_extent, const float &t_scale)
+{
+    Vector3 min = t_vertices[0], max = t_vertices[0];
+    for (u8 i = 1; i < 8; i++)
+    {
+        min.set(Math::min(min.x, t_vertices[i].x), Math::min(min.y, t_vertices[i].y), Math::min(min.z, t_vertices[i].z));
+        max.set(Math::max(max.x, t_vertices[i].x), Math::max(max.y, t_vertices[i].y), Math::max(max.z, t_vertices[i].z));
+    }
+    const float half = t_scale * 0.5F;
+    o_center.set(
+        (min.x + max.x) * half + t_position.x,
+        (min.y + max.y) * half + t_position.y,
+        (min.z + max.z) * half + t_position.z);
+    o_extent.set((max.x - min.x) * half, (max.y - min.y) * half, (max.z - min.z) * half);
+}
@@ -28,10 +28,11 @@
 /** Initializes vars and creates data transfer packets
  * @param packetSize Size of data packet, should be increased when more data will be rendered
  */
-GifSender::GifSender(u32 t_packetSize, ScreenSettings *t_screen, Light *t_light) : screen(t_screen)
+GifSender::GifSender(u32 t_packetSize, ScreenSettings *t_screen, Light *t_light, FrameArena *t_frameArena) : screen(t_screen)
 {
     consoleLog("Initializing GifSender");
     light = t_light;
+    frameArena = t_frameArena;
     packetSize = t_packetSize;
     packets[0] = packet2_create(t_packetSize, P2_TYPE_NORMAL, P2_MODE_CHAIN, false);
     packets[1] = packet2_create(t_packetSize, P2_TYPE_NORMAL, P2_MODE_CHAIN, false);
@@ -52,33 +53,9 @@ GifSender::~GifSender()
 #include <gif_tags.h>
 #include <gs_gp.h>
 
-/** Send texture via GIF */
-void GifSender::sendTexture(Texture &texture, texbuffer_t *t_texBuffer)
-{
-    packet2_t *packet2 = packet2_create(15, P2_TYPE_NORMAL, P2_MODE_CHAIN, false);
-    packet2_update(
-        packet2,
-        draw_texture_transfer(
-            packet2->base,
-            texture.getData(),
-            texture.getWidth(),
-            texture.getHeight(),
-            texture.getType(),
-            t_texBuffer->address,
-            t_texBuffer->width));
-    packet2_chain_open_cnt(packet2, 0, 0, 0);
-    packet2_update(packet2, draw_texture_wrapping(packet2->next, 0, texture.getWrapSettings()));
-    packet2_chain_close_tag(packet2);
-    packet2_update(packet2, draw_texture_flush(packet2->next));
-    dma_channel_wait(DMA_CHANNEL_GIF, 0);
-    dma_channel_send_packet2(packet2, DMA_CHANNEL_GIF, true);
-    dma_channel_wait(DMA_CHANNEL_GIF, 0);
-    packet2_free(packet2);
-}
-
 void GifSender::sendClear(zbuffer_t *t_zBuffer, color_t *t_rgb)
 {
-    packet2_t *packet2 = packet2_create(36, P2_TYPE_NORMAL, P2_MODE_CHAIN, false);
+    packet2_t *packet2 = frameArena->getPacket(36, P2_TYPE_NORMAL, P2_MODE_CHAIN, false);
     packet2_chain_open_end(packet2, 0, 0);
     packet2_update(packet2, draw_disable_tests(packet2->next, 0, t_zBuffer));
     packet2_update(packet2, draw_clear(packet2->next, 0,
@@ -91,7 +68,6 @@ void GifSender::sendClear(zbuffer_t *t_zBuffer, color_t *t_rgb)
     dma_channel_wait(DMA_CHANNEL_GIF, 0);
     dma_channel_send_packet2(packet2, DMA_CHANNEL_GIF, true);
     dma_channel_wait(DMA_CHANNEL_GIF, 0);
-    packet2_free(packet2);
 }
 
 /** Used in game loop.
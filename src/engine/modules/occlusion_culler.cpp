@@ -0,0 +1,204 @@
+/*
+# ______       ____   ___
+#   |     \/   ____| |___|    
+#   |     |   |   \  |   |       
+#-----------------------------------------------------------------------
+# Copyright 2020, tyra - https://github.com/h4570/tyra
+# Licenced under Apache License 2.0
+# Sandro Sobczyński <sandro.sobczynski@gmail.com>
+*/
+
+#include "../include/modules/occlusion_culler.hpp"
+#include <math.h>
+#include "../include/utils/math.hpp"
+
+/** Occluder have to be a bit nearer than box, so occluder does not hide itself */
+const float OCCLUSION_CULLER_DEPTH_BIAS = 1.001F;
+
+// ----
+// Constructors/Destructors
+// ----
+
+OcclusionCuller::OcclusionCuller(const ScreenSettings &t_screen, const u8 &t_divider)
+{
+    width = static_cast<u16>(t_screen.width / t_divider);
+    height = static_cast<u16>(t_screen.height / t_divider);
+    // Screen position = ndc * projectionScale / 2 + screen size / 2 (see VU1 programs)
+    scaleX = t_screen.projectionScale / 2.0F / t_divider;
+    scaleY = t_screen.projectionScale / 2.0F / t_divider;
+    nearPlaneDist = t_screen.nearPlaneDist;
+    depth.resize(width * height);
+    _isActive = false;
+    resetStats(stats);
+    resetStats(lastFrameStats);
+}
+
+OcclusionCuller::~OcclusionCuller() {}
+
+// ----
+// Methods
+// ----
+
+void OcclusionCuller::begin(const Matrix &t_viewProjection)
+{
+    viewProjection = t_viewProjection;
+    for (u32 i = 0; i < depth.size(); i++)
+        depth[i] = 0.0F;
+    _isActive = true;
+}
+
+void OcclusionCuller::addOccluder(const Matrix &t_model, const Vector3 *t_vertices, const u32 *t_indices, const u32 &t_indicesCount)
+{
+    // Model view projection, column major (see Matrix)
+    float mvp[16];
+    for (u8 col = 0; col < 4; col++)
+        for (u8 row = 0; row < 4; row++)
+        {
+            float sum = 0.0F;
+            for (u8 k = 0; k < 4; k++)
+                sum += viewProjection.data[k * 4 + row] * t_model.data[col * 4 + k];
+            mvp[col * 4 + row] = sum;
+        }
+    float a[3], b[3], c[3];
+    for (u32 i = 0; i + 2 < t_indicesCount; i += 3)
+    {
+        if (!project(mvp, t_vertices[t_indices[i]], a) ||
+            !project(mvp, t_vertices[t_indices[i + 1]], b) ||
+            !project(mvp, t_vertices[t_indices[i + 2]], c))
+            continue;
+        rasterize(a, b, c);
+        stats.occluderTriangles++;
+    }
+}
+
+u8 OcclusionCuller::isVisible(const Vector3 &t_min, const Vector3 &t_max)
+{
+    stats.testedBoxes++;
+    float minX = 0.0F, minY = 0.0F, maxX = 0.0F, maxY = 0.0F, nearest = 0.0F;
+    float corner[3];
+    for (u8 i = 0; i < 8; i++)
+    {
+        const Vector3 vertex(i & 1 ? t_max.x : t_min.x, i & 2 ? t_max.y : t_min.y, i & 4 ? t_max.z : t_min.z);
+        if (!project(viewProjection.data, vertex, corner))
+            return true;
+        if (i == 0)
+        {
+            minX = maxX = corner[0];
+            minY = maxY = corner[1];
+            nearest = corner[2];
+            continue;
+        }
+        minX = Math::min(minX, corner[0]);
+        minY = Math::min(minY, corner[1]);
+        maxX = Math::max(maxX, corner[0]);
+        maxY = Math::max(maxY, corner[1]);
+        nearest = Math::max(nearest, corner[2]);
+    }
+    // Every pixel touched by rectangle
+    const s32 x0 = static_cast<s32>(floorf(minX)), x1 = static_cast<s32>(floorf(maxX));
+    const s32 y0 = static_cast<s32>(floorf(minY)), y1 = static_cast<s32>(floorf(maxY));
+    if (x1 < 0 || y1 < 0 || x0 >= width || y0 >= height)
+        return true;
+    const s32 startX = Math::max(x0, 0), endX = Math::min(x1, static_cast<s32>(width) - 1);
+    const s32 startY = Math::max(y0, 0), endY = Math::min(y1, static_cast<s32>(height) - 1);
+    const float boxDepth = nearest * OCCLUSION_CULLER_DEPTH_BIAS;
+    for (s32 y = startY; y <= endY; y++)
+    {
+        const float *row = &depth[y * width];
+        for (s32 x = startX; x <= endX; x++)
+        {
+            stats.testedPixels++;
+            if (row[x] <= boxDepth)
+                return true;
+        }
+    }
+    stats.culledBoxes++;
+    return false;
+}
+
+void OcclusionCuller::endFrame()
+{
+    lastFrameStats = stats;
+    resetStats(stats);
+    _isActive = false;
+}
+
+u8 OcclusionCuller::project(const float *t_matrix, const Vector3 &t_vertex, float *o_result)
+{
+    const float w = t_matrix[3] * t_vertex.x + t_matrix[7] * t_vertex.y + t_matrix[11] * t_vertex.z + t_matrix[15];
+    if (w < nearPlaneDist)
+        return false;
+    const float x = t_matrix[0] * t_vertex.x + t_matrix[4] * t_vertex.y + t_matrix[8] * t_vertex.z + t_matrix[12];
+    const float y = t_matrix[1] * t_vertex.x + t_matrix[5] * t_vertex.y + t_matrix[9] * t_vertex.z + t_matrix[13];
+    const float invW = 1.0F / w;
+    o_result[0] = x * invW * scaleX + width / 2.0F;
+    o_result[1] = y * invW * scaleY + height / 2.0F;
+    o_result[2] = invW;
+    return true;
+}
+
+/** Half-space rasterization of pixel centers. 1/w is linear in screen space, so it is interpolated. */
+void OcclusionCuller::rasterize(const float *a, const float *b, const float *c)
+{
+    float area = (b[0] - a[0]) * (c[1] - a[1]) - (b[1] - a[1]) * (c[0] - a[0]);
+    if (area == 0.0F)
+        return;
+    if (area < 0.0F) // Both windings are drawn
+    {
+        const float *temp = b;
+        b = c;
+        c = temp;
+        area = -area;
+    }
+    const s32 startX = Math::max(static_cast<s32>(ceilf(Math::min(a[0], Math::min(b[0], c[0])) - 0.5F)), 0);
+    const s32 endX = Math::min(static_cast<s32>(floorf(Math::max(a[0], Math::max(b[0], c[0])) - 0.5F)), static_cast<s32>(width) - 1);
+    const s32 startY = Math::max(static_cast<s32>(ceilf(Math::min(a[1], Math::min(b[1], c[1])) - 0.5F)), 0);
+    const s32 endY = Math::min(static_cast<s32>(floorf(Math::max(a[1], Math::max(b[1], c[1])) - 0.5F)), static_cast<s32>(height) - 1);
+    if (startX > endX || startY > endY)
+        return;
+
+    // Edge functions (weights of opposite vertices) and their steps
+    const float invArea = 1.0F / area;
+    const float stepXA = b[1] - c[1], stepYA = c[0] - b[0];
+    const float stepXB = c[1] - a[1], stepYB = a[0] - c[0];
+    const float stepXC = a[1] - b[1], stepYC = b[0] - a[0];
+    const float px = startX + 0.5F, py = startY + 0.5F;
+    float rowA = (c[0] - b[0]) * (py - b[1]) - (c[1] - b[1]) * (px - b[0]);
+    float rowB = (a[0] - c[0]) * (py - c[1]) - (a[1] - c[1]) * (px - c[0]);
+    float rowC = (b[0] - a[0]) * (py - a[1]) - (b[1] - a[1]) * (px - a[0]);
+    // 1/w as plane: depth = weightA * a + weightB * b + weightC * c
+    const float depthStepX = (stepXA * a[2] + stepXB * b[2] + stepXC * c[2]) * invArea;
+    const float depthStepY = (stepYA * a[2] + stepYB * b[2] + stepYC * c[2]) * invArea;
+    float rowDepth = (rowA * a[2] + rowB * b[2] + rowC * c[2]) * invArea;
+
+    for (s32 y = startY; y <= endY; y++)
+    {
+        float weightA = rowA, weightB = rowB, weightC = rowC, pixelDepth = rowDepth;
+        float *row = &depth[y * width];
+        for (s32 x = startX; x <= endX; x++)
+        {
+            if (weightA >= 0.0F && weightB >= 0.0F && weightC >= 0.0F && pixelDepth > row[x])
+            {
+                row[x] = pixelDepth;
+                stats.rasterizedPixels++;
+            }
+            weightA += stepXA;
+            weightB += stepXB;
+            weightC += stepXC;
+            pixelDepth += depthStepX;
+        }
+        rowA += stepYA;
+        rowB += stepYB;
+        rowC += stepYC;
+        rowDepth += depthStepY;
+    }
+}
+
+void OcclusionCuller::resetStats(OcclusionCullerStats &t_stats)
+{
+    t_stats.occluderTriangles = 0;
+    t_stats.rasterizedPixels = 0;
+    t_stats.testedBoxes = 0;
+    t_stats.culledBoxes = 0;
+    t_stats.testedPixels = 0;
+}
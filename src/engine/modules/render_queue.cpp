@@ -0,0 +1,146 @@
+/*
+# ______       ____   ___
+#   |     \/   ____| |___|    
+#   |     |   |   \  |   |       
+#-----------------------------------------------------------------------
+# Copyright 2020, tyra - https://github.com/h4570/tyra
+# Licenced under Apache License 2.0
+# Sandro Sobczyński <sandro.sobczynski@gmail.com>
+*/
+
+#include "../include/modules/render_queue.hpp"
+#include "../include/models/mesh.hpp"
+#include <cstring>
+
+const u64 RENDER_QUEUE_TRANSLUCENT_BIT = 1ULL << 63;
+const u32 RENDER_QUEUE_DEPTH_MASK = 0xFFFFFF;
+
+// ----
+// Constructors/Destructors
+// ----
+
+RenderQueue::RenderQueue()
+{
+    _isSortingEnabled = true;
+    stats.items = 0;
+    stats.unsortedStateChanges = 0;
+    stats.sortedStateChanges = 0;
+}
+
+RenderQueue::~RenderQueue() {}
+
+// ----
+// Methods
+// ----
+
+u64 RenderQueue::createKey(const u8 &t_isTranslucent, const u8 &t_program, const u16 &t_texture, const u16 &t_material, const float &t_depth)
+{
+    // Bits of non negative float are monotonic, so we can take 24 highest bits (without sign)
+    u32 depthBits = 0;
+    if (t_depth > 0.0F)
+        memcpy(&depthBits, &t_depth, sizeof(float));
+    u64 depth = (depthBits >> 7) & RENDER_QUEUE_DEPTH_MASK;
+    u64 state = ((u64)(t_program & 0x7F) << 32) | ((u64)t_texture << 16) | (u64)t_material;
+    if (t_isTranslucent)
+        return RENDER_QUEUE_TRANSLUCENT_BIT | ((RENDER_QUEUE_DEPTH_MASK - depth) << 39) | state;
+    else
+        return (state << 24) | depth;
+}
+
+u64 RenderQueue::getStateOfKey(const u64 &t_key)
+{
+    if (t_key & RENDER_QUEUE_TRANSLUCENT_BIT)
+        return RENDER_QUEUE_TRANSLUCENT_BIT | (t_key & ((1ULL << 39) - 1));
+    else
+        return t_key >> 24;
+}
+
+void RenderQueue::add(const u64 &t_key, Mesh *t_mesh, Texture *t_texture, const u32 &t_materialIndex, LightBulb *t_bulbs, const u16 &t_bulbsCount)
+{
+    RenderQueueItem item;
+    item.key = t_key;
+    item.mesh = t_mesh;
+    item.texture = t_texture;
+    item.materialIndex = t_materialIndex;
+    item.bulbsCount = t_bulbs != NULL ? t_bulbsCount : 0;
+    item.bulbsIndex = addBulbs(t_bulbs, item.bulbsCount);
+    item.scale = 1.0F;
+    item.color.rgbaq = 0;
+    if (t_mesh != NULL)
+    {
+        item.position = t_mesh->position;
+        item.rotation = t_mesh->rotation;
+        item.scale = t_mesh->scale;
+        item.color = t_mesh->getMaterial(t_materialIndex).color;
+    }
+    items.push_back(item);
+}
+
+/** LSD radix sort, 8 passes of 8 bits. Passes where all keys have the same byte are skipped. */
+void RenderQueue::sort()
+{
+    const u32 count = items.size();
+    stats.items = count;
+    stats.unsortedStateChanges = countStateChanges();
+    if (_isSortingEnabled && count > 1)
+    {
+        sortBuffer.resize(count);
+        RenderQueueItem *src = &items[0];
+        RenderQueueItem *dst = &sortBuffer[0];
+        u32 offsets[256];
+        for (u32 shift = 0; shift < 64; shift += 8)
+        {
+            memset(offsets, 0, sizeof(offsets));
+            for (u32 i = 0; i < count; i++)
+                offsets[(src[i].key >> shift) & 0xFF]++;
+            if (offsets[(src[0].key >> shift) & 0xFF] == count)
+                continue;
+            u32 sum = 0;
+            for (u32 i = 0; i < 256; i++)
+            {
+                u32 bucketSize = offsets[i];
+                offsets[i] = sum;
+                sum += bucketSize;
+            }
+            for (u32 i = 0; i < count; i++)
+                dst[offsets[(src[i].key >> shift) & 0xFF]++] = src[i];
+            RenderQueueItem *temp = src;
+            src = dst;
+            dst = temp;
+        }
+        if (src != &items[0])
+            items.swap(sortBuffer);
+    }
+    stats.sortedStateChanges = countStateChanges();
+}
+
+/** Copies bulbs. Materials of one mesh have the same bulbs, so last copy is reused, if it is equal */
+u32 RenderQueue::addBulbs(const LightBulb *t_bulbs, const u16 &t_bulbsCount)
+{
+    if (t_bulbsCount == 0)
+        return 0;
+    if (bulbs.size() >= t_bulbsCount)
+    {
+        const u32 lastIndex = bulbs.size() - t_bulbsCount;
+        u8 isEqual = true;
+        for (u16 i = 0; i < t_bulbsCount && isEqual; i++)
+            isEqual = bulbs[lastIndex + i].intensity == t_bulbs[i].intensity &&
+                      bulbs[lastIndex + i].position.x == t_bulbs[i].position.x &&
+                      bulbs[lastIndex + i].position.y == t_bulbs[i].position.y &&
+                      bulbs[lastIndex + i].position.z == t_bulbs[i].position.z;
+        if (isEqual)
+            return lastIndex;
+    }
+    const u32 result = bulbs.size();
+    bulbs.insert(bulbs.end(), t_bulbs, t_bulbs + t_bulbsCount);
+    return result;
+}
+
+u32 RenderQueue::countStateChanges() const
+{
+    u32 result = 0;
+    for (u32 i = 0; i < items.size(); i++)
+        if (i == 0 || getStateOfKey(items[i].key) != getStateOfKey(items[i - 1].key))
+            result++;
+    return result;
+}
@@ -22,6 +22,8 @@
 
 static const float GS_CENTER = 4096.0F;
 static const float SCREEN_CENTER = GS_CENTER / 2.0F;
+/** How many render queue items ahead textures are uploaded, while VU1 draws current ones */
+static const u32 RENDERER_TEXTURE_PREFETCH = 4;
 
 /** Initialize DMA<->GIF channel
  * Allocate buffers
@@ -38,10 +40,9 @@ Renderer::Renderer(u32 t_packetSize, ScreenSettings *t_screen)
     dma_channel_fast_waits(DMA_CHANNEL_GIF);
     screen = t_screen;
     context = 0;
-    isTextureVRAMAllocated = false;
     isVSyncEnabled = true;
+    isBackfaceCullingOnVU1 = false;
     isFrameEmpty = false;
-    lastTextureId = 0;
     flipPacket = packet2_create(4, P2_TYPE_UNCACHED_ACCL, P2_MODE_NORMAL, 0);
     allocateBuffers((int)t_screen->width, (int)t_screen->height);
     initDrawingEnv();
@@ -49,10 +50,16 @@ Renderer::Renderer(u32 t_packetSize, ScreenSettings *t_screen)
     worldColor.r = 0x10;
     worldColor.g = 0x10;
     worldColor.b = 0x10;
-    gifSender = new GifSender(t_packetSize, t_screen, &light);
-    vifSender = new VifSender(&light);
+    frameArena = new FrameArena();
+    gifSender = new GifSender(t_packetSize, t_screen, &light, frameArena);
+    vifSender = new VifSender(&light, frameArena);
+    spriteBatch = new SpriteBatch(t_screen);
+    occlusionCuller = new OcclusionCuller(*t_screen);
+    frameChain = NULL;
     perspective.setPerspective(*t_screen);
     renderData.projection = &perspective;
+    renderData.viewProjection = &viewProjection;
+    isViewProjectionSet = false;
     consoleLog("Renderer initialized!");
 }
 
@@ -62,85 +69,40 @@ Renderer::~Renderer() {}
 // Methods
 // ----
 
-/** Configure and allocate vRAM for texture buffer */
-void Renderer::allocateTextureBuffer(Texture *t_texture)
+/** Returns VRAM cache entry of given texture, uploads texture only if it is not in VRAM cache */
+TextureCacheEntry *Renderer::changeTexture(Texture *t_tex)
 {
-    textureBuffer.width = t_texture->getWidth();
-    textureBuffer.psm = t_texture->getType();
-    textureBuffer.info.components = textureBuffer.psm == TEX_TYPE_RGBA ? TEXTURE_COMPONENTS_RGBA : TEXTURE_COMPONENTS_RGB;
-    textureBuffer.address = graph_vram_allocate(t_texture->getWidth(), t_texture->getHeight(), textureBuffer.psm, GRAPH_ALIGN_BLOCK);
-    assertMsg(textureBuffer.address > 1, "Texture buffer allocation error. No memory!");
-    textureBuffer.info.width = draw_log2(t_texture->getWidth());
-    textureBuffer.info.height = draw_log2(t_texture->getHeight());
-    textureBuffer.info.function = TEXTURE_FUNCTION_MODULATE;
-    isTextureVRAMAllocated = true;
+    assertMsg(t_tex != NULL, "Texture was not found in texture repository!");
+    return textureCache.use(*t_tex);
 }
 
-/** Configure and allocate vRAM for texture buffer */
-void Renderer::deallocateTextureBuffer()
+void Renderer::prefetchTexture(Texture &t_texture)
 {
-    if (isTextureVRAMAllocated)
-    {
-        graph_vram_free(textureBuffer.address);
-        isTextureVRAMAllocated = false;
-    }
+    textureCache.prefetch(t_texture);
+    textureCache.flushUploads();
 }
 
-void Renderer::changeTexture(Texture *t_tex)
+void Renderer::draw(Sprite &t_sprite)
 {
-    assertMsg(t_tex != NULL, "Texture was not found in texture repository!");
-    if (t_tex->getId() != lastTextureId)
+    if (frameChain != NULL) // Sprite batch adds sprites to frame chain
     {
-        lastTextureId = t_tex->getId();
-        deallocateTextureBuffer();
-        allocateTextureBuffer(t_tex);
-        GifSender::sendTexture(*t_tex, &textureBuffer);
+        flushSpriteBatch();
+        drawBatched(t_sprite);
+        flushSpriteBatch();
+        return;
     }
-}
-
-void Renderer::draw(Sprite &t_sprite)
-{
     Texture *texture = textureRepo.getBySpriteOrMesh(t_sprite.getId());
+    assertMsg(texture != NULL, "Texture was not found in texture repository!");
     texrect_t rect;
-    float sizeX, sizeY;
-    if (t_sprite.getMode() == MODE_REPEAT)
-    {
-        sizeX = t_sprite.size.x;
-        sizeY = t_sprite.size.y;
-    }
-    else
-    {
-        sizeX = (float)texture->getWidth();
-        sizeY = (float)texture->getHeight();
-    }
-
-    float texS, texT;
-    float texMax = texT = texS = sizeX > sizeY ? sizeX : sizeY;
-    if (sizeX > sizeY)
-        texT = texMax / (sizeX / sizeY);
-    else if (sizeY > sizeX)
-        texS = texMax / (sizeY / sizeX);
-    rect.t0.s = t_sprite.isFlippedHorizontally() ? texS : 0.0F;
-    rect.t0.t = t_sprite.isFlippedVertically() ? texT : 0.0F;
-    rect.t1.s = t_sprite.isFlippedHorizontally() ? 0.0F : texS;
-    rect.t1.t = t_sprite.isFlippedVertically() ? 0.0F : texT;
-    rect.color.r = t_sprite.color.r;
-    rect.color.g = t_sprite.color.g;
-    rect.color.b = t_sprite.color.b;
-    rect.color.a = t_sprite.color.a;
-    rect.color.q = 0;
-    rect.v0.x = t_sprite.position.x;
-    rect.v0.y = t_sprite.position.y;
-    rect.v0.z = (u32)-1;
-    rect.v1.x = (t_sprite.size.x * t_sprite.scale) + t_sprite.position.x;
-    rect.v1.y = (t_sprite.size.y * t_sprite.scale) + t_sprite.position.y;
-    rect.v1.z = (u32)-1;
+    SpriteBatch::getRect(t_sprite, *texture, rect);
     beginFrameIfNeeded();
-    changeTexture(texture);
-    packet2_t *packet2 = packet2_create(12, P2_TYPE_NORMAL, P2_MODE_NORMAL, 0);
+    flushSpriteBatch();
+    flushRenderQueue(); // 2D is drawn in calls order, so 3D drawn before must be sent first
+    TextureCacheEntry *texEntry = changeTexture(texture);
+    packet2_t *packet2 = frameArena->getPacket(12, P2_TYPE_NORMAL, P2_MODE_NORMAL, 0);
     packet2_update(packet2, draw_primitive_xyoffset(packet2->next, 0, SCREEN_CENTER, SCREEN_CENTER));
     packet2_utils_gif_add_set(packet2, 1);
-    packet2_utils_gs_add_texbuff_clut(packet2, &textureBuffer, &t_sprite.clut);
+    packet2_utils_gs_add_texbuff_clut(packet2, &texEntry->buffer, texture->isPaletted() ? &texEntry->clut : &t_sprite.clut);
     draw_enable_blending();
     packet2_update(packet2, draw_rect_textured(packet2->next, 0, &rect));
     packet2_update(packet2,
@@ -153,7 +115,22 @@ void Renderer::draw(Sprite &t_sprite)
     packet2_update(packet2, draw_finish(packet2->next));
     dma_channel_wait(DMA_CHANNEL_GIF, 0);
     dma_channel_send_packet2(packet2, DMA_CHANNEL_GIF, true);
-    packet2_free(packet2);
+}
+
+void Renderer::drawBatched(Sprite &t_sprite)
+{
+    Texture *texture = textureRepo.getBySpriteOrMesh(t_sprite.getId());
+    assertMsg(texture != NULL, "Texture was not found in texture repository!");
+    spriteBatch->add(t_sprite, *texture);
+}
+
+void Renderer::flushSpriteBatch()
+{
+    if (spriteBatch->isEmpty())
+        return;
+    beginFrameIfNeeded();
+    flushRenderQueue();
+    spriteBatch->flush(textureCache);
 }
 
 /** Initializes drawing environment (1st app packet) */
@@ -216,6 +193,9 @@ void Renderer::allocateBuffers(int t_screenW, int t_screenH)
     zBuffer.address = graph_vram_allocate(t_screenW, t_screenH, zBuffer.zsm, GRAPH_ALIGN_PAGE);
     consoleLog("Framebuffers, zBuffer set and allocated!");
 
+    // Rest of VRAM is used by texture cache.
+    textureCache.init(zBuffer.address + graph_vram_size(t_screenW, t_screenH, zBuffer.zsm, GRAPH_ALIGN_PAGE), GRAPH_VRAM_MAX_WORDS);
+
     // Initialize the screen and tie the first framebuffer to the read circuits.
     graph_initialize(frameBuffers[0].address, frameBuffers[0].width, frameBuffers[0].height, frameBuffers[0].psm, 0, 0);
 }
@@ -250,7 +230,7 @@ void Renderer::allocateBuffers(int t_screenW, int t_screenH)
 //         VECTOR *normals = new VECTOR[vertCount];
 //         VECTOR *coordinates = new VECTOR[vertCount];
 //         vertCount = t_mesh.getDrawData(i, vertices, normals, coordinates, *renderData.cameraPosition);
-//         gifSender->addObject(&renderData, t_mesh, vertCount, vertices, normals, coordinates, t_bulbs, t_bulbsCount, &textureBuffer, &material->color);
+//         gifSender->addObject(&renderData, t_mesh, vertCount, vertices, normals, coordinates, t_bulbs, t_bulbsCount, texBuffer, &material->color);
 //         gifSender->sendPacket();
 //         delete[] vertices;
 //         delete[] normals;
@@ -271,28 +251,41 @@ void Renderer::draw(Mesh **t_meshes, u16 t_amount, LightBulb *t_bulbs, u16 t_bul
     beginFrameIfNeeded();
     assertMsg(t_meshes[0]->isDataLoaded(), "Can't draw, because no mesh data was loaded!");
     if (
+        frameChain == NULL &&
         t_amount >= 3 &&
         !t_meshes[0]->shouldBeBackfaceCulled &&
+        !t_meshes[0]->shouldBeClipped &&
+        (t_bulbs == NULL || !t_meshes[0]->shouldBeLighted) &&
         t_meshes[0]->getFramesCount() == 1 &&
         t_meshes[0]->getMaterialsCount() == 1 &&
+        t_meshes[0]->getLODLevelsCount() == 1 &&
         t_meshes[0]->getFrame(0).getVertexCount() <= 96)
     {
-        vifSender->disableWait();
-        Mesh **meshesInFrustum = new Mesh *[t_amount];
-        u16 addedMeshes = 0;
+        meshesCuller.clear();
         for (u16 i = 0; i < t_amount; i++)
-            if (t_meshes[i]->getMaterial(0).isInFrustum(renderData.frustumPlanes, t_meshes[i]->position))
-                meshesInFrustum[addedMeshes++] = t_meshes[i];
-        draw(*meshesInFrustum[0], t_bulbs, t_bulbsCount);
-        draw(*meshesInFrustum[1], t_bulbs, t_bulbsCount);
+            meshesCuller.add(t_meshes[i]->getMaterial(0).getBoundingBoxVertices(), t_meshes[i]->position, t_meshes[i]->scale);
+        meshesCuller.cull(renderData.frustumPlanes);
+        meshesInFrustum.clear();
+        for (u16 i = 0; i < t_amount; i++)
+            if (meshesCuller.isVisible(i) && !isOccluded(*t_meshes[i]))
+                meshesInFrustum.push_back(t_meshes[i]);
+        // Two first meshes are sent normally, rest of them reuses their VU1 data
+        if (meshesInFrustum.size() < 3)
+        {
+            for (u32 i = 0; i < meshesInFrustum.size(); i++)
+                drawImmediately(*meshesInFrustum[i], t_bulbs, t_bulbsCount);
+            return;
+        }
+        vifSender->disableWait();
+        drawImmediately(*meshesInFrustum[0], t_bulbs, t_bulbsCount);
+        drawImmediately(*meshesInFrustum[1], t_bulbs, t_bulbsCount);
         vifSender->enableWait();
         resetWaitFlag();
-        vifSender->drawTheSameWithOtherMatrices(renderData, meshesInFrustum, 2, addedMeshes);
+        vifSender->drawTheSameWithOtherMatrices(renderData, &meshesInFrustum[0], 2, meshesInFrustum.size());
         if (isWaitFlagSet())
             resetWaitFlag();
         else
             waitForRender();
-        delete[] meshesInFrustum;
     }
     else
         for (u16 i = 0; i < t_amount; i++)
@@ -302,27 +295,389 @@ void Renderer::draw(Mesh **t_meshes, u16 t_amount, LightBulb *t_bulbs, u16 t_bul
 void Renderer::draw(Mesh &t_mesh, LightBulb *t_bulbs, u16 t_bulbsCount)
 {
     beginFrameIfNeeded();
-    vifSender->calcMatrix(renderData, t_mesh.position, t_mesh.rotation);
     assertMsg(t_mesh.isDataLoaded(), "Can't draw, because no mesh data was loaded!");
-    camRotation.identity();
-    camRotation.rotate(-t_mesh.rotation);
-    Vector3 rotatedCamera = Vector3(camRotation * *renderData.cameraPosition);
-
     if (t_mesh.getCurrentAnimationFrame() != t_mesh.getNextAnimationFrame())
         t_mesh.animate();
+    if (isOccluded(t_mesh))
+        return;
+    Vector3 viewPosition = *renderData.view * t_mesh.position;
+    float depth = viewPosition.x * viewPosition.x + viewPosition.y * viewPosition.y + viewPosition.z * viewPosition.z;
+    if (t_mesh.getLODLevelsCount() > 1)
+        t_mesh.updateLOD(getScreenSize(t_mesh.getCurrentBoundingRadius(), depth));
     for (u32 i = 0; i < t_mesh.getMaterialsCount(); i++)
     {
         MeshMaterial *material = &t_mesh.getMaterial(i);
-        if (t_mesh.shouldBeFrustumCulled && !material->isInFrustum(renderData.frustumPlanes, t_mesh.position))
-            return;
-        u32 vertCount = material->getFacesCount();
-        VECTOR vertices[vertCount] __attribute__((aligned(16)));
-        VECTOR normals[vertCount] __attribute__((aligned(16)));
-        VECTOR coordinates[vertCount] __attribute__((aligned(16)));
+        if (t_mesh.shouldBeFrustumCulled && !material->isInFrustum(renderData.frustumPlanes, t_mesh.position, t_mesh.scale))
+            continue;
         Texture *tex = textureRepo.getBySpriteOrMesh(material->getId());
-        changeTexture(tex);
-        vertCount = t_mesh.getDrawData(i, vertices, normals, coordinates, rotatedCamera);
-        vifSender->drawMesh(&renderData, perspective, vertCount, vertices, normals, coordinates, t_mesh, t_bulbs, t_bulbsCount, &textureBuffer, &material->color, !material->areSTsPresent());
+        assertMsg(tex != NULL, "Texture was not found in texture repository!");
+        u64 key = RenderQueue::createKey(material->color.a < 0x80, getProgram(t_mesh, t_mesh.getLODMaterial(i), t_bulbs != NULL), Handle::getIndex(tex->getId()), Handle::getIndex(material->getId()), depth);
+        renderQueue.add(key, &t_mesh, tex, i, t_bulbs, t_bulbsCount);
+    }
+}
+
+void Renderer::draw(SceneTree &t_scene, LightBulb *t_bulbs, u16 t_bulbsCount)
+{
+    beginFrameIfNeeded();
+    if (visibleProxies.size() < t_scene.getCount())
+        visibleProxies.resize(t_scene.getCount());
+    if (visibleProxies.size() == 0)
+        return;
+    const u32 visibleCount = t_scene.getVisible(renderData.frustumPlanes, &visibleProxies[0], visibleProxies.size());
+    for (u32 i = 0; i < visibleCount; i++)
+        draw(*t_scene.getMesh(visibleProxies[i]), t_bulbs, t_bulbsCount);
+}
+
+void Renderer::drawInstanced(Mesh &t_mesh, MeshInstance *t_instances, const u32 &t_count)
+{
+    assertMsg(t_mesh.isDataLoaded(), "Can't draw, because no mesh data was loaded!");
+    beginFrameIfNeeded();
+    if (t_mesh.getCurrentAnimationFrame() != t_mesh.getNextAnimationFrame())
+        t_mesh.animate();
+    const float screenSize = setInstancesMatrices(t_mesh, t_instances, t_count);
+    if (instanceMatrices.size() == 0)
+        return;
+    // All instances share vertices, so the closest one selects LOD level
+    if (t_mesh.getLODLevelsCount() > 1)
+        t_mesh.updateLOD(screenSize);
+    // Vertices are shared by all instances, so they can't be culled per camera on EE
+    const u8 shouldBeBackfaceCulled = t_mesh.shouldBeBackfaceCulled;
+    t_mesh.shouldBeBackfaceCulled = false;
+    vifSender->setBackfaceCulling(isBackfaceCullingOnVU1 && shouldBeBackfaceCulled);
+    Vector3 noCamera;
+    for (u32 i = 0; i < t_mesh.getMaterialsCount(); i++)
+    {
+        MeshMaterial *material = &t_mesh.getMaterial(i);
+        Texture *texture = textureRepo.getBySpriteOrMesh(material->getId());
+        VECTOR *vertices, *normals, *coordinates;
+        u32 vertCount = t_mesh.getBakedDrawData(i, vertices, normals, coordinates);
+        if (vertCount == 0)
+        {
+            vertCount = t_mesh.getLODMaterial(i).getFacesCount();
+            vertices = frameChain == NULL ? frameArena->allocate<VECTOR>(vertCount * 3) : reinterpret_cast<VECTOR *>(frameChain->allocate(vertCount * 3));
+            normals = vertices + vertCount;
+            coordinates = normals + vertCount;
+            vertCount = t_mesh.getDrawData(i, vertices, normals, coordinates, noCamera);
+        }
+        TextureCacheEntry *texEntry = changeTexture(texture);
+        lod_t lod = t_mesh.lod;
+        setMipmapLOD(lod, t_mesh, texEntry->mipmapsCount);
+        const Vu1Program program = static_cast<Vu1Program>((t_mesh.shouldBeClipped ? VU1_FEATURE_CLIP : 0) | (material->areSTsPresent() ? VU1_FEATURE_STQ : 0));
+        vifSender->drawInstances(&renderData, vertCount, vertices, coordinates, t_mesh, &instanceMatrices[0], &instanceColors[0], instanceMatrices.size(), texEntry, texture->isPaletted() ? &texEntry->clut : &t_mesh.clut, &lod, program);
+    }
+    t_mesh.shouldBeBackfaceCulled = shouldBeBackfaceCulled;
+}
+
+/**
+ * Calculates model view projection matrices of instances, which are in view frustum.
+ * Bounding sphere of current frame bounding box is used, so rotation and scale are supported.
+ * Returns biggest screen size of visible instances.
+ */
+float Renderer::setInstancesMatrices(Mesh &t_mesh, MeshInstance *t_instances, const u32 &t_count)
+{
+    instanceMatrices.clear();
+    instanceColors.clear();
+    const Vector3 *box = t_mesh.getCurrentBoundingBoxVertices();
+    Vector3 min = box[0], max = box[0];
+    for (u8 i = 1; i < 8; i++)
+    {
+        min.set(Math::min(min.x, box[i].x), Math::min(min.y, box[i].y), Math::min(min.z, box[i].z));
+        max.set(Math::max(max.x, box[i].x), Math::max(max.y, box[i].y), Math::max(max.z, box[i].z));
+    }
+    const Vector3 center = (min + max) * 0.5F;
+    const float radius = (max - min).length() * 0.5F;
+    Matrix model;
+    float result = 0.0F;
+    for (u32 i = 0; i < t_count; i++)
+    {
+        MeshTransform::compose(model, t_instances[i].position, t_instances[i].rotation, t_instances[i].scale);
+        const Vector3 worldCenter = model * center;
+        if (t_mesh.shouldBeFrustumCulled && !isSphereInFrustum(worldCenter, radius * t_instances[i].scale))
+            continue;
+        const Vector3 viewCenter = *renderData.view * worldCenter;
+        result = Math::max(result, getScreenSize(radius * t_instances[i].scale, viewCenter.innerProduct(viewCenter)));
+        instanceMatrices.push_back(viewProjection * model);
+        instanceColors.push_back(t_instances[i].color);
+    }
+    return result;
+}
+
+void Renderer::addOccluder(Mesh &t_mesh)
+{
+    assertMsg(t_mesh.isDataLoaded(), "Can't add occluder, because no mesh data was loaded!");
+    beginFrameIfNeeded();
+    if (!occlusionCuller->isActive())
+        occlusionCuller->begin(viewProjection);
+    const Matrix &model = t_mesh.getModelMatrix();
+    MeshFrame &frame = t_mesh.getFrame(t_mesh.getCurrentAnimationFrame());
+    for (u32 i = 0; i < t_mesh.getMaterialsCount(); i++)
+        occlusionCuller->addOccluder(model, frame.getVertices(), t_mesh.getMaterial(i).getVertexFaces(), t_mesh.getMaterial(i).getFacesCount());
+}
+
+/** Box around sphere of current frame bounding box is tested, so rotation is supported. */
+u8 Renderer::isOccluded(Mesh &t_mesh)
+{
+    if (!occlusionCuller->isActive())
+        return false;
+    const float radius = t_mesh.getCurrentBoundingRadius();
+    const Vector3 extent(radius, radius, radius);
+    return !occlusionCuller->isVisible(t_mesh.position - extent, t_mesh.position + extent);
+}
+
+/** Projected diameter of sphere in pixels. Screen height, when camera is inside of sphere. */
+float Renderer::getScreenSize(const float &t_radius, const float &t_squaredDistance)
+{
+    if (t_squaredDistance <= t_radius * t_radius)
+        return screen->height;
+    // Pixels per world unit at distance 1
+    const float scale = -perspective.data[5] * screen->projectionScale * 0.5F;
+    return 2.0F * t_radius * scale * Math::invSqrt(t_squaredDistance);
+}
+
+u8 Renderer::isSphereInFrustum(Vector3 t_center, const float &t_radius)
+{
+    for (u8 i = 0; i < 6; i++)
+        if (renderData.frustumPlanes[i].distanceTo(t_center) < -t_radius)
+            return false;
+    return true;
+}
+
+/** Draws all materials of mesh without render queue */
+void Renderer::drawImmediately(Mesh &t_mesh, LightBulb *t_bulbs, u16 t_bulbsCount)
+{
+    assertMsg(t_mesh.isDataLoaded(), "Can't draw, because no mesh data was loaded!");
+    Vector3 rotatedCamera = setMeshMatrices(t_mesh);
+    if (t_mesh.getCurrentAnimationFrame() != t_mesh.getNextAnimationFrame())
+        t_mesh.animate();
+    if (t_mesh.getLODLevelsCount() > 1)
+    {
+        const Vector3 viewPosition = *renderData.view * t_mesh.position;
+        t_mesh.updateLOD(getScreenSize(t_mesh.getCurrentBoundingRadius(), viewPosition.innerProduct(viewPosition)));
+    }
+    for (u32 i = 0; i < t_mesh.getMaterialsCount(); i++)
+    {
+        MeshMaterial *material = &t_mesh.getMaterial(i);
+        if (t_mesh.shouldBeFrustumCulled && !material->isInFrustum(renderData.frustumPlanes, t_mesh.position, t_mesh.scale))
+            continue;
+        drawMaterial(t_mesh, i, textureRepo.getBySpriteOrMesh(material->getId()), &material->color, rotatedCamera, t_bulbs, t_bulbsCount);
+    }
+}
+
+static inline u8 isTheSameTransform(const RenderQueueItem &t_a, const RenderQueueItem &t_b)
+{
+    return t_a.scale == t_b.scale &&
+           t_a.position.x == t_b.position.x && t_a.position.y == t_b.position.y && t_a.position.z == t_b.position.z &&
+           t_a.rotation.x == t_b.rotation.x && t_a.rotation.y == t_b.rotation.y && t_a.rotation.z == t_b.rotation.z;
+}
+
+/** Sorts and draws all meshes added via draw() */
+void Renderer::flushRenderQueue()
+{
+    if (renderQueue.isEmpty())
+        return;
+    renderQueue.sort();
+    const std::vector<RenderQueueItem> &items = renderQueue.getItems();
+    const RenderQueueItem *lastItem = NULL;
+    Vector3 rotatedCamera;
+    // In frame chain mode textures are uploaded in chain, just before their draws
+    const u32 prefetchCount = frameChain == NULL ? RENDERER_TEXTURE_PREFETCH : 0;
+    for (u32 i = 0; i < items.size() && i < prefetchCount; i++)
+        if (items[i].texture != NULL)
+            textureCache.prefetch(*items[i].texture);
+    for (u32 i = 0; i < items.size(); i++)
+    {
+        // Upload of next textures goes via PATH3, while VU1 is drawing this item
+        const u32 prefetchIndex = i + prefetchCount;
+        if (prefetchCount > 0 && prefetchIndex < items.size() && items[prefetchIndex].texture != NULL)
+            textureCache.prefetch(*items[prefetchIndex].texture);
+        textureCache.flushUploads();
+        // Mesh could be moved after it was queued, so transform from draw() call is used
+        const RenderQueueItem &item = items[i];
+        Mesh &mesh = *item.mesh;
+        const Vector3 position = mesh.position, rotation = mesh.rotation;
+        const float scale = mesh.scale;
+        mesh.position = item.position;
+        mesh.rotation = item.rotation;
+        mesh.scale = item.scale;
+        if (lastItem == NULL || lastItem->mesh != item.mesh || !isTheSameTransform(*lastItem, item))
+            rotatedCamera = setMeshMatrices(mesh);
+        lastItem = &item;
+        color_t color = item.color;
+        drawMaterial(mesh, item.materialIndex, item.texture, &color, rotatedCamera, renderQueue.getBulbs(item), item.bulbsCount);
+        mesh.position = position;
+        mesh.rotation = rotation;
+        mesh.scale = scale;
+    }
+    renderQueue.clear();
+}
+
+/** Calculates model view projection matrix for VU1. Returns camera position in mesh space (without translation) */
+Vector3 Renderer::setMeshMatrices(Mesh &t_mesh)
+{
+    vifSender->calcMatrix(renderData, t_mesh.getModelMatrix());
+    MeshTransform::compose(camRotation, Vector3(), -t_mesh.rotation, 1.0F);
+    return Vector3(camRotation * *renderData.cameraPosition);
+}
+
+void Renderer::drawMaterial(Mesh &t_mesh, const u32 &t_materialIndex, Texture *t_texture, color_t *t_color, Vector3 &t_rotatedCamera, LightBulb *t_bulbs, u16 t_bulbsCount)
+{
+    const u8 isCulledOnVU1 = isBackfaceCullingOnVU1 && t_mesh.shouldBeBackfaceCulled;
+    vifSender->setBackfaceCulling(isCulledOnVU1);
+    if (t_mesh.isStatic())
+    {
+        DisplayList *displayList = getDisplayList(t_mesh, t_materialIndex);
+        TextureCacheEntry *texEntry = changeTexture(t_texture);
+        lod_t lod = t_mesh.lod;
+        setMipmapLOD(lod, t_mesh, texEntry->mipmapsCount);
+        vifSender->drawDisplayList(&renderData, *displayList, texEntry, t_texture->isPaletted() ? &texEntry->clut : &t_mesh.clut, &lod, t_color);
+        return;
+    }
+    if (t_mesh.isAnimatedOnVU1())
+    {
+        // Baked frames can't be culled on EE, so VU1 culls them
+        vifSender->setBackfaceCulling(t_mesh.shouldBeBackfaceCulled);
+        BakedAnimation *animation = getBakedAnimation(t_mesh, t_materialIndex);
+        TextureCacheEntry *texEntry = changeTexture(t_texture);
+        lod_t lod = t_mesh.lod;
+        setMipmapLOD(lod, t_mesh, texEntry->mipmapsCount);
+        vifSender->drawBakedAnimation(&renderData, *animation, t_mesh.getCurrentAnimationFrame(), t_mesh.getNextAnimationFrame(), t_mesh.getAnimationInterpolation(), texEntry, t_texture->isPaletted() ? &texEntry->clut : &t_mesh.clut, &lod, t_color);
+        return;
+    }
+    // Faces of current LOD level, other material data are the same for all levels
+    MeshMaterial *lodMaterial = &t_mesh.getLODMaterial(t_materialIndex);
+    TextureCacheEntry *texEntry = changeTexture(t_texture);
+    lod_t lod = t_mesh.lod;
+    setMipmapLOD(lod, t_mesh, texEntry->mipmapsCount);
+    const Vu1Program program = getProgram(t_mesh, *lodMaterial, t_bulbs != NULL);
+    VECTOR *vertices, *normals, *coordinates;
+    u32 vertCount = 0;
+    // Baked triangles of not animated mesh are sent as they are, when they are not culled on EE
+    if (!(program & VU1_FEATURE_STRIP) && (!t_mesh.shouldBeBackfaceCulled || isCulledOnVU1))
+        vertCount = t_mesh.getBakedDrawData(t_materialIndex, vertices, normals, coordinates);
+    if (vertCount != 0)
+    {
+        vifSender->drawMesh(&renderData, perspective, vertCount, vertices, normals, coordinates, t_mesh, t_bulbs, t_bulbsCount, texEntry, t_texture->isPaletted() ? &texEntry->clut : &t_mesh.clut, &lod, t_color, program);
+        return;
+    }
+    vertCount = lodMaterial->getFacesCount();
+    // In frame chain mode data is referenced by chain, so it have to live until frame is drawn
+    // Otherwise frame arena keeps it until DMA of this frame is finished
+    vertices = frameChain == NULL ? frameArena->allocate<VECTOR>(vertCount * 3) : reinterpret_cast<VECTOR *>(frameChain->allocate(vertCount * 3));
+    normals = vertices + vertCount;
+    coordinates = normals + vertCount;
+    if (program & VU1_FEATURE_STRIP)
+        vertCount = t_mesh.getStripDrawData(t_materialIndex, vertices, normals, coordinates);
+    else
+    {
+        // Triangles culled by VU1 are sent unculled
+        const u8 shouldBeBackfaceCulled = t_mesh.shouldBeBackfaceCulled;
+        t_mesh.shouldBeBackfaceCulled = shouldBeBackfaceCulled && !isCulledOnVU1;
+        vertCount = t_mesh.getDrawData(t_materialIndex, vertices, normals, coordinates, t_rotatedCamera);
+        t_mesh.shouldBeBackfaceCulled = shouldBeBackfaceCulled;
+    }
+    vifSender->drawMesh(&renderData, perspective, vertCount, vertices, normals, coordinates, t_mesh, t_bulbs, t_bulbsCount, texEntry, t_texture->isPaletted() ? &texEntry->clut : &t_mesh.clut, &lod, t_color, program);
+}
+
+void Renderer::bake(Mesh &t_mesh)
+{
+    assertMsg(t_mesh.isStatic() || t_mesh.isAnimatedOnVU1(), "Only static or animated on VU1 mesh can be baked!");
+    for (u32 i = 0; i < t_mesh.getMaterialsCount(); i++)
+        if (t_mesh.isStatic())
+            getDisplayList(t_mesh, i);
+        else
+            getBakedAnimation(t_mesh, i);
+}
+
+/**
+ * Clipping program has no strips and lights, so it is chosen before them.
+ * Quantized program is used only for display lists, it has no strips too.
+ * Triangle strips are used, when material has them and triangles are not culled on EE.
+ * EE backface culling is done per triangle, so strips can't be used with it.
+ * Lit program needs normals, so it is not used for baked meshes.
+ * Materials without texture coordinates get RGBA only variant.
+ */
+Vu1Program Renderer::getProgram(Mesh &t_mesh, MeshMaterial &t_material, const u8 &t_areBulbsSet)
+{
+    const u8 stq = t_material.areSTsPresent() ? VU1_FEATURE_STQ : 0;
+    if (t_mesh.isAnimatedOnVU1())
+        return static_cast<Vu1Program>(VU1_FEATURE_LERP | stq);
+    if (t_mesh.shouldBeClipped)
+        return static_cast<Vu1Program>(VU1_FEATURE_CLIP | stq);
+    if (t_mesh.isQuantized() && t_mesh.isStatic())
+        return static_cast<Vu1Program>(VU1_FEATURE_QUANTIZED | stq);
+    if (t_areBulbsSet && t_mesh.shouldBeLighted && !t_mesh.isStatic())
+        return static_cast<Vu1Program>(VU1_FEATURE_LIT | stq);
+    if (t_material.areStripsPresent() && (!t_mesh.shouldBeBackfaceCulled || t_mesh.isStatic() || isBackfaceCullingOnVU1))
+        return static_cast<Vu1Program>(VU1_FEATURE_STRIP | stq);
+    return static_cast<Vu1Program>(stq);
+}
+
+/** Returns baked data of static mesh material. Bakes it, if it is not baked yet. */
+DisplayList *Renderer::getDisplayList(Mesh &t_mesh, const u32 &t_materialIndex)
+{
+    DisplayList *result = t_mesh.getDisplayList(t_materialIndex);
+    if (result != NULL)
+        return result;
+    MeshMaterial *material = &t_mesh.getLODMaterial(t_materialIndex);
+    u32 vertCount = material->getFacesCount();
+    VECTOR *vertices = new VECTOR[vertCount * 3];
+    VECTOR *normals = vertices + vertCount;
+    VECTOR *coordinates = normals + vertCount;
+    const Vu1Program program = getProgram(t_mesh, *material, false);
+    if (program & VU1_FEATURE_STRIP)
+        vertCount = t_mesh.getStripDrawData(t_materialIndex, vertices, normals, coordinates);
+    else
+    {
+        // Baked data is drawn from any side, so it can't be culled per camera
+        const u8 shouldBeBackfaceCulled = t_mesh.shouldBeBackfaceCulled;
+        t_mesh.shouldBeBackfaceCulled = false;
+        Vector3 noCamera;
+        vertCount = t_mesh.getDrawData(t_materialIndex, vertices, normals, coordinates, noCamera);
+        t_mesh.shouldBeBackfaceCulled = shouldBeBackfaceCulled;
+    }
+    result = vifSender->createDisplayList(vertCount, vertices, coordinates, program);
+    delete[] vertices;
+    t_mesh.setDisplayList(t_materialIndex, result);
+    return result;
+}
+
+/** Returns baked frames of mesh material. Bakes them, if they are not baked yet. */
+BakedAnimation *Renderer::getBakedAnimation(Mesh &t_mesh, const u32 &t_materialIndex)
+{
+    BakedAnimation *result = t_mesh.getBakedAnimation(t_materialIndex);
+    if (result != NULL)
+        return result;
+    MeshMaterial *material = &t_mesh.getLODMaterial(t_materialIndex);
+    result = new BakedAnimation(material->getFacesCount(), t_mesh.getFramesCount(), !material->areSTsPresent());
+    for (u32 i = 0; i < result->getFramesCount(); i++)
+        t_mesh.getFrameDrawData(i, t_materialIndex, result->getFrame(i), i == 0 ? result->getCoordinates() : NULL);
+    t_mesh.setBakedAnimation(t_materialIndex, result);
+    return result;
+}
+
+/**
+ * Sets max mip level and LOD K from mesh distance to camera.
+ * LOD_USE_K: K is mip level used for whole mesh.
+ * LOD_USE_FORMULA: GS calculates level per pixel as log2(1/Q) + K, so K only shifts it.
+ */
+void Renderer::setMipmapLOD(lod_t &o_lod, Mesh &t_mesh, const u8 &t_mipmapsCount)
+{
+    if (!t_mesh.isMipmappingEnabled() || t_mipmapsCount == 0)
+    {
+        o_lod.max_level = 0;
+        return;
+    }
+    o_lod.max_level = t_mipmapsCount;
+    if (o_lod.calculation == LOD_USE_FORMULA)
+        o_lod.k = -Math::log2(t_mesh.getMipmapDistance());
+    else
+    {
+        Vector3 viewPosition = *renderData.view * t_mesh.position;
+        const float squaredDistance = viewPosition.x * viewPosition.x + viewPosition.y * viewPosition.y + viewPosition.z * viewPosition.z;
+        if (squaredDistance <= 0.0F)
+            o_lod.k = 0.0F;
+        else
+            o_lod.k = Math::min(Math::max(0.5F * Math::log2(squaredDistance) - Math::log2(t_mesh.getMipmapDistance()), 0.0F), (float)t_mipmapsCount);
     }
 }
 
@@ -337,25 +692,126 @@ void Renderer::setCameraDefinitions(Matrix *t_worldView, Vector3 *t_cameraPos, P
     renderData.view = t_worldView;
     renderData.cameraPosition = t_cameraPos;
     renderData.frustumPlanes = t_planes;
+    isViewProjectionSet = false;
 }
 
 void Renderer::beginFrameIfNeeded()
 {
+    // Camera is updated between frames, so view projection is calculated once, before first draw
+    if (!isViewProjectionSet)
+    {
+        viewProjection = perspective * *renderData.view;
+        isViewProjectionSet = true;
+    }
     if (isFrameEmpty)
     {
         isFrameEmpty = false;
-        gifSender->sendClear(&zBuffer, &worldColor);
+        if (frameChain != NULL)
+            addClearToFrameChain();
+        else
+            gifSender->sendClear(&zBuffer, &worldColor);
     }
 }
 
 void Renderer::endFrame(float fps)
 {
+    flushRenderQueue();
+    flushSpriteBatch();
+    textureCache.endFrame();
+    vifSender->getProgramManager().endFrame();
+    occlusionCuller->endFrame();
+    frameArena->endFrame();
+    isViewProjectionSet = false;
     if (!isFrameEmpty)
     {
+        if (frameChain != NULL)
+            kickFrameChain(fps);
+        else
+        {
+            if (fps > 49.0F && isVSyncEnabled)
+                graph_wait_vsync();
+            flipBuffers();
+        }
+    }
+}
+
+void Renderer::enableFrameChain()
+{
+    if (frameChain != NULL)
+        return;
+    flushRenderQueue();
+    flushSpriteBatch();
+    frameChain = new FrameChain(FRAME_CHAIN_DEFAULT_CHAIN_SIZE, FRAME_CHAIN_DEFAULT_GIF_SIZE, FRAME_CHAIN_DEFAULT_DATA_SIZE);
+    setFrameChainOfModules(frameChain);
+}
+
+void Renderer::disableFrameChain()
+{
+    if (frameChain == NULL)
+        return;
+    flushRenderQueue();
+    flushSpriteBatch();
+    if (frameChain->isFrameInProgress()) // Last kicked frame was not displayed yet
+    {
+        frameChain->waitForPreviousFrame();
+        displayPreviousFrame();
+    }
+    setFrameChainOfModules(NULL);
+    delete frameChain;
+    frameChain = NULL;
+}
+
+void Renderer::setFrameChainOfModules(FrameChain *t_frameChain)
+{
+    vifSender->setFrameChain(t_frameChain);
+    spriteBatch->setFrameChain(t_frameChain);
+    textureCache.setFrameChain(t_frameChain);
+}
+
+void Renderer::addClearToFrameChain()
+{
+    packet2_t *gif = frameChain->openGif();
+    packet2_update(gif, draw_disable_tests(gif->next, 0, &zBuffer));
+    packet2_update(gif, draw_clear(gif->next, 0,
+                                   SCREEN_CENTER - (screen->width / 2), SCREEN_CENTER - (screen->height / 2),
+                                   screen->width, screen->height,
+                                   worldColor.r, worldColor.g, worldColor.b));
+    packet2_update(gif, draw_enable_tests(gif->next, 0, &zBuffer));
+    frameChain->closeGif();
+}
+
+/**
+ * Adds switch of draw buffer and FINISH to chain.
+ * Waits for previous frame, displays it and kicks current one,
+ * so GS/VU1 draw current frame while EE builds next one.
+ */
+void Renderer::kickFrameChain(float fps)
+{
+    packet2_t *gif = frameChain->openGif();
+    packet2_update(gif, draw_framebuffer(gif->next, 0, &frameBuffers[context ^ 1]));
+    packet2_update(gif, draw_finish(gif->next));
+    frameChain->closeGif();
+    if (frameChain->isFrameInProgress())
+    {
+        frameChain->waitForPreviousFrame();
         if (fps > 49.0F && isVSyncEnabled)
             graph_wait_vsync();
-        flipBuffers();
+        displayPreviousFrame();
     }
+    frameChain->kick();
+    context ^= 1;
+    isFrameEmpty = 1;
+}
+
+/** Previous frame was drawn to the other buffer than current one */
+void Renderer::displayPreviousFrame()
+{
+    graph_set_framebuffer_filtered(
+        frameBuffers[context ^ 1].address,
+        frameBuffers[context ^ 1].width,
+        frameBuffers[context ^ 1].psm,
+        0,
+        0);
 }
 
 /** We need to flip buffers outside of the chain, for some reason,
@@ -0,0 +1,398 @@
+/*
+# ______       ____   ___
+#   |     \/   ____| |___|    
+#   |     |   |   \  |   |       
+#-----------------------------------------------------------------------
+# Copyright 2020, tyra - https://github.com/h4570/tyra
+# Licenced under Apache License 2.0
+# Sandro Sobczyński <sandro.sobczynski@gmail.com>
+*/
+
+#include "../include/modules/scene_tree.hpp"
+#include <algorithm>
+#include "../include/models/mesh.hpp"
+#include "../include/utils/math.hpp"
+#include "../include/utils/debug.hpp"
+
+/** Stack entry of getVisible(): node index and bits of planes, which still have to be tested */
+const u32 SCENE_TREE_ALL_PLANES = 0x3F;
+const u32 SCENE_TREE_MASK_SHIFT = 26;
+const u32 SCENE_TREE_NODE_MASK = (1 << SCENE_TREE_MASK_SHIFT) - 1;
+/** Tree is AVL balanced, so its height is far below this */
+const u32 SCENE_TREE_MAX_STACK = 64;
+
+static inline float absf(const float &t_val) { return t_val < 0.0F ? -t_val : t_val; }
+
+/** Half of surface area, which is enough for comparisons */
+static inline float getArea(const Vector3 &t_min, const Vector3 &t_max)
+{
+    const float x = t_max.x - t_min.x, y = t_max.y - t_min.y, z = t_max.z - t_min.z;
+    return x * y + y * z + z * x;
+}
+
+/** Sorts leaves by center on given axis. Used by rebuild() */
+struct SceneTreeCenterCompare
+{
+    const Vector3 *mins, *maxs;
+    u32 stride;
+    u8 axis;
+    inline float center(const u32 &t_node) const
+    {
+        const float *min = reinterpret_cast<const float *>(reinterpret_cast<const u8 *>(mins) + t_node * stride);
+        const float *max = reinterpret_cast<const float *>(reinterpret_cast<const u8 *>(maxs) + t_node * stride);
+        return min[axis] + max[axis];
+    }
+    inline bool operator()(const u32 &a, const u32 &b) const { return center(a) < center(b); }
+};
+
+// ----
+// Constructors/Destructors
+// ----
+
+SceneTree::SceneTree(const float &t_margin)
+{
+    root = SCENE_TREE_NULL;
+    freeList = SCENE_TREE_NULL;
+    leavesCount = 0;
+    margin = t_margin;
+    stats.nodesVisited = 0;
+    stats.planeTests = 0;
+    stats.reinserts = 0;
+}
+
+SceneTree::~SceneTree() {}
+
+// ----
+// Methods
+// ----
+
+u32 SceneTree::getHeight() const
+{
+    if (root == SCENE_TREE_NULL)
+        return 0;
+    return nodes[root].height + 1;
+}
+
+u32 SceneTree::add(Mesh *t_mesh)
+{
+    Vector3 min, max;
+    getMeshBounds(t_mesh, min, max);
+    return add(t_mesh, min, max);
+}
+
+u32 SceneTree::add(Mesh *t_mesh, const Vector3 &t_min, const Vector3 &t_max)
+{
+    assertMsg(leavesCount < SCENE_TREE_NODE_MASK / 2, "Too many meshes in scene tree!");
+    const u32 leaf = allocateNode();
+    nodes[leaf].mesh = t_mesh;
+    nodes[leaf].height = 0;
+    setFatBox(leaf, t_min, t_max);
+    insertLeaf(leaf);
+    leavesCount++;
+    return leaf;
+}
+
+void SceneTree::remove(const u32 &t_proxy)
+{
+    assertMsg(t_proxy < nodes.size() && nodes[t_proxy].height == 0, "Wrong scene tree proxy!");
+    removeLeaf(t_proxy);
+    freeNode(t_proxy);
+    leavesCount--;
+}
+
+u8 SceneTree::update(const u32 &t_proxy)
+{
+    Vector3 min, max;
+    getMeshBounds(nodes[t_proxy].mesh, min, max);
+    return update(t_proxy, min, max);
+}
+
+u8 SceneTree::update(const u32 &t_proxy, const Vector3 &t_min, const Vector3 &t_max)
+{
+    Node &leaf = nodes[t_proxy];
+    if (leaf.min.x <= t_min.x && leaf.min.y <= t_min.y && leaf.min.z <= t_min.z &&
+        leaf.max.x >= t_max.x && leaf.max.y >= t_max.y && leaf.max.z >= t_max.z)
+        return false;
+    removeLeaf(t_proxy);
+    setFatBox(t_proxy, t_min, t_max);
+    insertLeaf(t_proxy);
+    stats.reinserts++;
+    return true;
+}
+
+void SceneTree::updateAll()
+{
+    for (u32 i = 0; i < nodes.size(); i++)
+        if (nodes[i].height == 0)
+            update(i);
+}
+
+void SceneTree::rebuild()
+{
+    if (leavesCount < 3)
+        return;
+    rebuildLeaves.clear();
+    for (u32 i = 0; i < nodes.size(); i++)
+    {
+        if (nodes[i].height == 0)
+            rebuildLeaves.push_back(i);
+        else if (nodes[i].height != SCENE_TREE_NULL)
+            freeNode(i);
+    }
+    root = buildTopDown(0, rebuildLeaves.size());
+    nodes[root].parent = SCENE_TREE_NULL;
+}
+
+u32 SceneTree::getVisible(Plane *t_frustumPlanes, u32 *o_proxies, const u32 &t_max)
+{
+    stats.nodesVisited = 0;
+    stats.planeTests = 0;
+    if (root == SCENE_TREE_NULL || t_max == 0)
+        return 0;
+    // Every level adds at most one pending node, so height is enough
+    assertMsg(nodes[root].height + 2 <= SCENE_TREE_MAX_STACK, "Scene tree is too high!");
+    u32 stack[SCENE_TREE_MAX_STACK];
+    u32 stackCount = 0, result = 0;
+    stack[stackCount++] = root | (SCENE_TREE_ALL_PLANES << SCENE_TREE_MASK_SHIFT);
+    while (stackCount > 0)
+    {
+        const u32 entry = stack[--stackCount];
+        const Node &node = nodes[entry & SCENE_TREE_NODE_MASK];
+        u32 mask = entry >> SCENE_TREE_MASK_SHIFT;
+        stats.nodesVisited++;
+        if (mask != 0)
+        {
+            const float cx = (node.min.x + node.max.x) * 0.5F, cy = (node.min.y + node.max.y) * 0.5F, cz = (node.min.z + node.max.z) * 0.5F;
+            const float ex = (node.max.x - node.min.x) * 0.5F, ey = (node.max.y - node.min.y) * 0.5F, ez = (node.max.z - node.min.z) * 0.5F;
+            u8 isOutside = false;
+            for (u8 i = 0; i < 6; i++)
+            {
+                if (!(mask & (1 << i)))
+                    continue;
+                const Plane &plane = t_frustumPlanes[i];
+                const float distance = plane.distance + plane.normal.x * cx + plane.normal.y * cy + plane.normal.z * cz;
+                const float radius = absf(plane.normal.x) * ex + absf(plane.normal.y) * ey + absf(plane.normal.z) * ez;
+                stats.planeTests++;
+                if (distance < -radius)
+                {
+                    isOutside = true;
+                    break;
+                }
+                if (distance >= radius) // Whole box is inside, so children also
+                    mask &= ~(1 << i);
+            }
+            if (isOutside)
+                continue;
+        }
+        if (node.isLeaf())
+        {
+            o_proxies[result++] = entry & SCENE_TREE_NODE_MASK;
+            if (result == t_max)
+                break;
+            continue;
+        }
+        stack[stackCount++] = node.right | (mask << SCENE_TREE_MASK_SHIFT);
+        stack[stackCount++] = node.left | (mask << SCENE_TREE_MASK_SHIFT);
+    }
+    return result;
+}
+
+u32 SceneTree::allocateNode()
+{
+    u32 result;
+    if (freeList != SCENE_TREE_NULL)
+    {
+        result = freeList;
+        freeList = nodes[result].parent;
+    }
+    else
+    {
+        result = nodes.size();
+        nodes.push_back(Node());
+    }
+    Node &node = nodes[result];
+    node.mesh = NULL;
+    node.parent = SCENE_TREE_NULL;
+    node.left = SCENE_TREE_NULL;
+    node.right = SCENE_TREE_NULL;
+    node.height = 0;
+    return result;
+}
+
+void SceneTree::freeNode(const u32 &t_node)
+{
+    nodes[t_node].parent = freeList;
+    nodes[t_node].height = SCENE_TREE_NULL;
+    nodes[t_node].mesh = NULL;
+    freeList = t_node;
+}
+
+/** Finds sibling with the lowest cost (surface area heuristic) and creates new parent for both */
+void SceneTree::insertLeaf(const u32 &t_leaf)
+{
+    if (root == SCENE_TREE_NULL)
+    {
+        root = t_leaf;
+        nodes[root].parent = SCENE_TREE_NULL;
+        return;
+    }
+    const Vector3 leafMin = nodes[t_leaf].min, leafMax = nodes[t_leaf].max;
+    u32 sibling = root;
+    while (!nodes[sibling].isLeaf())
+    {
+        const Node &node = nodes[sibling];
+        const float area = getArea(node.min, node.max);
+        Vector3 min(Math::min(node.min.x, leafMin.x), Math::min(node.min.y, leafMin.y), Math::min(node.min.z, leafMin.z));
+        Vector3 max(Math::max(node.max.x, leafMax.x), Math::max(node.max.y, leafMax.y), Math::max(node.max.z, leafMax.z));
+        const float combinedArea = getArea(min, max);
+        // Cost of new parent here and increase of ancestors
+        const float cost = 2.0F * combinedArea;
+        const float inheritanceCost = 2.0F * (combinedArea - area);
+        float childCosts[2];
+        const u32 children[2] = {node.left, node.right};
+        for (u8 i = 0; i < 2; i++)
+        {
+            const Node &child = nodes[children[i]];
+            min.set(Math::min(child.min.x, leafMin.x), Math::min(child.min.y, leafMin.y), Math::min(child.min.z, leafMin.z));
+            max.set(Math::max(child.max.x, leafMax.x), Math::max(child.max.y, leafMax.y), Math::max(child.max.z, leafMax.z));
+            childCosts[i] = getArea(min, max) + inheritanceCost;
+            if (!child.isLeaf())
+                childCosts[i] -= getArea(child.min, child.max);
+        }
+        if (cost < childCosts[0] && cost < childCosts[1])
+            break;
+        sibling = childCosts[0] < childCosts[1] ? node.left : node.right;
+    }
+
+    const u32 oldParent = nodes[sibling].parent;
+    const u32 newParent = allocateNode();
+    nodes[newParent].parent = oldParent;
+    nodes[newParent].left = sibling;
+    nodes[newParent].right = t_leaf;
+    nodes[sibling].parent = newParent;
+    nodes[t_leaf].parent = newParent;
+    if (oldParent == SCENE_TREE_NULL)
+        root = newParent;
+    else if (nodes[oldParent].left == sibling)
+        nodes[oldParent].left = newParent;
+    else
+        nodes[oldParent].right = newParent;
+    refit(newParent);
+}
+
+void SceneTree::removeLeaf(const u32 &t_leaf)
+{
+    if (t_leaf == root)
+    {
+        root = SCENE_TREE_NULL;
+        return;
+    }
+    const u32 parent = nodes[t_leaf].parent;
+    const u32 grandParent = nodes[parent].parent;
+    const u32 sibling = nodes[parent].left == t_leaf ? nodes[parent].right : nodes[parent].left;
+    freeNode(parent);
+    nodes[sibling].parent = grandParent;
+    if (grandParent == SCENE_TREE_NULL)
+    {
+        root = sibling;
+        return;
+    }
+    if (nodes[grandParent].left == parent)
+        nodes[grandParent].left = sibling;
+    else
+        nodes[grandParent].right = sibling;
+    refit(grandParent);
+}
+
+/** Recalculates boxes and heights from node to root. Rotates unbalanced nodes */
+void SceneTree::refit(u32 t_node)
+{
+    while (t_node != SCENE_TREE_NULL)
+    {
+        Node &node = nodes[t_node];
+        u32 left = node.left, right = node.right;
+        const s32 balance = static_cast<s32>(nodes[right].height) - static_cast<s32>(nodes[left].height);
+        // Rotation: higher child takes place of node, and node takes place of its lower grandchild
+        if (balance > 1 || balance < -1)
+        {
+            const u32 high = balance > 1 ? right : left;
+            const u32 low = balance > 1 ? left : right;
+            Node &highNode = nodes[high];
+            const u32 a = highNode.left, b = highNode.right;
+            const u32 keep = nodes[a].height > nodes[b].height ? a : b;
+            const u32 move = keep == a ? b : a;
+            // high goes up
+            highNode.parent = node.parent;
+            if (node.parent == SCENE_TREE_NULL)
+                root = high;
+            else if (nodes[node.parent].left == t_node)
+                nodes[node.parent].left = high;
+            else
+                nodes[node.parent].right = high;
+            highNode.left = t_node;
+            highNode.right = keep;
+            node.parent = high;
+            // node keeps lower child and lower grandchild
+            node.left = low;
+            node.right = move;
+            nodes[move].parent = t_node;
+            left = low;
+            right = move;
+        }
+        const Node &l = nodes[left], &r = nodes[right];
+        node.min.set(Math::min(l.min.x, r.min.x), Math::min(l.min.y, r.min.y), Math::min(l.min.z, r.min.z));
+        node.max.set(Math::max(l.max.x, r.max.x), Math::max(l.max.y, r.max.y), Math::max(l.max.z, r.max.z));
+        node.height = 1 + Math::max(l.height, r.height);
+        // After rotation node is child of its old child, which also needs refit
+        t_node = node.parent;
+    }
+}
+
+u32 SceneTree::buildTopDown(const u32 &t_begin, const u32 &t_end)
+{
+    if (t_end - t_begin == 1)
+        return rebuildLeaves[t_begin];
+    Vector3 min = nodes[rebuildLeaves[t_begin]].min + nodes[rebuildLeaves[t_begin]].max, max = min;
+    for (u32 i = t_begin + 1; i < t_end; i++)
+    {
+        const Vector3 center = nodes[rebuildLeaves[i]].min + nodes[rebuildLeaves[i]].max;
+        min.set(Math::min(min.x, center.x), Math::min(min.y, center.y), Math::min(min.z, center.z));
+        max.set(Math::max(max.x, center.x), Math::max(max.y, center.y), Math::max(max.z, center.z));
+    }
+    const Vector3 size = max - min;
+    SceneTreeCenterCompare compare;
+    compare.mins = &nodes[0].min;
+    compare.maxs = &nodes[0].max;
+    compare.stride = sizeof(Node);
+    compare.axis = size.x > size.y ? (size.x > size.z ? 0 : 2) : (size.y > size.z ? 1 : 2);
+    const u32 middle = (t_begin + t_end) / 2;
+    std::nth_element(rebuildLeaves.begin() + t_begin, rebuildLeaves.begin() + middle, rebuildLeaves.begin() + t_end, compare);
+
+    const u32 left = buildTopDown(t_begin, middle);
+    const u32 right = buildTopDown(middle, t_end);
+    const u32 result = allocateNode();
+    Node &node = nodes[result];
+    const Node &l = nodes[left], &r = nodes[right];
+    node.left = left;
+    node.right = right;
+    node.min.set(Math::min(l.min.x, r.min.x), Math::min(l.min.y, r.min.y), Math::min(l.min.z, r.min.z));
+    node.max.set(Math::max(l.max.x, r.max.x), Math::max(l.max.y, r.max.y), Math::max(l.max.z, r.max.z));
+    node.height = 1 + Math::max(l.height, r.height);
+    nodes[left].parent = result;
+    nodes[right].parent = result;
+    return result;
+}
+
+/** Sphere around mesh origin, which contains current bounding box in any rotation */
+void SceneTree::getMeshBounds(Mesh *t_mesh, Vector3 &o_min, Vector3 &o_max) const
+{
+    const float radius = t_mesh->getCurrentBoundingRadius();
+    o_min.set(t_mesh->position.x - radius, t_mesh->position.y - radius, t_mesh->position.z - radius);
+    o_max.set(t_mesh->position.x + radius, t_mesh->position.y + radius, t_mesh->position.z + radius);
+}
+
+void SceneTree::setFatBox(const u32 &t_leaf, const Vector3 &t_min, const Vector3 &t_max)
+{
+    nodes[t_leaf].min.set(t_min.x - margin, t_min.y - margin, t_min.z - margin);
+    nodes[t_leaf].max.set(t_max.x + margin, t_max.y + margin, t_max.z + margin);
+}
@@ -0,0 +1,206 @@
+/*
+# ______       ____   ___
+#   |     \/   ____| |___|    
+#   |     |   |   \  |   |       
+#-----------------------------------------------------------------------
+# Copyright 2020, tyra - https://github.com/h4570/tyra
+# Licenced under Apache License 2.0
+# Sandro Sobczyński <sandro.sobczynski@gmail.com>
+*/
+
+#include "../include/modules/sprite_batch.hpp"
+
+#include <dma.h>
+#include <draw.h>
+#include <packet2_utils.h>
+#include <algorithm>
+#include "../include/utils/debug.hpp"
+
+const float SPRITE_BATCH_SCREEN_CENTER = 2048.0F;
+const u32 SPRITE_BATCH_PACKET_SIZE = 1024;
+/** draw_rect_textured() takes 5 qwords */
+const u32 SPRITE_BATCH_RECT_SIZE = 6;
+/** GIF tag + TEX0 */
+const u32 SPRITE_BATCH_TEXTURE_SIZE = 2;
+/** XY offset restore + FINISH */
+const u32 SPRITE_BATCH_END_SIZE = 4;
+
+static bool compareByTexture(const SpriteBatchItem &a, const SpriteBatchItem &b)
+{
+    return a.texture->getId() < b.texture->getId();
+}
+
+// ----
+// Constructors/Destructors
+// ----
+
+SpriteBatch::SpriteBatch(ScreenSettings *t_screen) : screen(t_screen)
+{
+    packets[0] = packet2_create(SPRITE_BATCH_PACKET_SIZE, P2_TYPE_NORMAL, P2_MODE_NORMAL, 0);
+    packets[1] = packet2_create(SPRITE_BATCH_PACKET_SIZE, P2_TYPE_NORMAL, P2_MODE_NORMAL, 0);
+    packet = packets[0];
+    frameChain = NULL;
+    context = 0;
+    stats.sprites = 0;
+    stats.textureChanges = 0;
+    stats.packets = 0;
+}
+
+SpriteBatch::~SpriteBatch()
+{
+    dma_channel_wait(DMA_CHANNEL_GIF, 0);
+    packet2_free(packets[0]);
+    packet2_free(packets[1]);
+}
+
+// ----
+// Methods
+// ----
+
+void SpriteBatch::getRect(Sprite &t_sprite, Texture &t_texture, texrect_t &o_rect)
+{
+    float sizeX, sizeY;
+    if (t_sprite.getMode() == MODE_REPEAT)
+    {
+        sizeX = t_sprite.size.x;
+        sizeY = t_sprite.size.y;
+    }
+    else
+    {
+        sizeX = (float)t_texture.getWidth();
+        sizeY = (float)t_texture.getHeight();
+    }
+
+    float texS, texT;
+    float texMax = texT = texS = sizeX > sizeY ? sizeX : sizeY;
+    if (sizeX > sizeY)
+        texT = texMax / (sizeX / sizeY);
+    else if (sizeY > sizeX)
+        texS = texMax / (sizeY / sizeX);
+    o_rect.t0.s = t_sprite.isFlippedHorizontally() ? texS : 0.0F;
+    o_rect.t0.t = t_sprite.isFlippedVertically() ? texT : 0.0F;
+    o_rect.t1.s = t_sprite.isFlippedHorizontally() ? 0.0F : texS;
+    o_rect.t1.t = t_sprite.isFlippedVertically() ? 0.0F : texT;
+    o_rect.color.r = t_sprite.color.r;
+    o_rect.color.g = t_sprite.color.g;
+    o_rect.color.b = t_sprite.color.b;
+    o_rect.color.a = t_sprite.color.a;
+    o_rect.color.q = 0;
+    o_rect.v0.x = t_sprite.position.x;
+    o_rect.v0.y = t_sprite.position.y;
+    o_rect.v0.z = (u32)-1;
+    o_rect.v1.x = (t_sprite.size.x * t_sprite.scale) + t_sprite.position.x;
+    o_rect.v1.y = (t_sprite.size.y * t_sprite.scale) + t_sprite.position.y;
+    o_rect.v1.z = (u32)-1;
+}
+
+void SpriteBatch::add(Sprite &t_sprite, Texture &t_texture)
+{
+    SpriteBatchItem item;
+    getRect(t_sprite, t_texture, item.rect);
+    item.texture = &t_texture;
+    item.clut = t_sprite.clut;
+    items.push_back(item);
+}
+
+void SpriteBatch::flush(TextureCache &t_textureCache)
+{
+    stats.sprites = items.size();
+    stats.textureChanges = 0;
+    stats.packets = 0;
+    if (items.size() == 0)
+        return;
+    std::stable_sort(items.begin(), items.end(), compareByTexture);
+    Texture *lastTexture = NULL;
+    TextureCacheEntry *entry = NULL;
+    u8 isPacketOpened = false;
+    for (u32 i = 0; i < items.size(); i++)
+    {
+        Texture *texture = items[i].texture;
+        if (texture != lastTexture)
+        {
+            // Sprites in packet must be drawn before upload, which can evict their textures
+            if (isPacketOpened && !t_textureCache.isResident(texture->getId()))
+            {
+                sendPacket();
+                isPacketOpened = false;
+            }
+            lastTexture = texture;
+            entry = t_textureCache.use(*texture);
+            if (!isPacketOpened)
+            {
+                beginPacket();
+                isPacketOpened = true;
+            }
+            addTexture(*texture, *entry, items[i].clut);
+            stats.textureChanges++;
+        }
+        else if (!hasSpace(SPRITE_BATCH_RECT_SIZE + SPRITE_BATCH_END_SIZE))
+        {
+            sendPacket();
+            beginPacket();
+            addTexture(*texture, *entry, items[i].clut);
+        }
+        packet2_update(packet, draw_rect_textured(packet->next, 0, &items[i].rect));
+    }
+    sendPacket();
+    items.clear();
+}
+
+u8 SpriteBatch::hasSpace(const u32 &t_qwords)
+{
+    if (frameChain == NULL)
+        return packet2_get_qw_count(packet) + t_qwords <= SPRITE_BATCH_PACKET_SIZE;
+    assertMsg(frameChain->getGifSpaceLeft() >= t_qwords, "Frame chain GIF buffer is full!");
+    return true;
+}
+
+void SpriteBatch::beginPacket()
+{
+    if (frameChain != NULL)
+        packet = frameChain->openGif();
+    else
+    {
+        packet = packets[context];
+        packet2_reset(packet, false);
+    }
+    packet2_update(packet, draw_primitive_xyoffset(packet->next, 0, SPRITE_BATCH_SCREEN_CENTER, SPRITE_BATCH_SCREEN_CENTER));
+    draw_enable_blending();
+}
+
+void SpriteBatch::addTexture(Texture &t_texture, TextureCacheEntry &t_entry, clutbuffer_t &t_clut)
+{
+    if (!hasSpace(SPRITE_BATCH_TEXTURE_SIZE + SPRITE_BATCH_RECT_SIZE + SPRITE_BATCH_END_SIZE))
+    {
+        sendPacket();
+        beginPacket();
+    }
+    packet2_utils_gif_add_set(packet, 1);
+    packet2_utils_gs_add_texbuff_clut(packet, &t_entry.buffer, t_texture.isPaletted() ? &t_entry.clut : &t_clut);
+}
+
+/**
+ * Restores XY offset and sends packet without waiting. Next packet is built in second buffer.
+ * In frame chain mode packet is only added to chain.
+ */
+void SpriteBatch::sendPacket()
+{
+    draw_disable_blending();
+    packet2_update(
+        packet,
+        draw_primitive_xyoffset(
+            packet->next,
+            0,
+            SPRITE_BATCH_SCREEN_CENTER - (screen->width / 2.0F),
+            SPRITE_BATCH_SCREEN_CENTER - (screen->height / 2.0F)));
+    stats.packets++;
+    if (frameChain != NULL)
+    {
+        frameChain->closeGif();
+        return;
+    }
+    packet2_update(packet, draw_finish(packet->next));
+    dma_channel_wait(DMA_CHANNEL_GIF, 0);
+    dma_channel_send_packet2(packet, DMA_CHANNEL_GIF, true);
+    context = !context;
+}
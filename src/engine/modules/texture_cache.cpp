@@ -0,0 +1,175 @@
+/*
+# ______       ____   ___
+#   |     \/   ____| |___|    
+#   |     |   |   \  |   |       
+#-----------------------------------------------------------------------
+# Copyright 2020, tyra - https://github.com/h4570/tyra
+# Licenced under Apache License 2.0
+# Sandro Sobczyński <sandro.sobczynski@gmail.com>
+*/
+
+#include "../include/modules/texture_cache.hpp"
+
+#include <graph.h>
+#include <draw.h>
+#include <gs_gp.h>
+#include "../include/utils/debug.hpp"
+
+// ----
+// Constructors/Destructors
+// ----
+
+TextureCache::TextureCache()
+{
+    resetStats(stats);
+    resetStats(lastFrameStats);
+}
+
+TextureCache::~TextureCache() {}
+
+// ----
+// Methods
+// ----
+
+void TextureCache::init(const u32 &t_startAddress, const u32 &t_endAddress)
+{
+    allocator.init(t_startAddress, t_endAddress, GRAPH_ALIGN_BLOCK);
+    entries.clear();
+    consoleLog("Texture cache initialized!");
+}
+
+TextureCacheEntry *TextureCache::use(Texture &t_texture)
+{
+    const u32 missesBefore = stats.misses;
+    TextureCacheEntry *entry = prefetch(t_texture);
+    if (stats.misses == missesBefore)
+        stats.hits++;
+    if (!uploader.isCompleted(entry->uploadBatch))
+    {
+        stats.uploadStalls++;
+        uploader.waitFor(entry->uploadBatch);
+    }
+    return entry;
+}
+
+TextureCacheEntry *TextureCache::prefetch(Texture &t_texture)
+{
+    s32 index = getIndexOfEntry(t_texture.getId());
+    if (index != -1)
+    {
+        allocator.use(t_texture.getId());
+        return &entries[index];
+    }
+    stats.misses++;
+    const u32 textureSize = t_texture.getVramSize(0);
+    u32 size = textureSize;
+    for (u8 i = 1; i <= t_texture.getMipmapsCount(); i++)
+        size += t_texture.getVramSize(i);
+    if (t_texture.isPaletted())
+        size += t_texture.getType() == TEX_TYPE_PALETTE8 ? TEXTURE_CACHE_CLUT8_SIZE : TEXTURE_CACHE_CLUT4_SIZE;
+    s32 address = allocator.allocate(t_texture.getId(), size);
+    assertMsg(address != -1, "Texture is bigger than VRAM left for textures!");
+    // Evicted texture may be still sampled by meshes sent to VU1 in this frame
+    if (allocator.isCurrentFrameSlotEvicted())
+        uploader.waitForVU1BeforeSend();
+    removeEvictedEntries();
+    TextureCacheEntry entry;
+    entry.textureId = t_texture.getId();
+    setBuffer(entry.buffer, t_texture, address);
+    const u32 clutAddress = setMipmaps(entry, t_texture, address + textureSize);
+    setClut(entry.clut, t_texture, clutAddress);
+    entry.uploadBatch = uploader.add(t_texture, entry);
+    entries.push_back(entry);
+    for (u8 i = 0; i <= t_texture.getMipmapsCount(); i++)
+        stats.uploadedBytes += t_texture.getMipmapDataSize(i);
+    stats.uploadedBytes += t_texture.getClutSize();
+    return &entries.back();
+}
+
+void TextureCache::invalidate(const u32 &t_textureId)
+{
+    s32 index = getIndexOfEntry(t_textureId);
+    if (index == -1)
+        return;
+    // Texture data can be freed after this call, so DMA can't read it anymore
+    uploader.waitFor(entries[index].uploadBatch);
+    allocator.release(t_textureId);
+    entries.erase(entries.begin() + index);
+}
+
+void TextureCache::endFrame()
+{
+    uploader.endFrame();
+    lastFrameStats = stats;
+    resetStats(stats);
+    allocator.nextFrame();
+}
+
+void TextureCache::removeEvictedEntries()
+{
+    const std::vector<u32> &evicted = allocator.getEvictedKeys();
+    for (u32 i = 0; i < evicted.size(); i++)
+    {
+        s32 index = getIndexOfEntry(evicted[i]);
+        if (index != -1)
+            entries.erase(entries.begin() + index);
+    }
+    stats.evictions += evicted.size();
+}
+
+void TextureCache::setBuffer(texbuffer_t &t_buffer, Texture &t_texture, const u32 &t_address)
+{
+    t_buffer.width = t_texture.getBufferWidth(0);
+    t_buffer.psm = t_texture.getType();
+    t_buffer.address = t_address;
+    // Palette colors are RGBA
+    t_buffer.info.components = t_buffer.psm == TEX_TYPE_RGB ? TEXTURE_COMPONENTS_RGB : TEXTURE_COMPONENTS_RGBA;
+    t_buffer.info.width = draw_log2(t_texture.getWidth());
+    t_buffer.info.height = draw_log2(t_texture.getHeight());
+    t_buffer.info.function = TEXTURE_FUNCTION_MODULATE;
+}
+
+/** Places mip levels one after another. Returns first address after them */
+u32 TextureCache::setMipmaps(TextureCacheEntry &t_entry, Texture &t_texture, const u32 &t_address)
+{
+    u32 address = t_address;
+    t_entry.mipmapsCount = t_texture.getMipmapsCount();
+    for (u8 i = 0; i < TEXTURE_MAX_MIPMAPS; i++)
+    {
+        if (i < t_entry.mipmapsCount)
+        {
+            t_entry.mipmapAddresses[i] = address;
+            t_entry.mipmapWidths[i] = t_texture.getBufferWidth(i + 1);
+            address += t_texture.getVramSize(i + 1);
+        }
+        else // Unused levels point to base texture
+        {
+            t_entry.mipmapAddresses[i] = t_entry.buffer.address;
+            t_entry.mipmapWidths[i] = t_entry.buffer.width;
+        }
+    }
+    // TBP in 64 words units, TBW in 64 pixels units
+    const u32 *addresses = t_entry.mipmapAddresses;
+    const u32 *widths = t_entry.mipmapWidths;
+    t_entry.miptbp1 = GS_SET_MIPTBP1(addresses[0] >> 6, widths[0] >> 6, addresses[1] >> 6, widths[1] >> 6, addresses[2] >> 6, widths[2] >> 6);
+    t_entry.miptbp2 = GS_SET_MIPTBP2(addresses[3] >> 6, widths[3] >> 6, addresses[4] >> 6, widths[4] >> 6, addresses[5] >> 6, widths[5] >> 6);
+    return address;
+}
+
+void TextureCache::setClut(clutbuffer_t &t_clut, Texture &t_texture, const u32 &t_address)
+{
+    t_clut.address = t_address;
+    t_clut.psm = GS_PSM_32;
+    t_clut.storage_mode = CLUT_STORAGE_MODE1;
+    t_clut.start = 0;
+    t_clut.load_method = t_texture.isPaletted() ? CLUT_LOAD : CLUT_NO_LOAD;
+}
+
+void TextureCache::resetStats(TextureCacheStats &t_stats)
+{
+    t_stats.hits = 0;
+    t_stats.misses = 0;
+    t_stats.evictions = 0;
+    t_stats.uploadedBytes = 0;
+    t_stats.uploadStalls = 0;
+}
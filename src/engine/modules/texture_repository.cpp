@@ -43,6 +43,7 @@ Texture *TextureRepository::add(char *t_subfolder, char *t_name, TextureFormat t
     else
         pngLoader.load(*texture, t_subfolder, t_name, ".png");
     texture->setName(t_name);
+    texture->setRepository(this);
     textures.push_back(texture);
     return texture;
 }
@@ -56,8 +57,42 @@ void TextureRepository::addByMesh(char *t_path, Mesh &mesh, TextureFormat t_form
             bmpLoader.load(*texture, t_path, mesh.getMaterial(i).getName(), ".bmp");
         else
             pngLoader.load(*texture, t_path, mesh.getMaterial(i).getName(), ".png");
+        if (mesh.isMipmappingEnabled())
+            texture->generateMipmaps();
         texture->setName(mesh.getMaterial(i).getName());
+        texture->setRepository(this);
         texture->addLink(mesh.getMaterial(i).getId());
         textures.push_back(texture);
     }
 }
+
+void TextureRepository::link(const u32 &t_id, Texture *t_texture)
+{
+    const HandleType type = Handle::getType(t_id);
+    assertMsg(type != HANDLE_TYPE_NONE && type < HANDLE_TYPES_COUNT, "Texture can be linked only with sprite or mesh material handle!");
+    std::vector<TextureRepositoryLink> &table = links[type];
+    const u16 index = Handle::getIndex(t_id);
+    if (index >= table.size())
+    {
+        TextureRepositoryLink empty;
+        empty.id = HANDLE_NONE;
+        empty.texture = NULL;
+        table.resize(index + 1, empty);
+    }
+    table[index].id = t_id;
+    table[index].texture = t_texture;
+}
+
+void TextureRepository::unlink(const u32 &t_id, Texture *t_texture)
+{
+    const HandleType type = Handle::getType(t_id);
+    if (type >= HANDLE_TYPES_COUNT)
+        return;
+    std::vector<TextureRepositoryLink> &table = links[type];
+    const u16 index = Handle::getIndex(t_id);
+    if (index < table.size() && table[index].id == t_id && table[index].texture == t_texture)
+    {
+        table[index].id = HANDLE_NONE;
+        table[index].texture = NULL;
+    }
+}
@@ -0,0 +1,249 @@
+/*
+# ______       ____   ___
+#   |     \/   ____| |___|    
+#   |     |   |   \  |   |       
+#-----------------------------------------------------------------------
+# Copyright 2020, tyra - https://github.com/h4570/tyra
+# Licenced under Apache License 2.0
+# Sandro Sobczyński <sandro.sobczynski@gmail.com>
+*/
+
+#include "../include/modules/texture_uploader.hpp"
+
+#include <packet2_chain.h>
+#include <dma.h>
+#include <draw.h>
+#include <gs_psm.h>
+#include <gs_gp.h>
+#include <gif_tags.h>
+#include "../include/modules/texture_cache.hpp"
+#include "../include/utils/debug.hpp"
+
+const u32 TEXTURE_UPLOADER_PACKET_SIZE = 1024;
+/** CLUT + 7 levels, max 12 qwords per draw_texture_transfer(), + wrapping */
+const u32 TEXTURE_UPLOADER_MAX_TEXTURE_SIZE = 12 * (TEXTURE_MAX_MIPMAPS + 2) + 4;
+/** TEXFLUSH + END tag */
+const u32 TEXTURE_UPLOADER_FLUSH_SIZE = 3;
+/** Max NLOOP of IMAGE GIF tag */
+const u32 TEXTURE_UPLOADER_MAX_IMAGE_SIZE = 32767;
+
+// ----
+// Constructors/Destructors
+// ----
+
+TextureUploader::TextureUploader()
+{
+    packets[0] = packet2_create(TEXTURE_UPLOADER_PACKET_SIZE, P2_TYPE_NORMAL, P2_MODE_CHAIN, false);
+    packets[1] = packet2_create(TEXTURE_UPLOADER_PACKET_SIZE, P2_TYPE_NORMAL, P2_MODE_CHAIN, false);
+    frameChain = NULL;
+    context = 0;
+    _isVU1WaitNeeded = false;
+    currentBatch = 1;
+    sentBatch = 0;
+    completedBatch = 0;
+    pendingCount = 0;
+    resetStats(stats);
+    resetStats(lastFrameStats);
+}
+
+TextureUploader::~TextureUploader()
+{
+    waitForAll();
+    packet2_free(packets[0]);
+    packet2_free(packets[1]);
+}
+
+// ----
+// Methods
+// ----
+
+u32 TextureUploader::add(Texture &t_texture, const TextureCacheEntry &t_entry)
+{
+    if (frameChain != NULL)
+    {
+        addToFrameChain(t_texture, t_entry);
+        stats.uploads++;
+        return completedBatch;
+    }
+    packet2_t *packet = packets[context];
+    if (packet2_get_qw_count(packet) + TEXTURE_UPLOADER_MAX_TEXTURE_SIZE + TEXTURE_UPLOADER_FLUSH_SIZE > TEXTURE_UPLOADER_PACKET_SIZE)
+    {
+        flush();
+        packet = packets[context];
+    }
+    if (t_texture.isPaletted()) // CLUT as PSMCT32 image, 16x16 for 8bit, 8x2 for 4bit
+        packet2_update(
+            packet,
+            draw_texture_transfer(
+                packet->next,
+                t_texture.getClut(),
+                t_texture.getType() == TEX_TYPE_PALETTE8 ? 16 : 8,
+                t_texture.getType() == TEX_TYPE_PALETTE8 ? 16 : 2,
+                GS_PSM_32,
+                t_entry.clut.address,
+                64));
+    packet2_update(
+        packet,
+        draw_texture_transfer(
+            packet->next,
+            t_texture.getData(),
+            t_texture.getWidth(),
+            t_texture.getHeight(),
+            t_texture.getType(),
+            t_entry.buffer.address,
+            t_entry.buffer.width));
+    for (u8 i = 0; i < t_entry.mipmapsCount; i++)
+        packet2_update(
+            packet,
+            draw_texture_transfer(
+                packet->next,
+                t_texture.getMipmapData(i + 1),
+                t_texture.getMipmapWidth(i + 1),
+                t_texture.getMipmapHeight(i + 1),
+                t_texture.getType(),
+                t_entry.mipmapAddresses[i],
+                t_entry.mipmapWidths[i]));
+    packet2_chain_open_cnt(packet, 0, 0, 0);
+    packet2_update(packet, draw_texture_wrapping(packet->next, 0, t_texture.getWrapSettings()));
+    packet2_chain_close_tag(packet);
+    pendingCount++;
+    stats.uploads++;
+    return currentBatch;
+}
+
+void TextureUploader::flush()
+{
+    if (pendingCount == 0)
+        return;
+    packet2_t *packet = packets[context];
+    // GS texture cache have to be flushed, before new texels are sampled
+    packet2_update(packet, draw_texture_flush(packet->next));
+    // Only one transfer at once per channel. Usually it is already done, because VU1 was drawing meanwhile
+    dma_channel_wait(DMA_CHANNEL_GIF, 0);
+    completedBatch = sentBatch;
+    if (_isVU1WaitNeeded)
+    {
+        waitForVU1();
+        _isVU1WaitNeeded = false;
+    }
+    dma_channel_send_packet2(packet, DMA_CHANNEL_GIF, true);
+    sentBatch = currentBatch++;
+    pendingCount = 0;
+    stats.batches++;
+    context = !context;
+    packet2_reset(packets[context], false);
+}
+
+void TextureUploader::waitFor(const u32 &t_batch)
+{
+    if (frameChain != NULL)
+        return;
+    updateCompletedBatch();
+    // Nothing was added to current batch, so there is nothing to send or wait for
+    if (isCompleted(t_batch) || (t_batch == currentBatch && pendingCount == 0))
+        return;
+    if (t_batch == currentBatch)
+        flush();
+    stats.stalls++;
+    dma_channel_wait(DMA_CHANNEL_GIF, 0);
+    completedBatch = sentBatch;
+}
+
+void TextureUploader::waitForAll()
+{
+    waitFor(currentBatch);
+    waitFor(sentBatch);
+}
+
+/** Marks sent batch as completed, if its DMA transfer already ended. Does not wait */
+void TextureUploader::updateCompletedBatch()
+{
+    // Timeout of 1 checks channel once
+    if (dma_channel_wait(DMA_CHANNEL_GIF, 1) == 0)
+        completedBatch = sentBatch;
+}
+
+void TextureUploader::setFrameChain(FrameChain *t_frameChain)
+{
+    waitForAll();
+    frameChain = t_frameChain;
+}
+
+/** CLUT, base and mip levels are added as image transfers, followed by wrap settings and TEXFLUSH */
+void TextureUploader::addToFrameChain(Texture &t_texture, const TextureCacheEntry &t_entry)
+{
+    if (t_texture.isPaletted())
+        addImageToFrameChain(
+            t_texture.getClut(),
+            t_texture.getClutSize(),
+            t_texture.getType() == TEX_TYPE_PALETTE8 ? 16 : 8,
+            t_texture.getType() == TEX_TYPE_PALETTE8 ? 16 : 2,
+            GS_PSM_32,
+            t_entry.clut.address,
+            64);
+    addImageToFrameChain(t_texture.getData(), t_texture.getDataSize(), t_texture.getWidth(), t_texture.getHeight(), t_texture.getType(), t_entry.buffer.address, t_entry.buffer.width);
+    for (u8 i = 0; i < t_entry.mipmapsCount; i++)
+        addImageToFrameChain(
+            t_texture.getMipmapData(i + 1),
+            t_texture.getMipmapDataSize(i + 1),
+            t_texture.getMipmapWidth(i + 1),
+            t_texture.getMipmapHeight(i + 1),
+            t_texture.getType(),
+            t_entry.mipmapAddresses[i],
+            t_entry.mipmapWidths[i]);
+    packet2_t *gif = frameChain->openGif();
+    packet2_update(gif, draw_texture_wrapping(gif->next, 0, t_texture.getWrapSettings()));
+    packet2_add_2x_s64(gif, GIF_SET_TAG(1, 1, 0, 0, GIF_FLG_PACKED, 1), GIF_REG_AD);
+    packet2_add_2x_s64(gif, 1, GS_REG_TEXFLUSH);
+    frameChain->closeGif();
+}
+
+/** Same registers as draw_texture_transfer(), but without DMA tags, because data goes via VIF1 DIRECT */
+void TextureUploader::addImageToFrameChain(const void *t_data, const u32 &t_size, const u16 &t_width, const u16 &t_height, const u32 &t_psm, const u32 &t_address, const u32 &t_bufferWidth)
+{
+    packet2_t *gif = frameChain->openGif();
+    packet2_add_2x_s64(gif, GIF_SET_TAG(4, 1, 0, 0, GIF_FLG_PACKED, 1), GIF_REG_AD);
+    packet2_add_2x_s64(gif, GS_SET_BITBLTBUF(0, 0, 0, t_address >> 6, t_bufferWidth >> 6, t_psm), GS_REG_BITBLTBUF);
+    packet2_add_2x_s64(gif, GS_SET_TRXPOS(0, 0, 0, 0, 0), GS_REG_TRXPOS);
+    packet2_add_2x_s64(gif, GS_SET_TRXREG(t_width, t_height), GS_REG_TRXREG);
+    packet2_add_2x_s64(gif, GS_SET_TRXDIR(0), GS_REG_TRXDIR);
+    frameChain->closeGif();
+    const u8 *data = static_cast<const u8 *>(t_data);
+    u32 qwordsLeft = (t_size + 15) / 16;
+    while (qwordsLeft > 0)
+    {
+        const u32 qwords = qwordsLeft > TEXTURE_UPLOADER_MAX_IMAGE_SIZE ? TEXTURE_UPLOADER_MAX_IMAGE_SIZE : qwordsLeft;
+        gif = frameChain->openGif();
+        packet2_add_2x_s64(gif, GIF_SET_TAG(qwords, 1, 0, 0, GIF_FLG_IMAGE, 0), 0);
+        frameChain->closeGif();
+        frameChain->addGifData(data, qwords);
+        data += qwords * 16;
+        qwordsLeft -= qwords;
+    }
+}
+
+void TextureUploader::endFrame()
+{
+    waitFor(currentBatch);
+    lastFrameStats = stats;
+    resetStats(stats);
+}
+
+/** Waits for VIF1 DMA, then polls VPU-STAT until VU1 program ends (VBS1 bit) */
+void TextureUploader::waitForVU1()
+{
+    dma_channel_wait(DMA_CHANNEL_VIF1, 0);
+    u32 status;
+    do
+    {
+        asm volatile("cfc2 %0, $vi29"
+                     : "=r"(status));
+    } while (status & 0x100);
+}
+
+void TextureUploader::resetStats(TextureUploaderStats &t_stats)
+{
+    t_stats.uploads = 0;
+    t_stats.batches = 0;
+    t_stats.stalls = 0;
+}
@@ -13,33 +13,59 @@
 #include <gs_gp.h>
 #include <dma.h>
 #include <gif_tags.h>
+#include <cstring>
 #include "../include/utils/math.hpp"
 #include "../include/utils/debug.hpp"
+#include "../include/utils/vertex_quantizer.hpp"
 
-const u32 VU1_PACKAGE_VERTS_PER_BUFF = 96; // Remember to modify buffer size in vu1 also
 const u32 VU1_PACKAGES_PER_PACKET = 9;
 const u32 VU1_PACKET_SIZE = 256; // should be 128, but 256 is more safe for future
 const u8 VU1_PARAMS_ADDRESS = 4;
-const u8 VU1_RGBA_ADDRESS = 8;
+/** Params "x" bits */
+const u32 VU1_FLAG_DRAW_FINISH = 1;
+/** MAC sign flags of winding, x = triangle (or even strip triangle), y = odd strip triangle */
+const u32 VU1_FLAG_BACKFACE_CULLING = 0xC0;
+const u8 VU1_RGBA_ADDRESS = 10;
+const u8 VU1_VERTICES_ADDRESS = VU1_RGBA_ADDRESS + 1;
+/** Quantized programs have dequantization of STs instead of first vertex */
+const u8 VU1_DEQUANTIZATION_ADDRESS = VU1_VERTICES_ADDRESS;
+const u8 VU1_QUANTIZED_VERTICES_ADDRESS = VU1_DEQUANTIZATION_ADDRESS + 1;
+/** Unpack of static data (with lights), 3 data refs and program start */
+const u32 VU1_PACKAGE_MAX_SIZE = 32;
+/** Unpack of static data (with dequantization), CALL of baked package and program start */
+const u32 VU1_DISPLAY_LIST_PACKAGE_SIZE = 18;
+
+/** Qwords of quantized vertices (V4-16) and STs (V2-16) of package. Data of every unpack starts at qword. */
+static inline u32 getQuantizedSize(const u32 &t_vertCount, const u8 &t_isRGBAOnly)
+{
+    return (t_vertCount + 1) / 2 + (t_isRGBAOnly ? 0 : (t_vertCount + 3) / 4);
+}
+
+/** Like packet2_utils_vu_add_unpack_data(), but for sign extended 16 bit data */
+static void addQuantizedUnpack(packet2_t *t_packet, const u32 &t_address, qword_t *t_data, const u32 &t_qwords, const u32 &t_count, const enum UnpackMode &t_mode)
+{
+    packet2_chain_ref(t_packet, t_data, t_qwords, 0, 0, 0);
+    packet2_vif_stcycl(t_packet, 0, 0x0101, 0);
+    packet2_vif_open_unpack(t_packet, t_mode, t_address, true, 0, 0, 0);
+    packet2_vif_close_unpack_manual(t_packet, t_count);
+}
 
 // ----
 // Constructors/Destructors
 // ----
 
-// VU1 micro program
-extern u32 VU1Draw3D_CodeStart __attribute__((section(".vudata")));
-extern u32 VU1Draw3D_CodeEnd __attribute__((section(".vudata")));
-//
-
-VifSender::VifSender(Light *t_light)
+VifSender::VifSender(Light *t_light, FrameArena *t_frameArena)
 {
     consoleLog("Initializing VifSender");
     light = t_light;
+    frameArena = t_frameArena;
     lastVertCount = 0;
+    lastProgram = VU1_PROGRAM_DRAW3D;
     isDrawWaitEnabled = true;
+    isBackfaceCullingEnabled = false;
+    frameChain = NULL;
     dma_channel_initialize(DMA_CHANNEL_VIF1, NULL, 0);
     dma_channel_fast_waits(DMA_CHANNEL_VIF1);
-    uploadMicroProgram();
     packets[0] = packet2_create(VU1_PACKET_SIZE, P2_TYPE_NORMAL, P2_MODE_CHAIN, true);
     packets[1] = packet2_create(VU1_PACKET_SIZE, P2_TYPE_NORMAL, P2_MODE_CHAIN, true);
     context = 0;
@@ -57,55 +83,369 @@ VifSender::~VifSender()
 // Methods
 // ----
 
-void VifSender::uploadMicroProgram()
+/** 
+ * Light directions are rotated into model space (transposed rotation of model matrix),
+ * so VU1 can use normals of mesh directly.
+ */
+void VifSender::setLights(Mesh &t_mesh, LightBulb *t_bulbs, u16 t_bulbsCount)
 {
-    packet2_t *packet2 = packet2_create(
-        packet2_utils_get_packet_size_for_program(&VU1Draw3D_CodeStart, &VU1Draw3D_CodeEnd) + 1, // + end tag
-        P2_TYPE_NORMAL,
-        P2_MODE_CHAIN,
-        1);
-    packet2_vif_add_micro_program(packet2, 0, &VU1Draw3D_CodeStart, &VU1Draw3D_CodeEnd);
-    packet2_utils_vu_add_end_tag(packet2);
-    dma_channel_wait(DMA_CHANNEL_VIF1, 0);
-    dma_channel_send_packet2(packet2, DMA_CHANNEL_VIF1, 1);
-    packet2_free(packet2);
+    VECTOR directions[VU1_MAX_LIGHTS + 1], colors[VU1_MAX_LIGHTS + 1];
+    int types[VU1_MAX_LIGHTS + 1];
+    const u16 lightsCount = light->getLightsCount(t_bulbsCount > VU1_MAX_LIGHTS ? VU1_MAX_LIGHTS : t_bulbsCount);
+    light->calculateLight(directions, colors, types, t_bulbs, lightsCount, t_mesh.position);
+    memset(lights, 0, sizeof(lights));
+    // Model matrix is scaled, so directions are scaled back
+    const float invScale = -1.0F / t_mesh.scale;
+    for (u16 i = 1; i < lightsCount; i++)
+    {
+        for (u8 j = 0; j < 3; j++) // negated, because VU1 needs direction to light
+            lights[j][i - 1] = invScale * (model.data[j * 4] * directions[i][0] + model.data[j * 4 + 1] * directions[i][1] + model.data[j * 4 + 2] * directions[i][2]);
+        lights[2 + i][0] = colors[i][0];
+        lights[2 + i][1] = colors[i][1];
+        lights[2 + i][2] = colors[i][2];
+    }
+    lights[6][0] = colors[0][0];
+    lights[6][1] = colors[0][1];
+    lights[6][2] = colors[0][2];
+    lights[6][3] = 1.0F;
 }
 
-void VifSender::calcMatrix(const RenderData &t_renderData, const Vector3 &t_position, const Vector3 &t_rotation)
+void VifSender::calcMatrix(const RenderData &t_renderData, const Matrix &t_model)
 {
-    model.identity();
-    model.rotate(t_rotation);
-    model.translate(t_position);
+    model = t_model;
+    modelViewProj = *t_renderData.viewProjection * model;
+}
 
-    modelViewProj.identity();
-    modelViewProj = model * modelViewProj;
-    modelViewProj = *t_renderData.view * modelViewProj;
-    modelViewProj = *t_renderData.projection * modelViewProj;
+void VifSender::drawInstances(RenderData *t_renderData, u32 t_vertCount, VECTOR *t_vertices, VECTOR *t_coordinates, Mesh &t_mesh, Matrix *t_matrices, color_t *t_colors, const u32 &t_instancesCount, TextureCacheEntry *t_texture, clutbuffer_t *t_clut, lod_t *t_lod, Vu1Program t_program)
+{
+    switch (t_program)
+    {
+    case VU1_PROGRAM_DRAW3D_RGBA:
+        drawInstancesVariant<VU1_PROGRAM_DRAW3D_RGBA>(t_renderData, t_vertCount, t_vertices, t_coordinates, t_matrices, t_colors, t_instancesCount, t_texture, t_clut, t_lod);
+        break;
+    case VU1_PROGRAM_DRAW3D:
+        drawInstancesVariant<VU1_PROGRAM_DRAW3D>(t_renderData, t_vertCount, t_vertices, t_coordinates, t_matrices, t_colors, t_instancesCount, t_texture, t_clut, t_lod);
+        break;
+    case VU1_PROGRAM_DRAW3D_CLIP_RGBA:
+        drawInstancesVariant<VU1_PROGRAM_DRAW3D_CLIP_RGBA>(t_renderData, t_vertCount, t_vertices, t_coordinates, t_matrices, t_colors, t_instancesCount, t_texture, t_clut, t_lod);
+        break;
+    case VU1_PROGRAM_DRAW3D_CLIP:
+        drawInstancesVariant<VU1_PROGRAM_DRAW3D_CLIP>(t_renderData, t_vertCount, t_vertices, t_coordinates, t_matrices, t_colors, t_instancesCount, t_texture, t_clut, t_lod);
+        break;
+    default:
+        assertMsg(false, "This VU1 program can't be used with drawInstances()!");
+    }
 }
 
-void VifSender::drawMesh(RenderData *t_renderData, Matrix t_perspective, u32 vertCount2, VECTOR *vertices, VECTOR *normals, VECTOR *coordinates, Mesh &t_mesh, LightBulb *t_bulbs, u16 t_bulbsCount, texbuffer_t *textureBuffer, color_t *t_color, u8 t_rgbaOnly)
+template <u8 t_features>
+void VifSender::drawInstancesVariant(RenderData *t_renderData, u32 t_vertCount, VECTOR *t_vertices, VECTOR *t_coordinates, Matrix *t_matrices, color_t *t_colors, const u32 &t_instancesCount, TextureCacheEntry *t_texture, clutbuffer_t *t_clut, lod_t *t_lod)
 {
-    // we have to split 3D object into small parts, because of small memory of VU1
+    typedef Vu1ProgramVariant<t_features> Variant;
+    const u8 isWaitNeeded = isDrawWaitEnabled && frameChain == NULL;
+    currPacket = frameChain != NULL ? frameChain->getChain() : packets[context];
+    if (frameChain == NULL)
+        packet2_reset(currPacket, false);
+    for (u32 i = 0; i < t_vertCount;)
+    {
+        const u32 endI = getVu1PackageEnd(i, t_vertCount, Variant::vertsPerBuff);
+        for (u32 j = 0; j < t_instancesCount; j++)
+        {
+            reservePacket(VU1_PACKAGE_MAX_SIZE + programManager.getUploadSize(Variant::program));
+            const u8 addDrawWait = isWaitNeeded && endI == t_vertCount && j == t_instancesCount - 1;
+            modelViewProj = t_matrices[j];
+            if (j >= 2) // Both VU1 buffers need vertices
+                addInstance(&t_colors[j], endI - i, addDrawWait, Variant::program);
+            else
+                drawVertices<t_features>(i, endI, t_vertices, NULL, t_coordinates, t_renderData->prim, t_texture, t_clut, t_lod, addDrawWait, &t_colors[j]);
+        }
+        i = getVu1NextPackageStart(endI, t_vertCount);
+    }
+    if (frameChain == NULL)
+        sendCurrentPacket();
+}
+
+/** Baked packages only unpack vertices, so program can be moved in VU1 memory by program manager */
+DisplayList *VifSender::createDisplayList(const u32 &t_vertCount, VECTOR *t_vertices, VECTOR *t_coordinates, Vu1Program t_program)
+{
+    const u8 isRGBAOnly = !(t_program & VU1_FEATURE_STQ);
+    const u32 vertsPerBuff = t_program & VU1_FEATURE_CLIP ? VU1_CLIP_PACKAGE_VERTS_PER_BUFF : t_program & VU1_FEATURE_QUANTIZED ? VU1_QUANTIZED_PACKAGE_VERTS_PER_BUFF : VU1_PACKAGE_VERTS_PER_BUFF;
+    u32 packagesCount = 0, quantizedSize = 0;
+    for (u32 i = 0; i < t_vertCount; packagesCount++)
+    {
+        const u32 endI = getVu1PackageEnd(i, t_vertCount, vertsPerBuff);
+        quantizedSize += getQuantizedSize(endI - i, isRGBAOnly);
+        i = getVu1NextPackageStart(endI, t_vertCount);
+    }
+    DisplayList *result = new DisplayList(t_vertCount, packagesCount, t_program, quantizedSize);
+    if (result->isQuantized())
+    {
+        addQuantizedPackages(*result, t_vertCount, t_vertices, t_coordinates, vertsPerBuff);
+        return result;
+    }
+    memcpy(result->getVertices(), t_vertices, t_vertCount * sizeof(VECTOR));
+    if (!isRGBAOnly)
+        memcpy(result->getCoordinates(), t_coordinates, t_vertCount * sizeof(VECTOR));
+    packet2_t *chain = result->getChain();
+    for (u32 i = 0; i < t_vertCount;)
+    {
+        const u32 endI = getVu1PackageEnd(i, t_vertCount, vertsPerBuff);
+        const u32 vertCount = endI - i;
+        result->addPackage(chain->next, vertCount);
+        packet2_utils_vu_add_unpack_data(chain, VU1_VERTICES_ADDRESS, result->getVertices() + i, vertCount, true);
+        if (!isRGBAOnly)
+            packet2_utils_vu_add_unpack_data(chain, VU1_VERTICES_ADDRESS + vertCount, result->getCoordinates() + i, vertCount, true);
+        packet2_chain_open_ret(chain, 0, 0);
+        packet2_vif_nop(chain, 0);
+        packet2_vif_nop(chain, 0);
+        packet2_chain_close_tag(chain);
+        i = getVu1NextPackageStart(endI, t_vertCount);
+    }
+    return result;
+}
+
+/** Quantizes vertices and STs of every package separately, so every unpack starts at qword */
+void VifSender::addQuantizedPackages(DisplayList &t_displayList, const u32 &t_vertCount, VECTOR *t_vertices, VECTOR *t_coordinates, const u32 &t_vertsPerBuff)
+{
+    const u8 isRGBAOnly = t_displayList.isRGBAOnly();
+    VECTOR scale, offset, stScale, stOffset;
+    VertexQuantizer::getBounds(t_vertices, t_vertCount, 3, scale, offset);
+    Matrix &dequantization = t_displayList.getDequantization();
+    dequantization.identity();
+    for (u8 i = 0; i < 3; i++)
+    {
+        dequantization.data[i * 5] = scale[i];
+        dequantization.data[12 + i] = offset[i];
+    }
+    if (!isRGBAOnly)
+    {
+        VertexQuantizer::getBounds(t_coordinates, t_vertCount, 2, stScale, stOffset);
+        VECTOR &stDequantization = t_displayList.getSTDequantization();
+        stDequantization[0] = stScale[0];
+        stDequantization[1] = stScale[1];
+        stDequantization[2] = stOffset[0];
+        stDequantization[3] = stOffset[1];
+    }
+    packet2_t *chain = t_displayList.getChain();
+    qword_t *data = t_displayList.getQuantizedData();
+    for (u32 i = 0; i < t_vertCount;)
+    {
+        const u32 endI = getVu1PackageEnd(i, t_vertCount, t_vertsPerBuff);
+        const u32 vertCount = endI - i;
+        t_displayList.addPackage(chain->next, vertCount);
+        const u32 verticesSize = (vertCount + 1) / 2;
+        VertexQuantizer::quantizeVertices(t_vertices + i, vertCount, scale, offset, reinterpret_cast<s16 *>(data));
+        addQuantizedUnpack(chain, VU1_QUANTIZED_VERTICES_ADDRESS, data, verticesSize, vertCount, P2_UNPACK_V4_16);
+        data += verticesSize;
+        if (!isRGBAOnly)
+        {
+            const u32 coordinatesSize = (vertCount + 3) / 4;
+            VertexQuantizer::quantizeCoordinates(t_coordinates + i, vertCount, stScale, stOffset, reinterpret_cast<s16 *>(data));
+            addQuantizedUnpack(chain, VU1_QUANTIZED_VERTICES_ADDRESS + vertCount, data, coordinatesSize, vertCount, P2_UNPACK_V2_16);
+            data += coordinatesSize;
+        }
+        packet2_chain_open_ret(chain, 0, 0);
+        packet2_vif_nop(chain, 0);
+        packet2_vif_nop(chain, 0);
+        packet2_chain_close_tag(chain);
+        i = getVu1NextPackageStart(endI, t_vertCount);
+    }
+}
+
+void VifSender::drawDisplayList(RenderData *t_renderData, DisplayList &t_displayList, TextureCacheEntry *t_texture, clutbuffer_t *t_clut, lod_t *t_lod, color_t *t_color)
+{
+    const std::vector<DisplayListPackage> &packages = t_displayList.getPackages();
+    if (packages.size() == 0)
+        return;
+    const Matrix notDequantized = modelViewProj;
+    if (t_displayList.isQuantized())
+    {
+        // Vertices are dequantized by matrix, after conversion to float in VU1
+        dequantization = t_displayList.getDequantization();
+        modelViewProj = modelViewProj * dequantization;
+    }
+    const u8 isWaitNeeded = isDrawWaitEnabled && frameChain == NULL;
+    const Vu1Program &program = t_displayList.getProgram();
+    currPacket = frameChain != NULL ? frameChain->getChain() : packets[context];
+    if (frameChain == NULL)
+        packet2_reset(currPacket, false);
+    for (u32 i = 0; i < packages.size(); i++)
+    {
+        reservePacket(VU1_DISPLAY_LIST_PACKAGE_SIZE + programManager.getUploadSize(program));
+        const u32 programAddress = programManager.use(currPacket, program);
+        addHeader(packages[i].vertCount, t_renderData->prim, t_texture, t_clut, t_lod, isWaitNeeded && i == packages.size() - 1, t_color, program);
+        if (t_displayList.isQuantized())
+        {
+            packet2_utils_vu_open_unpack(currPacket, VU1_DEQUANTIZATION_ADDRESS, true);
+            packet2_add_data(currPacket, t_displayList.getSTDequantization(), 1);
+            packet2_utils_vu_close_unpack(currPacket);
+        }
+        // Baked chain unpacks vertices and returns here
+        packet2_chain_open_call(currPacket, packages[i].chain, 0, 0, 0);
+        packet2_vif_nop(currPacket, 0);
+        packet2_vif_nop(currPacket, 0);
+        packet2_chain_close_tag(currPacket);
+        packet2_utils_vu_add_start_program(currPacket, programAddress);
+    }
+    lastVertCount = packages.back().vertCount;
+    lastProgram = program;
+    modelViewProj = notDequantized;
+    if (frameChain == NULL)
+        sendCurrentPacket();
+}
+
+void VifSender::drawBakedAnimation(RenderData *t_renderData, BakedAnimation &t_animation, const u32 &t_currentFrame, const u32 &t_nextFrame, const float &t_interpolation, TextureCacheEntry *t_texture, clutbuffer_t *t_clut, lod_t *t_lod, color_t *t_color)
+{
+    const u32 totalVertCount = t_animation.getVertCount();
+    const u8 isWaitNeeded = isDrawWaitEnabled && frameChain == NULL;
+    const Vu1Program program = t_animation.isRGBAOnly() ? VU1_PROGRAM_DRAW3D_LERP_RGBA : VU1_PROGRAM_DRAW3D_LERP;
+    currPacket = frameChain != NULL ? frameChain->getChain() : packets[context];
+    if (frameChain == NULL)
+        packet2_reset(currPacket, false);
+    u32 vertCount = 0;
+    for (u32 i = 0; i < totalVertCount;)
+    {
+        const u32 endI = getVu1PackageEnd(i, totalVertCount, VU1_LARGE_PACKAGE_VERTS_PER_BUFF);
+        vertCount = endI - i;
+        reservePacket(VU1_PACKAGE_MAX_SIZE + programManager.getUploadSize(program));
+        const u32 programAddress = programManager.use(currPacket, program);
+        u32 address = addHeader(vertCount, t_renderData->prim, t_texture, t_clut, t_lod, isWaitNeeded && endI == totalVertCount, t_color, program);
+        packet2_utils_vu_open_unpack(currPacket, address, true);
+        packet2_add_float(currPacket, t_interpolation);
+        packet2_add_float(currPacket, 1.0F - t_interpolation);
+        packet2_add_float(currPacket, 0.0F);
+        packet2_add_float(currPacket, 0.0F);
+        address += packet2_utils_vu_close_unpack(currPacket);
+        packet2_utils_vu_add_unpack_data(currPacket, address, t_animation.getFrame(t_currentFrame) + i, vertCount, true);
+        address += vertCount;
+        packet2_utils_vu_add_unpack_data(currPacket, address, t_animation.getFrame(t_nextFrame) + i, vertCount, true);
+        if (!t_animation.isRGBAOnly())
+        {
+            address += vertCount;
+            packet2_utils_vu_add_unpack_data(currPacket, address, t_animation.getCoordinates() + i, vertCount, true);
+        }
+        packet2_utils_vu_add_start_program(currPacket, programAddress);
+        i = getVu1NextPackageStart(endI, totalVertCount);
+    }
+    lastVertCount = vertCount;
+    lastProgram = program;
+    if (frameChain == NULL)
+        sendCurrentPacket();
+}
 
-    for (u32 i = 0; i < vertCount2;)
+/** Reuses vertices, which are already in current VU1 buffer */
+void VifSender::addInstance(color_t *t_color, const u32 &t_vertCount, u8 t_addDrawWait, Vu1Program t_program)
+{
+    const u32 programAddress = programManager.use(currPacket, t_program);
+    packet2_utils_vu_open_unpack(currPacket, 0, true);
+    packet2_add_data(currPacket, modelViewProj.data, 4);
+    packet2_add_u32(currPacket, getFlags(t_addDrawWait)); // Draw finish? Backface culling?
+    packet2_add_u32(currPacket, t_vertCount);             // Vertex count
+    packet2_add_u32(currPacket, t_vertCount / 3);
+    packet2_add_u32(currPacket, 0);
+    packet2_utils_vu_close_unpack(currPacket);
+    packet2_utils_vu_open_unpack(currPacket, VU1_RGBA_ADDRESS, true);
+    packet2_add_u32(currPacket, t_color->r);
+    packet2_add_u32(currPacket, t_color->g);
+    packet2_add_u32(currPacket, t_color->b);
+    packet2_add_u32(currPacket, t_color->a);
+    packet2_utils_vu_close_unpack(currPacket);
+    packet2_utils_vu_add_start_program(currPacket, programAddress);
+}
+
+/** In frame chain mode only checks space. Otherwise sends current packet, when it is full */
+void VifSender::reservePacket(const u32 &t_qwords)
+{
+    if (frameChain != NULL)
+    {
+        frameChain->reserve(t_qwords);
+        return;
+    }
+    if (packet2_get_qw_count(currPacket) + t_qwords + 1 > VU1_PACKET_SIZE) // + end tag
     {
+        sendCurrentPacket();
         currPacket = packets[context];
         packet2_reset(currPacket, false);
+    }
+}
+
+u32 VifSender::getFlags(u8 t_addDrawWait)
+{
+    return (t_addDrawWait ? VU1_FLAG_DRAW_FINISH : 0) | (isBackfaceCullingEnabled ? VU1_FLAG_BACKFACE_CULLING : 0);
+}
+
+void VifSender::sendCurrentPacket()
+{
+    packet2_utils_vu_add_end_tag(currPacket);
+    dma_channel_send_packet2(currPacket, DMA_CHANNEL_VIF1, 1);
+    dma_channel_wait(DMA_CHANNEL_VIF1, 0);
+    context = !context;
+}
+
+void VifSender::drawMesh(RenderData *t_renderData, Matrix t_perspective, u32 vertCount2, VECTOR *vertices, VECTOR *normals, VECTOR *coordinates, Mesh &t_mesh, LightBulb *t_bulbs, u16 t_bulbsCount, TextureCacheEntry *t_texture, clutbuffer_t *t_clut, lod_t *t_lod, color_t *t_color, Vu1Program t_program)
+{
+    if (t_program & VU1_FEATURE_LIT)
+        setLights(t_mesh, t_bulbs, t_bulbsCount);
+    // Program is selected once per mesh, packing code of every variant is specialized at compile time
+    switch (t_program)
+    {
+    case VU1_PROGRAM_DRAW3D_RGBA:
+        drawMeshVariant<VU1_PROGRAM_DRAW3D_RGBA>(t_renderData, vertCount2, vertices, normals, coordinates, t_mesh, t_texture, t_clut, t_lod, t_color);
+        break;
+    case VU1_PROGRAM_DRAW3D:
+        drawMeshVariant<VU1_PROGRAM_DRAW3D>(t_renderData, vertCount2, vertices, normals, coordinates, t_mesh, t_texture, t_clut, t_lod, t_color);
+        break;
+    case VU1_PROGRAM_DRAW3D_STRIP_RGBA:
+        drawMeshVariant<VU1_PROGRAM_DRAW3D_STRIP_RGBA>(t_renderData, vertCount2, vertices, normals, coordinates, t_mesh, t_texture, t_clut, t_lod, t_color);
+        break;
+    case VU1_PROGRAM_DRAW3D_STRIP:
+        drawMeshVariant<VU1_PROGRAM_DRAW3D_STRIP>(t_renderData, vertCount2, vertices, normals, coordinates, t_mesh, t_texture, t_clut, t_lod, t_color);
+        break;
+    case VU1_PROGRAM_DRAW3D_LIT_RGBA:
+        drawMeshVariant<VU1_PROGRAM_DRAW3D_LIT_RGBA>(t_renderData, vertCount2, vertices, normals, coordinates, t_mesh, t_texture, t_clut, t_lod, t_color);
+        break;
+    case VU1_PROGRAM_DRAW3D_LIT:
+        drawMeshVariant<VU1_PROGRAM_DRAW3D_LIT>(t_renderData, vertCount2, vertices, normals, coordinates, t_mesh, t_texture, t_clut, t_lod, t_color);
+        break;
+    case VU1_PROGRAM_DRAW3D_CLIP_RGBA:
+        drawMeshVariant<VU1_PROGRAM_DRAW3D_CLIP_RGBA>(t_renderData, vertCount2, vertices, normals, coordinates, t_mesh, t_texture, t_clut, t_lod, t_color);
+        break;
+    case VU1_PROGRAM_DRAW3D_CLIP:
+        drawMeshVariant<VU1_PROGRAM_DRAW3D_CLIP>(t_renderData, vertCount2, vertices, normals, coordinates, t_mesh, t_texture, t_clut, t_lod, t_color);
+        break;
+    default:
+        assertMsg(false, "This VU1 program can't be used with drawMesh()!");
+    }
+}
+
+template <u8 t_features>
+void VifSender::drawMeshVariant(RenderData *t_renderData, u32 t_vertCount, VECTOR *t_vertices, VECTOR *t_normals, VECTOR *t_coordinates, Mesh &t_mesh, TextureCacheEntry *t_texture, clutbuffer_t *t_clut, lod_t *t_lod, color_t *t_color)
+{
+    typedef Vu1ProgramVariant<t_features> Variant;
+    // we have to split 3D object into small parts, because of small memory of VU1
+
+    // In frame chain mode draw wait is not used, because only FINISH at the end of frame is waited for
+    const u8 isWaitNeeded = isDrawWaitEnabled && frameChain == NULL;
+    for (u32 i = 0; i < t_vertCount;)
+    {
+        if (frameChain != NULL)
+            currPacket = frameChain->getChain();
+        else
+        {
+            currPacket = packets[context];
+            packet2_reset(currPacket, false);
+        }
         for (u8 j = 0; j < VU1_PACKAGES_PER_PACKET; j++) // how many "packages" per one packet
         {
-            if (i != 0) // we have to go back to avoid the visual artifacts
-                i -= 3;
-
-            const u32 endI = i + (VU1_PACKAGE_VERTS_PER_BUFF - 1) > vertCount2 ? vertCount2 : i + (VU1_PACKAGE_VERTS_PER_BUFF - 1);
-            drawVertices(t_mesh, i, endI, vertices, coordinates, t_renderData->prim, textureBuffer, isDrawWaitEnabled ? endI == vertCount2 : false, t_color, t_rgbaOnly);
-            if (endI == vertCount2) // if there are no more vertices to draw, break
-            {
-                i = vertCount2;
+            if (frameChain != NULL)
+                frameChain->reserve(VU1_PACKAGE_MAX_SIZE + programManager.getUploadSize(Variant::program));
+            const u32 endI = getVu1PackageEnd(i, t_vertCount, Variant::vertsPerBuff);
+            drawVertices<t_features>(i, endI, t_vertices, t_normals, t_coordinates, t_renderData->prim, t_texture, t_clut, t_lod, isWaitNeeded ? endI == t_vertCount : false, t_color);
+            i = getVu1NextPackageStart(endI, t_vertCount);
+            if (i == t_vertCount) // if there are no more vertices to draw, break
                 break;
-            }
-            i += (VU1_PACKAGE_VERTS_PER_BUFF - 1);
-            i++;
         }
+        if (frameChain != NULL) // Chain is sent by renderer, once per frame
+            continue;
         packet2_utils_vu_add_end_tag(currPacket);
         dma_channel_send_packet2(currPacket, DMA_CHANNEL_VIF1, 1);
         dma_channel_wait(DMA_CHANNEL_VIF1, 0);
@@ -130,57 +470,78 @@ void VifSender::setDoubleBufferAddStaticData()
 }
 
 /** Draw using PATH1 */
-void VifSender::drawVertices(Mesh &t_mesh, u32 t_start, u32 t_end, VECTOR *t_vertices, VECTOR *t_coordinates, prim_t *t_prim, texbuffer_t *t_texBuff, u8 t_addDrawWait, color_t *t_color, u8 t_rgbaOnly)
+template <u8 t_features>
+void VifSender::drawVertices(u32 t_start, u32 t_end, VECTOR *t_vertices, VECTOR *t_normals, VECTOR *t_coordinates, prim_t *t_prim, TextureCacheEntry *t_texture, clutbuffer_t *t_clut, lod_t *t_lod, u8 t_addDrawWait, color_t *t_color)
 {
+    typedef Vu1ProgramVariant<t_features> Variant;
     const u32 vertCount = t_end - t_start;
     lastVertCount = vertCount;
-    isLastRGBAOnly = t_rgbaOnly;
+    lastProgram = Variant::program;
+    const u32 programAddress = programManager.use(currPacket, Variant::program);
+    u32 vif_added_bytes = addHeader(vertCount, t_prim, t_texture, t_clut, t_lod, t_addDrawWait, t_color, Variant::program);
+    packet2_utils_vu_add_unpack_data(currPacket, vif_added_bytes, t_vertices + t_start, vertCount, true);
+    if (Variant::hasNormals)
+    {
+        vif_added_bytes += vertCount;
+        packet2_utils_vu_add_unpack_data(currPacket, vif_added_bytes, t_normals + t_start, vertCount, true);
+    }
+    if (Variant::hasSTQ)
+    {
+        vif_added_bytes += vertCount;
+        packet2_utils_vu_add_unpack_data(currPacket, vif_added_bytes, t_coordinates + t_start, vertCount, true);
+    }
+    packet2_utils_vu_add_start_program(currPacket, programAddress);
+}
+
+/** Unpacks matrix, params, GS registers and color. Returns count of unpacked qwords */
+u32 VifSender::addHeader(const u32 &t_vertCount, prim_t *t_prim, TextureCacheEntry *t_texture, clutbuffer_t *t_clut, lod_t *t_lod, u8 t_addDrawWait, color_t *t_color, Vu1Program t_program)
+{
+    prim_t stripPrim;
+    if (t_program & VU1_FEATURE_STRIP)
+    {
+        stripPrim = *t_prim;
+        stripPrim.type = PRIM_TRIANGLE_STRIP;
+        t_prim = &stripPrim;
+    }
     packet2_utils_vu_open_unpack(currPacket, 0, true);
     packet2_add_data(currPacket, modelViewProj.data, 4);
-    packet2_add_u32(currPacket, t_addDrawWait); // Draw finish?
-    packet2_add_u32(currPacket, vertCount);     // Vertex count
-    packet2_add_u32(currPacket, vertCount / 3); // Triangles count
-    packet2_add_u32(currPacket, t_rgbaOnly);    // 0 = STQ+RGBA, 1 = RGBA
-    packet2_utils_gs_add_lod(currPacket, &t_mesh.lod);
-    packet2_utils_gs_add_texbuff_clut(currPacket, t_texBuff, &t_mesh.clut);
-    if (t_rgbaOnly)
-        packet2_utils_gs_add_prim_giftag(currPacket, t_prim, vertCount, DRAW_RGBAQ_REGLIST, 2, 0);
+    packet2_add_u32(currPacket, getFlags(t_addDrawWait)); // Draw finish? Backface culling?
+    packet2_add_u32(currPacket, t_vertCount);             // Vertex count
+    packet2_add_u32(currPacket, t_vertCount / 3);         // Triangles count
+    packet2_add_u32(currPacket, 0);                       // Unused, STQ/RGBA variant is selected by program
+    packet2_utils_gs_add_lod(currPacket, t_lod);
+    packet2_utils_gs_add_texbuff_clut(currPacket, &t_texture->buffer, t_clut);
+    packet2_add_2x_s64(currPacket, t_texture->miptbp1, GS_REG_MIPTBP1);
+    packet2_add_2x_s64(currPacket, t_texture->miptbp2, GS_REG_MIPTBP2);
+    if (t_program & VU1_FEATURE_STQ)
+        packet2_utils_gs_add_prim_giftag(currPacket, t_prim, t_vertCount, DRAW_STQ2_REGLIST, 3, 0);
     else
-        packet2_utils_gs_add_prim_giftag(currPacket, t_prim, vertCount, DRAW_STQ2_REGLIST, 3, 0);
+        packet2_utils_gs_add_prim_giftag(currPacket, t_prim, t_vertCount, DRAW_RGBAQ_REGLIST, 2, 0);
     packet2_add_u32(currPacket, t_color->r);
     packet2_add_u32(currPacket, t_color->g);
     packet2_add_u32(currPacket, t_color->b);
     packet2_add_u32(currPacket, t_color->a);
-    u32 vif_added_bytes = packet2_utils_vu_close_unpack(currPacket);
-    packet2_utils_vu_add_unpack_data(currPacket, vif_added_bytes, t_vertices + t_start, vertCount, true);
-    if (!t_rgbaOnly)
-    {
-        vif_added_bytes += vertCount;
-        packet2_utils_vu_add_unpack_data(currPacket, vif_added_bytes, t_coordinates + t_start, vertCount, true);
-    }
-    packet2_utils_vu_add_start_program(currPacket, 0);
+    if (t_program & VU1_FEATURE_LIT)
+        packet2_add_data(currPacket, lights, 7);
+    return packet2_utils_vu_close_unpack(currPacket);
 }
 
 void VifSender::drawTheSameWithOtherMatrices(const RenderData &t_renderData, Mesh **t_meshes, const u32 &t_skip, const u32 &t_count)
 {
-    // Standard double buffering (packets)
-    packet2_t *packet1 = packet2_create(300, P2_TYPE_NORMAL, P2_MODE_CHAIN, true);
-    packet2_t *packet2 = packet2_create(300, P2_TYPE_NORMAL, P2_MODE_CHAIN, true);
+    // Standard double buffering (packets). Arena keeps them alive, while DMA reads them
+    packet2_t *packet1 = frameArena->getPacket(300, P2_TYPE_NORMAL, P2_MODE_CHAIN, true);
+    packet2_t *packet2 = frameArena->getPacket(300, P2_TYPE_NORMAL, P2_MODE_CHAIN, true);
     packet2_t *currMPacket = packet1;
     u8 currPacketIndex = 1;
+    const u32 programAddress = programManager.use(currMPacket, lastProgram);
 
     // We are sending 32 matrices max per one VU1 send
     u8 switchCounter = 0;
     for (u32 i = t_skip; i < t_count; i++)
     {
-        model.identity();
-        model.rotate(t_meshes[i]->rotation);
-        model.translate(t_meshes[i]->position);
-
-        modelViewProj.identity();
-        modelViewProj = model * modelViewProj;
-        modelViewProj = *t_renderData.view * modelViewProj;
-        modelViewProj = *t_renderData.projection * modelViewProj;
+        modelViewProj = *t_renderData.viewProjection * t_meshes[i]->getModelMatrix();
+        if (lastProgram & VU1_FEATURE_QUANTIZED)
+            modelViewProj = modelViewProj * dequantization;
 
         packet2_utils_vu_open_unpack(currMPacket, 0, true);
         {
@@ -197,7 +558,7 @@ void VifSender::drawTheSameWithOtherMatrices(const RenderData &t_renderData, Mes
         packet2_utils_vu_close_unpack(currMPacket);
 
         if (i != t_count - 1) // if it is last, we must also add draw wait finish interrupt.
-            packet2_utils_vu_add_start_program(currMPacket, 0);
+            packet2_utils_vu_add_start_program(currMPacket, programAddress);
 
         if (switchCounter++ >= 32)
         {
@@ -206,13 +567,13 @@ void VifSender::drawTheSameWithOtherMatrices(const RenderData &t_renderData, Mes
             {
                 packet2_utils_vu_open_unpack(currMPacket, VU1_PARAMS_ADDRESS, true);
                 {
-                    packet2_add_u32(currMPacket, true);              // Draw wait finish?
-                    packet2_add_u32(currMPacket, lastVertCount);     // Vertex count
-                    packet2_add_u32(currMPacket, lastVertCount / 3); // Triangles count
-                    packet2_add_u32(currMPacket, isLastRGBAOnly);    // 0 = STQ+RGBA, 1 = RGBA
+                    packet2_add_u32(currMPacket, VU1_FLAG_DRAW_FINISH); // Draw wait finish?
+                    packet2_add_u32(currMPacket, lastVertCount);        // Vertex count
+                    packet2_add_u32(currMPacket, lastVertCount / 3);    // Triangles count
+                    packet2_add_u32(currMPacket, 0);                    // Unused
                 }
                 packet2_utils_vu_close_unpack(currMPacket);
-                packet2_utils_vu_add_start_program(currMPacket, 0); // and start program
+                packet2_utils_vu_add_start_program(currMPacket, programAddress); // and start program
             }
             packet2_utils_vu_add_end_tag(currMPacket);
             dma_channel_wait(DMA_CHANNEL_VIF1, 0);
@@ -234,17 +595,15 @@ void VifSender::drawTheSameWithOtherMatrices(const RenderData &t_renderData, Mes
     {
         packet2_utils_vu_open_unpack(currMPacket, VU1_PARAMS_ADDRESS, true);
         {
-            packet2_add_u32(currMPacket, true);              // Draw wait finish?
-            packet2_add_u32(currMPacket, lastVertCount);     // Vertex count
-            packet2_add_u32(currMPacket, lastVertCount / 3); // Triangles count
-            packet2_add_u32(currMPacket, isLastRGBAOnly);    // 0 = STQ+RGBA, 1 = RGBA
+            packet2_add_u32(currMPacket, VU1_FLAG_DRAW_FINISH); // Draw wait finish?
+            packet2_add_u32(currMPacket, lastVertCount);        // Vertex count
+            packet2_add_u32(currMPacket, lastVertCount / 3);    // Triangles count
+            packet2_add_u32(currMPacket, 0);                    // Unused
         }
         packet2_utils_vu_close_unpack(currMPacket);
-        packet2_utils_vu_add_start_program(currMPacket, 0);
+        packet2_utils_vu_add_start_program(currMPacket, programAddress);
         packet2_utils_vu_add_end_tag(currMPacket);
         dma_channel_wait(DMA_CHANNEL_VIF1, 0);
         dma_channel_send_packet2(currMPacket, DMA_CHANNEL_VIF1, 1);
     }
-    packet2_free(packet1);
-    packet2_free(packet2);
 }
@@ -0,0 +1,134 @@
+/*
+# ______       ____   ___
+#   |     \/   ____| |___|    
+#   |     |   |   \  |   |       
+#-----------------------------------------------------------------------
+# Copyright 2020, tyra - https://github.com/h4570/tyra
+# Licenced under Apache License 2.0
+# Sandro Sobczyński <sandro.sobczynski@gmail.com>
+*/
+
+#include "../include/modules/vu1_program_manager.hpp"
+
+#include <packet2_utils.h>
+#include "../include/utils/debug.hpp"
+
+const u8 VU1_NO_PROGRAM = 0xFF;
+
+// VU1 micro programs
+extern u32 VU1Draw3D_CodeStart __attribute__((section(".vudata")));
+extern u32 VU1Draw3D_CodeEnd __attribute__((section(".vudata")));
+extern u32 VU1Draw3DRGBA_CodeStart __attribute__((section(".vudata")));
+extern u32 VU1Draw3DRGBA_CodeEnd __attribute__((section(".vudata")));
+extern u32 VU1Draw3DStrip_CodeStart __attribute__((section(".vudata")));
+extern u32 VU1Draw3DStrip_CodeEnd __attribute__((section(".vudata")));
+extern u32 VU1Draw3DStripRGBA_CodeStart __attribute__((section(".vudata")));
+extern u32 VU1Draw3DStripRGBA_CodeEnd __attribute__((section(".vudata")));
+extern u32 VU1Draw3DLerp_CodeStart __attribute__((section(".vudata")));
+extern u32 VU1Draw3DLerp_CodeEnd __attribute__((section(".vudata")));
+extern u32 VU1Draw3DLerpRGBA_CodeStart __attribute__((section(".vudata")));
+extern u32 VU1Draw3DLerpRGBA_CodeEnd __attribute__((section(".vudata")));
+extern u32 VU1Draw3DLit_CodeStart __attribute__((section(".vudata")));
+extern u32 VU1Draw3DLit_CodeEnd __attribute__((section(".vudata")));
+extern u32 VU1Draw3DLitRGBA_CodeStart __attribute__((section(".vudata")));
+extern u32 VU1Draw3DLitRGBA_CodeEnd __attribute__((section(".vudata")));
+extern u32 VU1Draw3DClip_CodeStart __attribute__((section(".vudata")));
+extern u32 VU1Draw3DClip_CodeEnd __attribute__((section(".vudata")));
+extern u32 VU1Draw3DClipRGBA_CodeStart __attribute__((section(".vudata")));
+extern u32 VU1Draw3DClipRGBA_CodeEnd __attribute__((section(".vudata")));
+extern u32 VU1Draw3DQuantized_CodeStart __attribute__((section(".vudata")));
+extern u32 VU1Draw3DQuantized_CodeEnd __attribute__((section(".vudata")));
+extern u32 VU1Draw3DQuantizedRGBA_CodeStart __attribute__((section(".vudata")));
+extern u32 VU1Draw3DQuantizedRGBA_CodeEnd __attribute__((section(".vudata")));
+//
+
+// ----
+// Constructors/Destructors
+// ----
+
+Vu1ProgramManager::Vu1ProgramManager()
+{
+    for (u8 i = 0; i < VU1_PROGRAMS_TABLE_SIZE; i++)
+        setProgram(static_cast<Vu1Program>(i), NULL, NULL);
+    setProgram(VU1_PROGRAM_DRAW3D_RGBA, &VU1Draw3DRGBA_CodeStart, &VU1Draw3DRGBA_CodeEnd);
+    setProgram(VU1_PROGRAM_DRAW3D, &VU1Draw3D_CodeStart, &VU1Draw3D_CodeEnd);
+    setProgram(VU1_PROGRAM_DRAW3D_STRIP_RGBA, &VU1Draw3DStripRGBA_CodeStart, &VU1Draw3DStripRGBA_CodeEnd);
+    setProgram(VU1_PROGRAM_DRAW3D_STRIP, &VU1Draw3DStrip_CodeStart, &VU1Draw3DStrip_CodeEnd);
+    setProgram(VU1_PROGRAM_DRAW3D_LERP_RGBA, &VU1Draw3DLerpRGBA_CodeStart, &VU1Draw3DLerpRGBA_CodeEnd);
+    setProgram(VU1_PROGRAM_DRAW3D_LERP, &VU1Draw3DLerp_CodeStart, &VU1Draw3DLerp_CodeEnd);
+    setProgram(VU1_PROGRAM_DRAW3D_LIT_RGBA, &VU1Draw3DLitRGBA_CodeStart, &VU1Draw3DLitRGBA_CodeEnd);
+    setProgram(VU1_PROGRAM_DRAW3D_LIT, &VU1Draw3DLit_CodeStart, &VU1Draw3DLit_CodeEnd);
+    setProgram(VU1_PROGRAM_DRAW3D_CLIP_RGBA, &VU1Draw3DClipRGBA_CodeStart, &VU1Draw3DClipRGBA_CodeEnd);
+    setProgram(VU1_PROGRAM_DRAW3D_CLIP, &VU1Draw3DClip_CodeStart, &VU1Draw3DClip_CodeEnd);
+    setProgram(VU1_PROGRAM_DRAW3D_QUANTIZED_RGBA, &VU1Draw3DQuantizedRGBA_CodeStart, &VU1Draw3DQuantizedRGBA_CodeEnd);
+    setProgram(VU1_PROGRAM_DRAW3D_QUANTIZED, &VU1Draw3DQuantized_CodeStart, &VU1Draw3DQuantized_CodeEnd);
+    freeAddress = 0;
+    currentProgram = VU1_NO_PROGRAM;
+    resetStats(stats);
+    resetStats(lastFrameStats);
+}
+
+Vu1ProgramManager::~Vu1ProgramManager() {}
+
+// ----
+// Methods
+// ----
+
+void Vu1ProgramManager::setProgram(const Vu1Program &t_program, u32 *t_start, u32 *t_end)
+{
+    programs[t_program].start = t_start;
+    programs[t_program].end = t_end;
+    programs[t_program].address = 0;
+    programs[t_program].isResident = false;
+}
+
+u32 Vu1ProgramManager::getUploadSize(const Vu1Program &t_program) const
+{
+    if (programs[t_program].isResident)
+        return 0;
+    return packet2_utils_get_packet_size_for_program(programs[t_program].start, programs[t_program].end);
+}
+
+u32 Vu1ProgramManager::use(packet2_t *t_packet, const Vu1Program &t_program)
+{
+    Vu1ProgramEntry &entry = programs[t_program];
+    assertMsg(entry.start != NULL, "VU1 program with these features does not exist!");
+    if (currentProgram != t_program)
+    {
+        currentProgram = t_program;
+        stats.switches++;
+    }
+    if (entry.isResident)
+        return entry.address;
+    const u32 size = (entry.end - entry.start) / 2; // 64bit instructions
+    if (freeAddress + size > VU1_MICRO_MEMORY_SIZE)
+        evictAll();
+    // MPG waits until VU1 ends current program, so previous draws are not broken
+    packet2_vif_add_micro_program(t_packet, freeAddress, entry.start, entry.end);
+    entry.address = freeAddress;
+    entry.isResident = true;
+    freeAddress += size;
+    stats.uploads++;
+    return entry.address;
+}
+
+void Vu1ProgramManager::evictAll()
+{
+    for (u8 i = 0; i < VU1_PROGRAMS_TABLE_SIZE; i++)
+        programs[i].isResident = false;
+    freeAddress = 0;
+    stats.evictions++;
+}
+
+void Vu1ProgramManager::endFrame()
+{
+    lastFrameStats = stats;
+    resetStats(stats);
+}
+
+void Vu1ProgramManager::resetStats(Vu1ProgramManagerStats &t_stats)
+{
+    t_stats.switches = 0;
+    t_stats.uploads = 0;
+    t_stats.evictions = 0;
+}
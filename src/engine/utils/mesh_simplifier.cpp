@@ -0,0 +1,352 @@
+/*
+# ______       ____   ___
+#   |     \/   ____| |___|    
+#   |     |   |   \  |   |       
+#-----------------------------------------------------------------------
+# Copyright 2020, tyra - https://github.com/h4570/tyra
+# Licenced under Apache License 2.0
+# Sandro Sobczyński <sandro.sobczynski@gmail.com>
+*/
+
+#include "../include/utils/mesh_simplifier.hpp"
+#include "../include/utils/math.hpp"
+
+#include <vector>
+#include <queue>
+#include <algorithm>
+
+/** Max count of animation frames, which are used to sum errors. Frames between are skipped. */
+const u32 MESH_SIMPLIFIER_MAX_FRAMES = 8;
+/** Weight of planes which keep borders of mesh */
+const float MESH_SIMPLIFIER_BORDER_WEIGHT = 10.0F;
+
+/** Symmetric 4x4 matrix of plane equations (a, b, c, d) */
+struct MeshSimplifierQuadric
+{
+    float m[10];
+
+    void addPlane(const float &a, const float &b, const float &c, const float &d, const float &t_weight)
+    {
+        m[0] += t_weight * a * a, m[1] += t_weight * a * b, m[2] += t_weight * a * c, m[3] += t_weight * a * d;
+        m[4] += t_weight * b * b, m[5] += t_weight * b * c, m[6] += t_weight * b * d;
+        m[7] += t_weight * c * c, m[8] += t_weight * c * d;
+        m[9] += t_weight * d * d;
+    }
+
+    void add(const MeshSimplifierQuadric &t_quadric)
+    {
+        for (u8 i = 0; i < 10; i++)
+            m[i] += t_quadric.m[i];
+    }
+
+    /** Sum of weighted squared distances of point to planes */
+    float evaluate(const Vector3 &p) const
+    {
+        return m[0] * p.x * p.x + 2.0F * m[1] * p.x * p.y + 2.0F * m[2] * p.x * p.z + 2.0F * m[3] * p.x +
+               m[4] * p.y * p.y + 2.0F * m[5] * p.y * p.z + 2.0F * m[6] * p.y +
+               m[7] * p.z * p.z + 2.0F * m[8] * p.z +
+               m[9];
+    }
+};
+
+/** Collapse of vertex "from" into vertex "to" */
+struct MeshSimplifierCollapse
+{
+    float cost;
+    u32 from, to;
+    /** Versions of vertices, when cost was calculated. Changed vertex = outdated collapse */
+    u32 fromVersion, toVersion;
+    /** Lowest cost on top */
+    bool operator<(const MeshSimplifierCollapse &t_collapse) const { return cost > t_collapse.cost; }
+};
+
+class MeshSimplifierContext
+{
+
+public:
+    const Vector3 *frames[MESH_SIMPLIFIER_MAX_FRAMES];
+    u32 framesCount, vertexCount, trianglesCount;
+    const u8 *locked;
+    /** 3 vertex, st and normal indexes per triangle */
+    std::vector<u32> vertices, sts, normals;
+    std::vector<u8> isTriangleAlive, isVertexAlive;
+    std::vector<u32> versions;
+    std::vector<std::vector<u32>> vertexTriangles;
+    /** framesCount quadrics per vertex */
+    std::vector<MeshSimplifierQuadric> quadrics;
+    std::priority_queue<MeshSimplifierCollapse> queue;
+    std::vector<std::pair<u32, u32>> stMap, normalMap;
+
+    u8 isLocked(const u32 &t_vertex) const { return locked != NULL && locked[t_vertex]; }
+
+    u8 hasVertex(const u32 &t_triangle, const u32 &t_vertex) const
+    {
+        return vertices[t_triangle * 3] == t_vertex || vertices[t_triangle * 3 + 1] == t_vertex || vertices[t_triangle * 3 + 2] == t_vertex;
+    }
+
+    u32 getCorner(const u32 &t_triangle, const u32 &t_vertex) const
+    {
+        for (u8 i = 0; i < 3; i++)
+            if (vertices[t_triangle * 3 + i] == t_vertex)
+                return t_triangle * 3 + i;
+        return 0;
+    }
+
+    Vector3 getNormal(const Vector3 &a, const Vector3 &b, const Vector3 &c) const
+    {
+        Vector3 ab = b - a, ac = c - a;
+        return Vector3(ab.y * ac.z - ab.z * ac.y, ab.z * ac.x - ab.x * ac.z, ab.x * ac.y - ab.y * ac.x);
+    }
+
+    void computeQuadrics()
+    {
+        quadrics.assign(vertexCount * framesCount, MeshSimplifierQuadric());
+        for (u32 i = 0; i < quadrics.size(); i++)
+            for (u8 j = 0; j < 10; j++)
+                quadrics[i].m[j] = 0.0F;
+
+        // Edges used by only one triangle are borders
+        std::vector<u64> edges;
+        edges.reserve(trianglesCount * 3);
+        for (u32 i = 0; i < trianglesCount; i++)
+            for (u8 j = 0; j < 3; j++)
+            {
+                const u64 a = vertices[i * 3 + j], b = vertices[i * 3 + (j + 1) % 3];
+                edges.push_back(a < b ? (a << 32) | b : (b << 32) | a);
+            }
+        std::sort(edges.begin(), edges.end());
+
+        for (u32 f = 0; f < framesCount; f++)
+        {
+            MeshSimplifierQuadric *frameQuadrics = &quadrics[f];
+            for (u32 i = 0; i < trianglesCount; i++)
+            {
+                const u32 *triangle = &vertices[i * 3];
+                const Vector3 &a = frames[f][triangle[0]], &b = frames[f][triangle[1]], &c = frames[f][triangle[2]];
+                Vector3 normal = getNormal(a, b, c);
+                const float length = normal.length();
+                if (length <= 0.0F)
+                    continue;
+                normal *= 1.0F / length;
+                const float d = -normal.innerProduct(a);
+                // Weighted by area
+                for (u8 j = 0; j < 3; j++)
+                    frameQuadrics[triangle[j] * framesCount].addPlane(normal.x, normal.y, normal.z, d, length * 0.5F);
+
+                for (u8 j = 0; j < 3; j++)
+                {
+                    const u64 va = triangle[j], vb = triangle[(j + 1) % 3];
+                    const u64 key = va < vb ? (va << 32) | vb : (vb << 32) | va;
+                    const std::vector<u64>::iterator edge = std::lower_bound(edges.begin(), edges.end(), key);
+                    if (edge + 1 != edges.end() && *(edge + 1) == key)
+                        continue;
+                    // Plane perpendicular to triangle, which goes through border edge
+                    const Vector3 &p0 = frames[f][va], &p1 = frames[f][vb];
+                    Vector3 direction = p1 - p0;
+                    Vector3 border(direction.y * normal.z - direction.z * normal.y,
+                                   direction.z * normal.x - direction.x * normal.z,
+                                   direction.x * normal.y - direction.y * normal.x);
+                    const float borderLength = border.length();
+                    if (borderLength <= 0.0F)
+                        continue;
+                    border *= 1.0F / borderLength;
+                    const float borderD = -border.innerProduct(p0);
+                    const float weight = MESH_SIMPLIFIER_BORDER_WEIGHT * direction.innerProduct(direction);
+                    frameQuadrics[va * framesCount].addPlane(border.x, border.y, border.z, borderD, weight);
+                    frameQuadrics[vb * framesCount].addPlane(border.x, border.y, border.z, borderD, weight);
+                }
+            }
+        }
+    }
+
+    float getCost(const u32 &t_from, const u32 &t_to) const
+    {
+        float result = 0.0F;
+        for (u32 f = 0; f < framesCount; f++)
+        {
+            MeshSimplifierQuadric quadric = quadrics[t_from * framesCount + f];
+            quadric.add(quadrics[t_to * framesCount + f]);
+            result += quadric.evaluate(frames[f][t_to]);
+        }
+        return result;
+    }
+
+    void push(const u32 &t_from, const u32 &t_to)
+    {
+        if (isLocked(t_from))
+            return;
+        MeshSimplifierCollapse collapse;
+        collapse.cost = getCost(t_from, t_to);
+        collapse.from = t_from;
+        collapse.to = t_to;
+        collapse.fromVersion = versions[t_from];
+        collapse.toVersion = versions[t_to];
+        queue.push(collapse);
+    }
+
+    /** Edge have to still exist and no triangle can flip or become degenerate (checked in first frame) */
+    u8 canCollapse(const u32 &t_from, const u32 &t_to) const
+    {
+        const std::vector<u32> &triangles = vertexTriangles[t_from];
+        u8 isEdgePresent = false;
+        for (u32 i = 0; i < triangles.size(); i++)
+        {
+            const u32 &triangle = triangles[i];
+            if (!isTriangleAlive[triangle])
+                continue;
+            if (hasVertex(triangle, t_to))
+            {
+                isEdgePresent = true;
+                continue;
+            }
+            const u32 corner = getCorner(triangle, t_from);
+            const u32 base = triangle * 3;
+            Vector3 points[3];
+            for (u8 j = 0; j < 3; j++)
+                points[j] = frames[0][vertices[base + j]];
+            const Vector3 before = getNormal(points[0], points[1], points[2]);
+            points[corner - base] = frames[0][t_to];
+            const Vector3 after = getNormal(points[0], points[1], points[2]);
+            const float afterLength = after.innerProduct(after);
+            if (after.innerProduct(before) <= 0.0F || afterLength <= 0.000001F * before.innerProduct(before))
+                return false;
+        }
+        return isEdgePresent;
+    }
+
+    u32 findMapped(const std::vector<std::pair<u32, u32>> &t_map, const u32 &t_index, const u32 &t_fallback) const
+    {
+        for (u32 i = 0; i < t_map.size(); i++)
+            if (t_map[i].first == t_index)
+                return t_map[i].second;
+        return t_fallback;
+    }
+
+    /** @returns Count of removed triangles */
+    u32 collapse(const u32 &t_from, const u32 &t_to)
+    {
+        std::vector<u32> &triangles = vertexTriangles[t_from];
+        std::vector<u32> &toTriangles = vertexTriangles[t_to];
+        u32 removed = 0;
+        stMap.clear();
+        normalMap.clear();
+
+        // Triangles with both vertices are removed. Their corners tell, which st/normal of "to"
+        // should replace st/normal of "from", so texture seams are kept
+        for (u32 i = 0; i < triangles.size(); i++)
+        {
+            const u32 &triangle = triangles[i];
+            if (!isTriangleAlive[triangle] || !hasVertex(triangle, t_to))
+                continue;
+            const u32 from = getCorner(triangle, t_from), to = getCorner(triangle, t_to);
+            stMap.push_back(std::make_pair(sts[from], sts[to]));
+            normalMap.push_back(std::make_pair(normals[from], normals[to]));
+            isTriangleAlive[triangle] = false;
+            removed++;
+        }
+
+        u32 fallback = 0;
+        for (u32 i = 0; i < toTriangles.size(); i++)
+            if (isTriangleAlive[toTriangles[i]])
+            {
+                fallback = getCorner(toTriangles[i], t_to);
+                break;
+            }
+
+        for (u32 i = 0; i < triangles.size(); i++)
+        {
+            const u32 &triangle = triangles[i];
+            if (!isTriangleAlive[triangle])
+                continue;
+            const u32 corner = getCorner(triangle, t_from);
+            vertices[corner] = t_to;
+            sts[corner] = findMapped(stMap, sts[corner], sts[fallback]);
+            normals[corner] = findMapped(normalMap, normals[corner], normals[fallback]);
+            toTriangles.push_back(triangle);
+        }
+        triangles.clear();
+
+        for (u32 f = 0; f < framesCount; f++)
+            quadrics[t_to * framesCount + f].add(quadrics[t_from * framesCount + f]);
+        isVertexAlive[t_from] = false;
+        versions[t_to]++;
+
+        // Remove dead triangles and update costs of edges of "to".
+        // Collapses between other vertices have unchanged cost
+        u32 alive = 0;
+        for (u32 i = 0; i < toTriangles.size(); i++)
+            if (isTriangleAlive[toTriangles[i]])
+                toTriangles[alive++] = toTriangles[i];
+        toTriangles.resize(alive);
+        for (u32 i = 0; i < toTriangles.size(); i++)
+            for (u8 j = 0; j < 3; j++)
+            {
+                const u32 &neighbour = vertices[toTriangles[i] * 3 + j];
+                if (neighbour == t_to)
+                    continue;
+                push(t_to, neighbour);
+                push(neighbour, t_to);
+            }
+        return removed;
+    }
+};
+
+u32 MeshSimplifier::simplify(const Vector3 *const *t_frames, const u32 &t_framesCount, const u32 &t_vertexCount,
+                             const u32 *t_vertexFaces, const u32 *t_stFaces, const u32 *t_normalFaces, const u32 &t_facesCount,
+                             const u8 *t_lockedVertices, const u32 &t_targetFacesCount,
+                             u32 *o_vertexFaces, u32 *o_stFaces, u32 *o_normalFaces)
+{
+    MeshSimplifierContext context;
+    context.framesCount = Math::min(t_framesCount, MESH_SIMPLIFIER_MAX_FRAMES);
+    for (u32 i = 0; i < context.framesCount; i++)
+        context.frames[i] = t_frames[i * t_framesCount / context.framesCount];
+    context.vertexCount = t_vertexCount;
+    context.trianglesCount = t_facesCount / 3;
+    context.locked = t_lockedVertices;
+    context.vertices.assign(t_vertexFaces, t_vertexFaces + context.trianglesCount * 3);
+    context.sts.assign(t_stFaces, t_stFaces + context.trianglesCount * 3);
+    context.normals.assign(t_normalFaces, t_normalFaces + context.trianglesCount * 3);
+    context.isTriangleAlive.assign(context.trianglesCount, true);
+    context.isVertexAlive.assign(t_vertexCount, true);
+    context.versions.assign(t_vertexCount, 0);
+    context.vertexTriangles.resize(t_vertexCount);
+    for (u32 i = 0; i < context.trianglesCount; i++)
+        for (u8 j = 0; j < 3; j++)
+            context.vertexTriangles[context.vertices[i * 3 + j]].push_back(i);
+
+    context.computeQuadrics();
+    for (u32 i = 0; i < context.trianglesCount; i++)
+        for (u8 j = 0; j < 3; j++)
+        {
+            const u32 &a = context.vertices[i * 3 + j], &b = context.vertices[i * 3 + (j + 1) % 3];
+            context.push(a, b);
+            context.push(b, a);
+        }
+
+    u32 trianglesLeft = context.trianglesCount;
+    const u32 targetTriangles = t_targetFacesCount / 3;
+    while (trianglesLeft > targetTriangles && !context.queue.empty())
+    {
+        const MeshSimplifierCollapse collapse = context.queue.top();
+        context.queue.pop();
+        if (!context.isVertexAlive[collapse.from] || !context.isVertexAlive[collapse.to] ||
+            context.versions[collapse.from] != collapse.fromVersion || context.versions[collapse.to] != collapse.toVersion ||
+            !context.canCollapse(collapse.from, collapse.to))
+            continue;
+        trianglesLeft -= context.collapse(collapse.from, collapse.to);
+    }
+
+    u32 result = 0;
+    for (u32 i = 0; i < context.trianglesCount; i++)
+    {
+        if (!context.isTriangleAlive[i])
+            continue;
+        for (u8 j = 0; j < 3; j++, result++)
+        {
+            o_vertexFaces[result] = context.vertices[i * 3 + j];
+            o_stFaces[result] = context.sts[i * 3 + j];
+            o_normalFaces[result] = context.normals[i * 3 + j];
+        }
+    }
+    return result;
+}
@@ -0,0 +1,148 @@
+/*
+# ______       ____   ___
+#   |     \/   ____| |___|    
+#   |     |   |   \  |   |       
+#-----------------------------------------------------------------------
+# Copyright 2020, tyra - https://github.com/h4570/tyra
+# Licenced under Apache License 2.0
+# Sandro Sobczyński <sandro.sobczynski@gmail.com>
+*/
+
+#include "../include/utils/quantizer.hpp"
+
+#include <vector>
+#include <algorithm>
+
+struct QuantizerBox
+{
+    u32 start, end;
+    u8 channel, range;
+};
+
+/** Sorts pixel indexes by one channel */
+struct QuantizerChannelLess
+{
+    const u8 *pixels;
+    u8 channel;
+    bool operator()(const u32 &a, const u32 &b) const { return pixels[a * 4 + channel] < pixels[b * 4 + channel]; }
+};
+
+/** Finds channel with biggest range of values */
+static void measureBox(QuantizerBox &t_box, const u8 *t_pixels, const std::vector<u32> &t_order)
+{
+    u8 min[4] = {255, 255, 255, 255};
+    u8 max[4] = {0, 0, 0, 0};
+    for (u32 i = t_box.start; i < t_box.end; i++)
+        for (u32 c = 0; c < 4; c++)
+        {
+            const u8 value = t_pixels[t_order[i] * 4 + c];
+            if (value < min[c])
+                min[c] = value;
+            if (value > max[c])
+                max[c] = value;
+        }
+    t_box.channel = 0;
+    t_box.range = 0;
+    for (u32 c = 0; c < 4; c++)
+        if (max[c] - min[c] > t_box.range)
+        {
+            t_box.range = max[c] - min[c];
+            t_box.channel = c;
+        }
+}
+
+// ----
+// Methods
+// ----
+
+u32 Quantizer::medianCut(const u8 *t_pixels, const u32 &t_pixelsCount, const u32 &t_maxColors, u8 *o_palette, u8 *o_indexes)
+{
+    if (t_pixelsCount == 0 || t_maxColors == 0)
+        return 0;
+    std::vector<u32> order(t_pixelsCount);
+    for (u32 i = 0; i < t_pixelsCount; i++)
+        order[i] = i;
+
+    std::vector<QuantizerBox> boxes;
+    QuantizerBox first;
+    first.start = 0;
+    first.end = t_pixelsCount;
+    measureBox(first, t_pixels, order);
+    boxes.push_back(first);
+
+    while (boxes.size() < t_maxColors)
+    {
+        // Split box with biggest range. Box with range 0 contains single color
+        u32 boxIndex = 0;
+        for (u32 i = 1; i < boxes.size(); i++)
+            if (boxes[i].range > boxes[boxIndex].range)
+                boxIndex = i;
+        QuantizerBox &box = boxes[boxIndex];
+        if (box.range == 0)
+            break;
+
+        QuantizerChannelLess less;
+        less.pixels = t_pixels;
+        less.channel = box.channel;
+        std::sort(order.begin() + box.start, order.begin() + box.end, less);
+
+        // Move median to the nearest change of value, so the same color is not in both boxes
+        u32 median = box.start + (box.end - box.start) / 2;
+        while (median < box.end && !less(order[median - 1], order[median]))
+            median++;
+        if (median == box.end)
+        {
+            median = box.start + (box.end - box.start) / 2;
+            while (!less(order[median - 1], order[median]))
+                median--;
+        }
+
+        QuantizerBox second;
+        second.start = median;
+        second.end = box.end;
+        box.end = median;
+        measureBox(box, t_pixels, order);
+        measureBox(second, t_pixels, order);
+        boxes.push_back(second);
+    }
+
+    for (u32 i = 0; i < boxes.size(); i++)
+    {
+        u32 sum[4] = {0, 0, 0, 0};
+        for (u32 j = boxes[i].start; j < boxes[i].end; j++)
+            for (u32 c = 0; c < 4; c++)
+                sum[c] += t_pixels[order[j] * 4 + c];
+        const u32 count = boxes[i].end - boxes[i].start;
+        for (u32 c = 0; c < 4; c++)
+            o_palette[i * 4 + c] = static_cast<u8>((sum[c] + count / 2) / count);
+    }
+
+    // Average color of box is not always the nearest one, so search whole palette
+    for (u32 i = 0; i < t_pixelsCount; i++)
+        o_indexes[i] = findNearest(o_palette, boxes.size(), &t_pixels[i * 4]);
+
+    return boxes.size();
+}
+
+u8 Quantizer::findNearest(const u8 *t_palette, const u32 &t_colorsCount, const u8 *t_color)
+{
+    u8 result = 0;
+    u32 bestDistance = 0xFFFFFFFF;
+    for (u32 i = 0; i < t_colorsCount; i++)
+    {
+        u32 distance = 0;
+        for (u32 c = 0; c < 4; c++)
+        {
+            const s32 diff = (s32)t_palette[i * 4 + c] - (s32)t_color[c];
+            distance += diff * diff;
+        }
+        if (distance < bestDistance)
+        {
+            bestDistance = distance;
+            result = i;
+            if (distance == 0)
+                break;
+        }
+    }
+    return result;
+}
@@ -0,0 +1,161 @@
+/*
+# ______       ____   ___
+#   |     \/   ____| |___|    
+#   |     |   |   \  |   |       
+#-----------------------------------------------------------------------
+# Copyright 2020, tyra - https://github.com/h4570/tyra
+# Licenced under Apache License 2.0
+# Sandro Sobczyński <sandro.sobczynski@gmail.com>
+*/
+
+#include "../include/utils/stripifier.hpp"
+
+#include <vector>
+#include <algorithm>
+
+struct StripifierEdge
+{
+    u32 a, b, triangle;
+    /** Vertex, where edge starts in its triangle (triangle winding) */
+    u32 from;
+};
+
+/** Sorts faces by vertex, st and normal index */
+struct StripifierFaceLess
+{
+    const u32 *vertexFaces, *stFaces, *normalFaces;
+    bool operator()(const u32 &a, const u32 &b) const
+    {
+        if (vertexFaces[a] != vertexFaces[b])
+            return vertexFaces[a] < vertexFaces[b];
+        if (stFaces[a] != stFaces[b])
+            return stFaces[a] < stFaces[b];
+        return normalFaces[a] < normalFaces[b];
+    }
+};
+
+/** Sorts edges by their (lower first) vertices */
+struct StripifierEdgeLess
+{
+    bool operator()(const StripifierEdge &a, const StripifierEdge &b) const
+    {
+        if (a.a != b.a)
+            return a.a < b.a;
+        return a.b < b.b;
+    }
+};
+
+/** Returns not used triangle, which goes from t_from to t_to vertex. -1 if not found */
+static s32 findNeighbour(const std::vector<StripifierEdge> &t_edges, const u32 &t_from, const u32 &t_to, const std::vector<u8> &t_used)
+{
+    StripifierEdge edge;
+    edge.a = t_from < t_to ? t_from : t_to;
+    edge.b = t_from < t_to ? t_to : t_from;
+    std::vector<StripifierEdge>::const_iterator it = std::lower_bound(t_edges.begin(), t_edges.end(), edge, StripifierEdgeLess());
+    for (; it != t_edges.end() && it->a == edge.a && it->b == edge.b; it++)
+        if (!t_used[it->triangle] && it->from == t_from)
+            return it->triangle;
+    return -1;
+}
+
+/**
+ * Adds faces of triangles, which continue strip ending with t_a, t_b vertices.
+ * Winding of every second strip triangle is reversed, so only neighbours
+ * with matching winding are added (needed by backface culling).
+ * Added triangles are marked as used.
+ */
+static void walkStrip(const std::vector<StripifierEdge> &t_edges, const std::vector<u32> &t_ids, u32 t_a, u32 t_b, std::vector<u8> &t_used, std::vector<u32> &o_faces)
+{
+    for (u32 stripTriangle = 1;; stripTriangle++)
+    {
+        const s32 neighbour = stripTriangle & 1 ? findNeighbour(t_edges, t_b, t_a, t_used) : findNeighbour(t_edges, t_a, t_b, t_used);
+        if (neighbour == -1)
+            return;
+        const u32 triangle = static_cast<u32>(neighbour);
+        s32 third = -1;
+        for (u32 i = triangle * 3; i < triangle * 3 + 3; i++)
+            if (t_ids[i] != t_a && t_ids[i] != t_b)
+                third = i;
+        if (third == -1) // degenerated triangle
+            return;
+        t_used[triangle] = true;
+        o_faces.push_back(third);
+        t_a = t_b;
+        t_b = t_ids[third];
+    }
+}
+
+// ----
+// Methods
+// ----
+
+u32 Stripifier::generate(const u32 *t_vertexFaces, const u32 *t_stFaces, const u32 *t_normalFaces, const u32 &t_facesCount, u32 *o_faces, u8 *o_restarts)
+{
+    const u32 trianglesCount = t_facesCount / 3;
+    if (trianglesCount == 0)
+        return 0;
+
+    // Unique vertex id of every face
+    std::vector<u32> order(trianglesCount * 3);
+    for (u32 i = 0; i < order.size(); i++)
+        order[i] = i;
+    StripifierFaceLess faceLess;
+    faceLess.vertexFaces = t_vertexFaces;
+    faceLess.stFaces = t_stFaces;
+    faceLess.normalFaces = t_normalFaces;
+    std::sort(order.begin(), order.end(), faceLess);
+    std::vector<u32> ids(order.size());
+    u32 id = 0;
+    for (u32 i = 0; i < order.size(); i++)
+    {
+        if (i != 0 && faceLess(order[i - 1], order[i]))
+            id++;
+        ids[order[i]] = id;
+    }
+
+    std::vector<StripifierEdge> edges(trianglesCount * 3);
+    for (u32 i = 0; i < trianglesCount; i++)
+        for (u32 j = 0; j < 3; j++)
+        {
+            const u32 a = ids[i * 3 + j];
+            const u32 b = ids[i * 3 + (j + 1) % 3];
+            edges[i * 3 + j].a = a < b ? a : b;
+            edges[i * 3 + j].b = a < b ? b : a;
+            edges[i * 3 + j].triangle = i;
+            edges[i * 3 + j].from = a;
+        }
+    std::sort(edges.begin(), edges.end(), StripifierEdgeLess());
+
+    std::vector<u8> used(trianglesCount, false);
+    std::vector<u32> strip, bestStrip;
+    u32 result = 0;
+    for (u32 i = 0; i < trianglesCount; i++)
+    {
+        if (used[i])
+            continue;
+        used[i] = true;
+        // Try every start edge of triangle and keep the longest strip
+        bestStrip.clear();
+        for (u32 j = 0; j < 3; j++)
+        {
+            strip.clear();
+            strip.push_back(i * 3 + j);
+            strip.push_back(i * 3 + (j + 1) % 3);
+            strip.push_back(i * 3 + (j + 2) % 3);
+            walkStrip(edges, ids, ids[strip[1]], ids[strip[2]], used, strip);
+            for (u32 k = 3; k < strip.size(); k++) // only a try, so unmark
+                used[strip[k] / 3] = false;
+            if (strip.size() > bestStrip.size())
+                bestStrip.swap(strip);
+        }
+        for (u32 k = 3; k < bestStrip.size(); k++)
+            used[bestStrip[k] / 3] = true;
+        for (u32 k = 0; k < bestStrip.size(); k++)
+        {
+            o_faces[result] = bestStrip[k];
+            o_restarts[result] = k < 2;
+            result++;
+        }
+    }
+    return result;
+}
@@ -0,0 +1,70 @@
+/*
+# ______       ____   ___
+#   |     \/   ____| |___|    
+#   |     |   |   \  |   |       
+#-----------------------------------------------------------------------
+# Copyright 2020, tyra - https://github.com/h4570/tyra
+# Licenced under Apache License 2.0
+# Sandro Sobczyński <sandro.sobczynski@gmail.com>
+*/
+
+
+#include "../include/utils/vertex_quantizer.hpp"
+
+// ----
+// Methods
+// ----
+
+void VertexQuantizer::getBounds(const VECTOR *t_values, const u32 &t_count, const u8 &t_components, VECTOR o_scale, VECTOR o_offset)
+{
+    for (u8 c = 0; c < 4; c++)
+    {
+        o_scale[c] = 1.0F;
+        o_offset[c] = 0.0F;
+    }
+    if (t_count == 0)
+        return;
+    for (u8 c = 0; c < t_components; c++)
+    {
+        float min = t_values[0][c], max = t_values[0][c];
+        for (u32 i = 1; i < t_count; i++)
+        {
+            if (t_values[i][c] < min)
+                min = t_values[i][c];
+            if (t_values[i][c] > max)
+                max = t_values[i][c];
+        }
+        o_offset[c] = (min + max) * 0.5F;
+        // Flat box keeps scale 1, so all values are quantized to 0 without division by 0
+        if (max > min)
+            o_scale[c] = (max - min) * 0.5F / VERTEX_QUANTIZER_MAX;
+    }
+}
+
+void VertexQuantizer::quantizeVertices(const VECTOR *t_vertices, const u32 &t_count, const VECTOR t_scale, const VECTOR t_offset, s16 *o_result)
+{
+    for (u32 i = 0; i < t_count; i++)
+    {
+        for (u8 c = 0; c < 3; c++)
+            o_result[i * 4 + c] = quantize(t_vertices[i][c], t_scale[c], t_offset[c]);
+        o_result[i * 4 + 3] = 1;
+    }
+}
+
+void VertexQuantizer::quantizeCoordinates(const VECTOR *t_coordinates, const u32 &t_count, const VECTOR t_scale, const VECTOR t_offset, s16 *o_result)
+{
+    for (u32 i = 0; i < t_count; i++)
+        for (u8 c = 0; c < 2; c++)
+            o_result[i * 2 + c] = quantize(t_coordinates[i][c], t_scale[c], t_offset[c]);
+}
+
+s16 VertexQuantizer::quantize(const float &t_value, const float &t_scale, const float &t_offset)
+{
+    const float scaled = (t_value - t_offset) / t_scale;
+    // Values out of bounding box are clamped
+    if (scaled >= VERTEX_QUANTIZER_MAX)
+        return VERTEX_QUANTIZER_MAX;
+    if (scaled <= -VERTEX_QUANTIZER_MAX)
+        return -VERTEX_QUANTIZER_MAX;
+    return static_cast<s16>(scaled < 0.0F ? scaled - 0.5F : scaled + 0.5F);
+}
@@ -10,10 +10,13 @@
 
 #include "cubes.hpp"
 
+#include <stdio.h>
+
 Cubes::Cubes(Engine *t_engine)
     : engine(t_engine), camera(&t_engine->screen)
 {
     consoleLog("Initing cubes sample");
+    frame = 0;
 }
 
 Cubes::~Cubes()
@@ -34,6 +37,19 @@ void Cubes::onUpdate()
     camera.update(engine->pad, cube->mesh);
     cube->update(engine->pad, camera);
     engine->renderer->draw(cube->mesh);
+    if (++frame == CUBES_STATS_FRAMES)
+    {
+        frame = 0;
+        printRenderQueueStats();
+    }
+}
+
+/** Stats of render queue sorted in last frame */
+void Cubes::printRenderQueueStats()
+{
+    const RenderQueueStats &stats = engine->renderer->getRenderQueueStats();
+    printf("Render queue: %d items, %d state changes (%d without sorting)\n",
+           (int)stats.items, (int)stats.sortedStateChanges, (int)stats.unsortedStateChanges);
 }
 
 void Cubes::setBgColorAndAmbientColor()
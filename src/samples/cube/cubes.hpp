@@ -18,6 +18,9 @@
 #include "camera.hpp"
 #include "objects/cube.hpp"
 
+/** Render queue stats are printed every this count of frames. */
+const u32 CUBES_STATS_FRAMES = 120;
+
 class Cubes : public Game
 {
 
@@ -32,6 +35,8 @@ class Cubes : public Game
 
     private:
         void setBgColorAndAmbientColor();
+        void printRenderQueueStats();
+        u32 frame;
         TextureRepository *texRepo;
         Cube *cube;
         Camera camera;
@@ -21,6 +21,7 @@ Dolphin::Dolphin(Engine *t_engine) : engine(t_engine), camera(&engine->screen)
 {
     oysters = new Collectible[OYSTERS_COUNT];
     mines = new Mine[MINES_COUNT];
+    isBenchmarkRunning = false;
 }
 
 Dolphin::~Dolphin()
@@ -58,6 +59,8 @@ void Dolphin::onInit()
     island.position.set(0.0F, 60.0F, 20.0F);
     island.shouldBeBackfaceCulled = true;
     island.shouldBeFrustumCulled = false;
+    island.lod.calculation = LOD_USE_FORMULA; // Big mesh, so mip level is calculated per pixel
+    island.setMipmapping(150.0F);
 
     gameOver.size.set(640.0F, 480.0F);
     Texture *gameOverTex = texRepo->add("2d/", "gameover", PNG);
@@ -94,10 +97,14 @@ void Dolphin::onInit()
 
     printf("Loading seabed...\n");
     seabed.loadObj("seabed/", "seabed", 10.0F, false);
+    seabed.lod.calculation = LOD_USE_FORMULA;
+    seabed.setMipmapping(150.0F);
     seabed.position.set(0, -250.0F, 0);
     texRepo->addByMesh("seabed/", seabed, BMP);
     seabed.shouldBeBackfaceCulled = false;
     seabed.shouldBeFrustumCulled = false;
+    seabed.setStatic(true);
+    engine->renderer->bake(seabed);
 
     skybox.loadObj("skybox/", "skybox", 400.0F, false);
     skybox.shouldBeFrustumCulled = false;
@@ -166,6 +173,8 @@ void Dolphin::onInit()
 
 void Dolphin::onUpdate()
 {
+    updateCullingBenchmark();
+
     if (player.getLifes() <= 0)
     {
         engine->audio.stopSong();
@@ -270,6 +279,40 @@ void Dolphin::onUpdate()
     }
 }
 
+/**
+ * Circle starts benchmark of backface culling.
+ * Scene is drawn with EE culling, then with VU1 culling,
+ * and average frame time of both modes is printed.
+ */
+void Dolphin::updateCullingBenchmark()
+{
+    if (!isBenchmarkRunning)
+    {
+        if (!engine->pad.isCircleClicked)
+            return;
+        printf("Backface culling benchmark started\n");
+        isBenchmarkRunning = true;
+        benchmarkFrame = 0;
+        benchmarkTicks[0] = 0;
+        benchmarkTicks[1] = 0;
+        engine->renderer->disableVU1BackfaceCulling();
+        benchmarkTimer.prime();
+        return;
+    }
+    // Measured frame was drawn in mode set by previous call
+    benchmarkTicks[benchmarkFrame >= DOLPHIN_BENCHMARK_FRAMES] += benchmarkTimer.getTimeDelta();
+    benchmarkTimer.prime();
+    if (++benchmarkFrame == DOLPHIN_BENCHMARK_FRAMES)
+        engine->renderer->enableVU1BackfaceCulling();
+    else if (benchmarkFrame == DOLPHIN_BENCHMARK_FRAMES * 2)
+    {
+        printf("EE culling: %d ticks/frame\n", (int)(benchmarkTicks[0] / DOLPHIN_BENCHMARK_FRAMES));
+        printf("VU1 culling: %d ticks/frame\n", (int)(benchmarkTicks[1] / DOLPHIN_BENCHMARK_FRAMES));
+        engine->renderer->disableVU1BackfaceCulling();
+        isBenchmarkRunning = false;
+    }
+}
+
 void Dolphin::calcSpiral(int X, int Y)
 {
     int x, y, dx;
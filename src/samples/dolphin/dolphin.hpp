@@ -23,6 +23,9 @@
 #include "./objects/collectible.hpp"
 #include "./objects/mine.hpp"
 
+/** Frames measured per backface culling mode. */
+const u32 DOLPHIN_BENCHMARK_FRAMES = 300;
+
 class Dolphin : public Game
 {
 
@@ -38,6 +41,7 @@ public:
 
 private:
     void calcSpiral(int X, int Y);
+    void updateCullingBenchmark();
     static const u16 WATER_TILES_COUNT = 1024;
 
     Point spirals[WATER_TILES_COUNT];
@@ -64,6 +68,9 @@ private:
     audsrv_adpcm_t *pickupSound;
     audsrv_adpcm_t *boomSound;
     Mine *mines;
+    Timer benchmarkTimer;
+    u32 benchmarkFrame, benchmarkTicks[2];
+    u8 isBenchmarkRunning;
 };
 
 #endif
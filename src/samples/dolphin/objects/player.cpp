@@ -24,6 +24,7 @@ Player::Player()
     mesh.position.set(0.0F, 0.0F, 10.0f);
     mesh.rotation.x = -1.6F;
     mesh.setAnimSpeed(0.04F);
+    mesh.setAnimationOnVU1(true);
     bIsJumping = false;
     lifes = 3;
 }
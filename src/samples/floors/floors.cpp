@@ -10,17 +10,20 @@
 
 #include "floors.hpp"
 
+#include <stdio.h>
+
 // ----
 // Constructors/Destructors
 // ----
 
-const u16 FLOORS_COUNT = 144; // Temp change it also in floor_manager.hpp
+const u16 FLOORS_COUNT = 256; // Temp change it also in floor_manager.hpp
 
 Floors::Floors(Engine *t_engine)
     : engine(t_engine), floorManager(), camera(&t_engine->screen)
 {
     audioTicks = 0;
     skip1Beat = 0;
+    frame = 0;
 }
 
 Floors::~Floors()
@@ -61,11 +64,17 @@ void Floors::onUpdate()
     engine->renderer->draw(player->mesh);
     engine->renderer->draw(enemy->getMeshes(), enemy->getMeshesCount());
 
-    // You can draw array of meshes in draw() function also. It can be A LOT faster than for looping!
-    // Why? When given mesh is small, is not animated and is not backface culled, vertex data are send once!
-    engine->renderer->draw(floorManager->getMeshes(), FLOORS_COUNT, lightManager.bulbs, lightManager.bulbsCount);
+    // All floors share the same mesh, so they can be drawn as instances. It is A LOT faster than for looping!
+    // Why? Vertex data are calculated and sent once, then only matrix and color per floor.
+    engine->renderer->drawInstanced(floorManager->floors[0].mesh, floorManager->getInstances(), FLOORS_COUNT);
 
     ui->render(engine->renderer); // 2D rendering ist LAST step, because layers gonna play there.
+
+    if (++frame == FLOORS_STATS_FRAMES)
+    {
+        frame = 0;
+        printRenderQueueStats();
+    }
 }
 
 void Floors::onAudioTick()
@@ -92,6 +101,17 @@ void Floors::setBgColorAndAmbientColor()
     engine->renderer->setAmbientLight(ambient);
 }
 
+/**
+ * Stats of render queue sorted in last frame.
+ * Only player and enemy go via render queue, floors are drawn as instances.
+ */
+void Floors::printRenderQueueStats()
+{
+    const RenderQueueStats &stats = engine->renderer->getRenderQueueStats();
+    printf("Render queue: %d items, %d state changes (%d without sorting)\n",
+           (int)stats.items, (int)stats.sortedStateChanges, (int)stats.unsortedStateChanges);
+}
+
 void Floors::onAudioFinish()
 {
     audioTicks = 0;
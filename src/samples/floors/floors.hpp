@@ -22,6 +22,9 @@
 #include "./camera.hpp"
 #include "./ui.hpp"
 
+/** Render queue stats are printed every this count of frames. */
+const u32 FLOORS_STATS_FRAMES = 120;
+
 class Floors : public Game, AudioListener
 {
 
@@ -38,7 +41,8 @@ public:
 
 private:
     void setBgColorAndAmbientColor();
-    u32 audioTicks;
+    void printRenderQueueStats();
+    u32 audioTicks, frame;
     u8 skip1Beat;
     TextureRepository *texRepo;
     LightManager lightManager;
@@ -24,6 +24,7 @@
 FloorManager::FloorManager(int t_floorAmount, TextureRepository *t_texRepo)
 {
     meshes = new Mesh *[t_floorAmount];
+    instances = new MeshInstance[t_floorAmount];
     texRepo = t_texRepo;
     floorAmount = t_floorAmount;
     spirals = new Point[t_floorAmount];
@@ -39,6 +40,7 @@ FloorManager::FloorManager(int t_floorAmount, TextureRepository *t_texRepo)
 FloorManager::~FloorManager()
 {
     delete[] spirals;
+    delete[] instances;
 }
 
 // ----
@@ -86,6 +88,7 @@ void FloorManager::initFloors()
     floors[0].mesh.loadObj("meshes/floor/", "floor", 3.0F, false);
     floors[0].mesh.shouldBeFrustumCulled = true;
     floors[0].mesh.shouldBeLighted = true;
+    floors[0].mesh.shouldBeClipped = true; // big floor triangles cross near plane
     meshes[0] = &floors[0].mesh;
     texRepo->addByMesh("meshes/floor/", floors[0].mesh, BMP);
     for (u16 i = 1; i < floorAmount; i++)
@@ -136,6 +139,10 @@ void FloorManager::update(Player &t_player)
             material->color.g = defaultColor.g;
             material->color.b = defaultColor.b;
         }
+        instances[i].position = floors[i].mesh.position;
+        instances[i].rotation = floors[i].mesh.rotation;
+        instances[i].scale = 1.0F;
+        instances[i].color = material->color;
     }
 }
 
@@ -17,6 +17,7 @@ class Player; // Forward definition
 #include <modules/texture_repository.hpp>
 #include <modules/camera_base.hpp>
 #include <models/audio_listener.hpp>
+#include <models/mesh_instance.hpp>
 
 #include "../objects/floor.hpp"
 
@@ -27,14 +28,17 @@ class FloorManager
 public:
     FloorManager(int t_floorAmount, TextureRepository *t_texRepo);
     ~FloorManager();
-    Floor floors[144]; // Temp change it also in floors.cpp
+    Floor floors[256]; // Temp change it also in floors.cpp
     u16 floorAmount;
     void update(Player &t_player);
     void onAudioTick();
     Mesh **getMeshes() { return meshes; }
+    /** Positions and colors of floors, for Renderer::drawInstanced() */
+    MeshInstance *getInstances() { return instances; }
 
 private:
     Mesh **meshes;
+    MeshInstance *instances;
     TextureRepository *texRepo;
     u8 audioOffset, audioMode;
     u32 audioTick;
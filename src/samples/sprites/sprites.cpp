@@ -0,0 +1,93 @@
+/*
+# ______       ____   ___
+#   |     \/   ____| |___|    
+#   |     |   |   \  |   |       
+#-----------------------------------------------------------------------
+# Copyright 2020, tyra - https://github.com/h4570/tyra
+# Licenced under Apache License 2.0
+# Sandro Sobczyński <sandro.sobczynski@gmail.com>
+*/
+
+#include "sprites.hpp"
+
+#include <dma.h>
+#include <stdio.h>
+
+Sprites::Sprites(Engine *t_engine) : engine(t_engine)
+{
+    consoleLog("Initing sprites sample");
+}
+
+Sprites::~Sprites() {}
+
+void Sprites::onInit()
+{
+    TextureRepository *texRepo = engine->renderer->getTextureRepository();
+    Texture *textures[SPRITES_TEXTURES_COUNT];
+    textures[0] = texRepo->add("sprites/", "1", PNG);
+    textures[1] = texRepo->add("sprites/", "2", PNG);
+    textures[2] = texRepo->add("sprites/", "3", PNG);
+    textures[3] = texRepo->add("sprites/", "4", PNG);
+    for (u32 i = 0; i < SPRITES_MAX_COUNT; i++)
+    {
+        sprites[i].size.set(32.0F, 32.0F);
+        sprites[i].position.set((float)((i * 37) % 608), (float)((i * 61) % 416));
+        textures[i % SPRITES_TEXTURES_COUNT]->addLink(sprites[i].getId());
+    }
+    count = 100;
+    frame = 0;
+    immediateTicks = 0;
+    batchedTicks = 0;
+    isBatched = false;
+}
+
+void Sprites::onUpdate()
+{
+    moveSprites();
+    timer.prime();
+    if (isBatched)
+    {
+        for (u32 i = 0; i < count; i++)
+            engine->renderer->drawBatched(sprites[i]);
+        engine->renderer->flushSpriteBatch();
+    }
+    else
+        for (u32 i = 0; i < count; i++)
+            engine->renderer->draw(sprites[i]);
+    dma_channel_wait(DMA_CHANNEL_GIF, 0);
+    if (isBatched)
+        batchedTicks += timer.getTimeDelta();
+    else
+        immediateTicks += timer.getTimeDelta();
+
+    if (++frame < SPRITES_MEASURED_FRAMES)
+        return;
+    frame = 0;
+    if (isBatched)
+    {
+        printResults();
+        immediateTicks = 0;
+        batchedTicks = 0;
+        count = count * 2 > SPRITES_MAX_COUNT ? 100 : count * 2;
+    }
+    isBatched = !isBatched;
+}
+
+void Sprites::moveSprites()
+{
+    for (u32 i = 0; i < count; i++)
+    {
+        sprites[i].position.x += 1.0F;
+        if (sprites[i].position.x > 608.0F)
+            sprites[i].position.x = 0.0F;
+    }
+}
+
+void Sprites::printResults()
+{
+    const SpriteBatchStats &stats = engine->renderer->getSpriteBatchStats();
+    printf("Sprites: %d\n", (int)count);
+    printf("Immediate: %d ticks/frame\n", (int)(immediateTicks / SPRITES_MEASURED_FRAMES));
+    printf("Batched: %d ticks/frame (%d texture changes, %d packets)\n",
+           (int)(batchedTicks / SPRITES_MEASURED_FRAMES), (int)stats.textureChanges, (int)stats.packets);
+}
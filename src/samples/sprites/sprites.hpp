@@ -0,0 +1,55 @@
+/*
+# ______       ____   ___
+#   |     \/   ____| |___|    
+#   |     |   |   \  |   |       
+#-----------------------------------------------------------------------
+# Copyright 2020, tyra - https://github.com/h4570/tyra
+# Licenced under Apache License 2.0
+# Sandro Sobczyński <sandro.sobczynski@gmail.com>
+*/
+
+#ifndef _SPRITES_
+#define _SPRITES_
+
+#include <tamtypes.h>
+#include <game.hpp>
+#include <engine.hpp>
+#include <models/sprite.hpp>
+#include <modules/timer.hpp>
+
+/** Max sprites drawn per frame. */
+const u32 SPRITES_MAX_COUNT = 800;
+
+/** Textures shared by sprites. */
+const u32 SPRITES_TEXTURES_COUNT = 4;
+
+/** Frames measured per mode and sprites count. */
+const u32 SPRITES_MEASURED_FRAMES = 120;
+
+/**
+ * Micro-benchmark of 2D drawing.
+ * Draws N sprites via Renderer::draw(Sprite&) and via sprite batch,
+ * then prints average EE time of both ways. N is doubled after each round.
+ */
+class Sprites : public Game
+{
+
+public:
+    Sprites(Engine *t_engine);
+    ~Sprites();
+
+    void onInit();
+    void onUpdate();
+
+    Engine *engine;
+
+private:
+    Sprite sprites[SPRITES_MAX_COUNT];
+    Timer timer;
+    u32 count, frame, immediateTicks, batchedTicks;
+    u8 isBatched;
+    void moveSprites();
+    void printResults();
+};
+
+#endif
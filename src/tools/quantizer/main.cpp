@@ -0,0 +1,134 @@
+/*
+# ______       ____   ___
+#   |     \/   ____| |___|    
+#   |     |   |   \  |   |       
+#-----------------------------------------------------------------------
+# Copyright 2021, tyra - https://github.com/h4570/tyra
+# Licenced under Apache License 2.0
+# Sandro Sobczyński <sandro.sobczynski@gmail.com>
+*/
+
+/**
+ * Converts truecolor PNG into 16 or 256 colors palette PNG,
+ * which is loaded by engine as TEX_TYPE_PALETTE4/TEX_TYPE_PALETTE8 texture.
+ * Usage: quantizer <input.png> <output.png> [16|256]
+ */
+
+#include <tamtypes.h>
+#include <utils/quantizer.hpp>
+#include <png.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+static u8 readRgba(const char *t_path, std::vector<u8> &o_pixels, u32 &o_width, u32 &o_height)
+{
+    FILE *file = fopen(t_path, "rb");
+    if (file == NULL)
+        return false;
+    png_structp png = png_create_read_struct(PNG_LIBPNG_VER_STRING, NULL, NULL, NULL);
+    png_infop info = png_create_info_struct(png);
+    if (setjmp(png_jmpbuf(png)))
+    {
+        png_destroy_read_struct(&png, &info, NULL);
+        fclose(file);
+        return false;
+    }
+    png_init_io(png, file);
+    png_read_info(png, info);
+    o_width = png_get_image_width(png, info);
+    o_height = png_get_image_height(png, info);
+    const int colorType = png_get_color_type(png, info);
+    png_set_strip_16(png);
+    png_set_expand(png);
+    if (colorType == PNG_COLOR_TYPE_GRAY || colorType == PNG_COLOR_TYPE_GRAY_ALPHA)
+        png_set_gray_to_rgb(png);
+    png_set_filler(png, 0xFF, PNG_FILLER_AFTER);
+    png_read_update_info(png, info);
+    o_pixels.resize(o_width * o_height * 4);
+    std::vector<png_bytep> rows(o_height);
+    for (u32 i = 0; i < o_height; i++)
+        rows[i] = &o_pixels[i * o_width * 4];
+    png_read_image(png, &rows[0]);
+    png_read_end(png, NULL);
+    png_destroy_read_struct(&png, &info, NULL);
+    fclose(file);
+    return true;
+}
+
+static u8 writePalette(const char *t_path, const std::vector<u8> &t_indexes, const u32 &t_width, const u32 &t_height, const u8 *t_palette, const u32 &t_colorsCount, const u8 &t_bitDepth)
+{
+    FILE *file = fopen(t_path, "wb");
+    if (file == NULL)
+        return false;
+    png_structp png = png_create_write_struct(PNG_LIBPNG_VER_STRING, NULL, NULL, NULL);
+    png_infop info = png_create_info_struct(png);
+    if (setjmp(png_jmpbuf(png)))
+    {
+        png_destroy_write_struct(&png, &info);
+        fclose(file);
+        return false;
+    }
+    png_init_io(png, file);
+    png_set_IHDR(png, info, t_width, t_height, t_bitDepth, PNG_COLOR_TYPE_PALETTE, PNG_INTERLACE_NONE, PNG_COMPRESSION_TYPE_DEFAULT, PNG_FILTER_TYPE_DEFAULT);
+    png_color colors[256];
+    png_byte alphas[256];
+    u8 hasAlpha = false;
+    for (u32 i = 0; i < t_colorsCount; i++)
+    {
+        colors[i].red = t_palette[i * 4];
+        colors[i].green = t_palette[i * 4 + 1];
+        colors[i].blue = t_palette[i * 4 + 2];
+        alphas[i] = t_palette[i * 4 + 3];
+        if (alphas[i] != 0xFF)
+            hasAlpha = true;
+    }
+    png_set_PLTE(png, info, colors, t_colorsCount);
+    if (hasAlpha)
+        png_set_tRNS(png, info, alphas, t_colorsCount, NULL);
+    png_write_info(png, info);
+    png_set_packing(png); // One index per byte in rows, packed to 4bit by libpng
+    std::vector<png_bytep> rows(t_height);
+    for (u32 i = 0; i < t_height; i++)
+        rows[i] = const_cast<png_bytep>(&t_indexes[i * t_width]);
+    png_write_image(png, &rows[0]);
+    png_write_end(png, NULL);
+    png_destroy_write_struct(&png, &info);
+    fclose(file);
+    return true;
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc < 3)
+    {
+        printf("Usage: quantizer <input.png> <output.png> [16|256]\n");
+        return 1;
+    }
+    const u32 maxColors = argc > 3 ? atoi(argv[3]) : 256;
+    if (maxColors != 16 && maxColors != 256)
+    {
+        printf("Colors count have to be 16 (PSMT4) or 256 (PSMT8)\n");
+        return 1;
+    }
+
+    std::vector<u8> pixels;
+    u32 width, height;
+    if (!readRgba(argv[1], pixels, width, height))
+    {
+        printf("Failed to read %s\n", argv[1]);
+        return 1;
+    }
+
+    std::vector<u8> indexes(width * height);
+    u8 palette[256 * 4];
+    const u32 colorsCount = Quantizer::medianCut(&pixels[0], width * height, maxColors, palette, &indexes[0]);
+
+    if (!writePalette(argv[2], indexes, width, height, palette, colorsCount, maxColors == 16 ? 4 : 8))
+    {
+        printf("Failed to write %s\n", argv[2]);
+        return 1;
+    }
+    printf("%s: %dx%d, %d colors\n", argv[2], width, height, colorsCount);
+    return 0;
+}
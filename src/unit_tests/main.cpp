@@ -24,5 +24,6 @@ char const *CUSTOM_ARGV[] = {
 
 #define CATCH_CONFIG_MAIN
 #define CATCH_CONFIG_NO_POSIX_SIGNALS
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
 
 #include "catch.hpp"
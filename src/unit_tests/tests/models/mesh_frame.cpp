@@ -0,0 +1,78 @@
+/*
+# ______       ____   ___
+#   |     \/   ____| |___|    
+#   |     |   |   \  |   |       
+#-----------------------------------------------------------------------
+# Copyright 2021, tyra - https://github.com/h4570/tyra
+# Licenced under Apache License 2.0
+# Sandro Sobczyński <sandro.sobczynski@gmail.com>
+*/
+
+
+#include <catch.hpp>
+#include <models/mesh_frame.hpp>
+
+/** Animation frame with single triangle, which vertices are moved by given offset */
+static void setFrame(MeshFrame &o_frame, const float &t_offset, const u32 &t_lastST)
+{
+    o_frame.allocateVertices(3);
+    o_frame.allocateNormals(1);
+    o_frame.allocateSTs(3);
+    o_frame.allocateMaterials(1);
+    MeshMaterial &material = o_frame.getMaterial(0);
+    material.allocateFaces(3);
+    for (u8 i = 0; i < 3; i++)
+    {
+        o_frame.setVertex(i, Vector3(i + t_offset, i * 2.0F, 0.0F));
+        o_frame.setST(i, Point(i * 0.5F, 0.0F));
+        material.setVertexFace(i, i);
+        material.setNormalFace(i, 0);
+        material.setSTFace(i, i == 2 ? t_lastST : i);
+    }
+    o_frame.setNormal(0, Vector3(0.0F, 0.0F, 1.0F + t_offset));
+    material.setSTsPresent(true);
+    material.setNormalsPresent(true);
+}
+
+SCENARIO("Frames with the same faces should share topology", "[mesh_frame.cpp]")
+{
+    MeshFrame frames[3];
+    setFrame(frames[0], 0.0F, 2);
+    setFrame(frames[1], 1.0F, 2);
+    setFrame(frames[2], 2.0F, 1);
+    REQUIRE(frames[1].hasTheSameTopology(frames[0]));
+    REQUIRE(!frames[2].hasTheSameTopology(frames[0]));
+
+    frames[1].shareTopologyFrom(&frames[0]);
+    frames[1].calculateBoundingBoxes();
+    REQUIRE(frames[1].isTopologyShared());
+    REQUIRE(!frames[0].isTopologyShared());
+    REQUIRE(frames[1].getSTs() == frames[0].getSTs());
+    REQUIRE(frames[1].getMaterials() == frames[0].getMaterials());
+    REQUIRE(frames[1].getSTsCount() == 3);
+    REQUIRE(frames[1].getMaterialsCount() == 1);
+    // Positions and normals stay per frame
+    REQUIRE(frames[1].getVertices() != frames[0].getVertices());
+    REQUIRE(frames[1].getVertex(0).x == 1.0F);
+    REQUIRE(frames[1].getNormal(0).z == 2.0F);
+    REQUIRE(frames[1].getBoundingBoxVertex(7).x == 3.0F);
+}
+
+SCENARIO("Reference copy of shared frame should use the same topology", "[mesh_frame.cpp]")
+{
+    MeshFrame frames[2];
+    setFrame(frames[0], 0.0F, 2);
+    setFrame(frames[1], 1.0F, 2);
+    frames[1].shareTopologyFrom(&frames[0]);
+    frames[0].calculateBoundingBoxes();
+    frames[1].calculateBoundingBoxes();
+
+    MeshFrame copies[2];
+    copies[0].copyFrom(&frames[0]);
+    copies[1].copyFrom(&frames[1]);
+    copies[1].shareTopologyFrom(&copies[0]);
+    REQUIRE(copies[1].getMaterials() == copies[0].getMaterials());
+    REQUIRE(copies[1].getSTs() == frames[0].getSTs());
+    REQUIRE(copies[1].getVertices() == frames[1].getVertices());
+    REQUIRE(copies[1].getMaterial(0).getVertexFaces() == frames[0].getMaterial(0).getVertexFaces());
+}
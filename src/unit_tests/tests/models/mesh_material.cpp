@@ -0,0 +1,104 @@
+/*
+# ______       ____   ___
+#   |     \/   ____| |___|    
+#   |     |   |   \  |   |       
+#-----------------------------------------------------------------------
+# Copyright 2021, tyra - https://github.com/h4570/tyra
+# Licenced under Apache License 2.0
+# Sandro Sobczyński <sandro.sobczynski@gmail.com>
+*/
+
+
+#include <catch.hpp>
+#include <models/mesh_material.hpp>
+
+/** Quad of two triangles, with separate indexes of vertices, normals and texture coords */
+static void setQuad(MeshMaterial &o_material, Vector3 *o_vertices, Vector3 *o_normals, Point *o_sts)
+{
+    const u32 vertexFaces[6] = {0, 1, 2, 2, 1, 3};
+    const u32 normalFaces[6] = {0, 0, 0, 1, 1, 1};
+    const u32 stFaces[6] = {3, 2, 1, 1, 2, 0};
+    o_vertices[0].set(0.0F, 0.0F, 0.0F);
+    o_vertices[1].set(1.0F, 0.0F, 0.0F);
+    o_vertices[2].set(0.0F, 1.0F, 0.0F);
+    o_vertices[3].set(1.0F, 1.0F, 2.0F);
+    o_normals[0].set(0.0F, 0.0F, 1.0F);
+    o_normals[1].set(0.0F, 1.0F, 0.0F);
+    for (u8 i = 0; i < 4; i++)
+        o_sts[i].set(i * 0.25F, 1.0F - i * 0.25F);
+    o_material.allocateFaces(6);
+    for (u8 i = 0; i < 6; i++)
+    {
+        o_material.setVertexFace(i, vertexFaces[i]);
+        o_material.setNormalFace(i, normalFaces[i]);
+        o_material.setSTFace(i, stFaces[i]);
+    }
+    o_material.setSTsPresent(true);
+    o_material.setNormalsPresent(true);
+}
+
+SCENARIO("Baked draw data should be the same as indexed data", "[mesh_material.cpp]")
+{
+    MeshMaterial material;
+    Vector3 vertices[4], normals[2];
+    Point sts[4];
+    setQuad(material, vertices, normals, sts);
+    REQUIRE(!material.isDrawDataBaked());
+    material.bakeDrawData(vertices, normals, sts);
+    REQUIRE(material.isDrawDataBaked());
+    for (u32 i = 0; i < material.getFacesCount(); i++)
+    {
+        VECTOR &vertex = material.getDrawVertices()[i];
+        VECTOR &normal = material.getDrawNormals()[i];
+        VECTOR &coordinate = material.getDrawCoordinates()[i];
+        const Vector3 &expectedVertex = vertices[material.getVertexFace(i)];
+        const Vector3 &expectedNormal = normals[material.getNormalFace(i)];
+        const Point &expectedST = sts[material.getSTFace(i)];
+        REQUIRE(vertex[0] == expectedVertex.x);
+        REQUIRE(vertex[1] == expectedVertex.y);
+        REQUIRE(vertex[2] == expectedVertex.z);
+        REQUIRE(vertex[3] == 1.0F);
+        REQUIRE(normal[0] == expectedNormal.x);
+        REQUIRE(normal[1] == expectedNormal.y);
+        REQUIRE(normal[2] == expectedNormal.z);
+        REQUIRE(normal[3] == 1.0F);
+        REQUIRE(coordinate[0] == expectedST.x);
+        REQUIRE(coordinate[1] == expectedST.y);
+        REQUIRE(coordinate[2] == 1.0F);
+        REQUIRE(coordinate[3] == 1.0F);
+    }
+}
+
+SCENARIO("Baked draw data should be aligned for VU1 unpack", "[mesh_material.cpp]")
+{
+    MeshMaterial material;
+    Vector3 vertices[4], normals[2];
+    Point sts[4];
+    setQuad(material, vertices, normals, sts);
+    material.bakeDrawData(vertices, normals, sts);
+    REQUIRE(((size_t)material.getDrawVertices() & 0xF) == 0);
+    REQUIRE(((size_t)material.getDrawNormals() & 0xF) == 0);
+    REQUIRE(((size_t)material.getDrawCoordinates() & 0xF) == 0);
+}
+
+SCENARIO("Reference copy should share baked draw data until faces are replaced", "[mesh_material.cpp]")
+{
+    MeshMaterial material;
+    Vector3 vertices[4], normals[2];
+    Point sts[4];
+    setQuad(material, vertices, normals, sts);
+    material.bakeDrawData(vertices, normals, sts);
+    MeshMaterial copy;
+    copy.copyFrom(&material);
+    REQUIRE(copy.getDrawVertices() == material.getDrawVertices());
+
+    u32 *vertexFaces = new u32[3]{0, 1, 2};
+    u32 *stFaces = new u32[3]{0, 1, 2};
+    u32 *normalFaces = new u32[3]{0, 0, 0};
+    copy.setFaces(vertexFaces, stFaces, normalFaces, 3);
+    REQUIRE(!copy.isDrawDataBaked());
+    REQUIRE(material.isDrawDataBaked());
+    copy.bakeDrawData(vertices, normals, sts);
+    REQUIRE(copy.getDrawVertices() != material.getDrawVertices());
+    REQUIRE(copy.getDrawVertices()[2][1] == 1.0F);
+}
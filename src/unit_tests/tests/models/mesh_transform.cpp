@@ -0,0 +1,115 @@
+/*
+# ______       ____   ___
+#   |     \/   ____| |___|    
+#   |     |   |   \  |   |       
+#-----------------------------------------------------------------------
+# Copyright 2021, tyra - https://github.com/h4570/tyra
+# Licenced under Apache License 2.0
+# Sandro Sobczyński <sandro.sobczynski@gmail.com>
+*/
+
+#include <catch.hpp>
+#include <models/mesh_transform.hpp>
+#include <cmath>
+
+/** Column major 4x4 multiplication (a * b) */
+static void multiply(float *o_result, const float *a, const float *b)
+{
+    for (u8 column = 0; column < 4; column++)
+        for (u8 row = 0; row < 4; row++)
+        {
+            float sum = 0.0F;
+            for (u8 k = 0; k < 4; k++)
+                sum += a[k * 4 + row] * b[column * 4 + k];
+            o_result[column * 4 + row] = sum;
+        }
+}
+
+static void setIdentity(float *o_matrix)
+{
+    for (u8 i = 0; i < 16; i++)
+        o_matrix[i] = i % 5 == 0 ? 1.0F : 0.0F;
+}
+
+/** T * Rx * Ry * Rz * S made from elementary matrices */
+static void getReference(float *o_matrix, const Vector3 &t_position, const Vector3 &t_rotation, const float &t_scale)
+{
+    float translation[16], x[16], y[16], z[16], scale[16], temp[16], temp2[16];
+    setIdentity(translation), setIdentity(x), setIdentity(y), setIdentity(z), setIdentity(scale);
+    translation[12] = t_position.x, translation[13] = t_position.y, translation[14] = t_position.z;
+    x[5] = cosf(t_rotation.x), x[6] = sinf(t_rotation.x), x[9] = -sinf(t_rotation.x), x[10] = cosf(t_rotation.x);
+    y[0] = cosf(t_rotation.y), y[2] = -sinf(t_rotation.y), y[8] = sinf(t_rotation.y), y[10] = cosf(t_rotation.y);
+    z[0] = cosf(t_rotation.z), z[1] = sinf(t_rotation.z), z[4] = -sinf(t_rotation.z), z[5] = cosf(t_rotation.z);
+    scale[0] = scale[5] = scale[10] = t_scale;
+    multiply(temp, translation, x);
+    multiply(temp2, temp, y);
+    multiply(temp, temp2, z);
+    multiply(o_matrix, temp, scale);
+}
+
+static void requireEqual(const Matrix &t_matrix, const float *t_expected)
+{
+    for (u8 i = 0; i < 16; i++)
+        REQUIRE(t_matrix.data[i] == Approx(t_expected[i]).margin(0.001F));
+}
+
+SCENARIO("compose() should be equal to multiplied scale, rotation and translation matrices", "[mesh_transform.cpp]")
+{
+    const Vector3 position(1.0F, -2.0F, 3.0F), rotation(0.7F, 0.5F, 0.3F);
+    float expected[16];
+    getReference(expected, position, rotation, 2.0F);
+    Matrix result;
+    MeshTransform::compose(result, position, rotation, 2.0F);
+    requireEqual(result, expected);
+}
+
+SCENARIO("compose() should be equal to old Matrix rotate() and translate() chain", "[mesh_transform.cpp]")
+{
+    const Vector3 positions[3] = {Vector3(0.0F, 0.0F, 0.0F), Vector3(1.0F, -2.0F, 3.0F), Vector3(-40.0F, 5.5F, 120.0F)};
+    const Vector3 rotations[3] = {Vector3(0.0F, 0.0F, 0.0F), Vector3(0.7F, 0.5F, 0.3F), Vector3(-2.1F, 3.0F, -0.4F)};
+    const float scales[3] = {1.0F, 2.0F, 0.25F};
+    for (u8 i = 0; i < 3; i++)
+    {
+        // Model matrix of VifSender::calcMatrix() and instances before MeshTransform
+        Matrix expected;
+        expected.identity();
+        expected.scale(Vector3(scales[i], scales[i], scales[i]));
+        expected.rotate(rotations[i]);
+        expected.translate(positions[i]);
+        Matrix result;
+        MeshTransform::compose(result, positions[i], rotations[i], scales[i]);
+        requireEqual(result, expected.data);
+
+        // Camera rotation for backface culling (old camRotation.rotate(-rotation))
+        expected.identity();
+        expected.rotate(-rotations[i]);
+        MeshTransform::compose(result, Vector3(), -rotations[i], 1.0F);
+        requireEqual(result, expected.data);
+        const Vector3 camera(10.0F, -3.0F, 25.0F);
+        const Vector3 expectedCamera = expected * camera;
+        const Vector3 resultCamera = result * camera;
+        REQUIRE(resultCamera.x == Approx(expectedCamera.x).margin(0.001F));
+        REQUIRE(resultCamera.y == Approx(expectedCamera.y).margin(0.001F));
+        REQUIRE(resultCamera.z == Approx(expectedCamera.z).margin(0.001F));
+    }
+}
+
+SCENARIO("get() should follow changes of position, rotation and scale", "[mesh_transform.cpp]")
+{
+    MeshTransform transform;
+    Vector3 position(1.0F, 2.0F, 3.0F), rotation(0.1F, 0.2F, 0.3F);
+    float scale = 1.0F;
+    float expected[16];
+
+    getReference(expected, position, rotation, scale);
+    requireEqual(transform.get(position, rotation, scale), expected);
+
+    position.set(-5.0F, 0.0F, 10.0F);
+    getReference(expected, position, rotation, scale);
+    requireEqual(transform.get(position, rotation, scale), expected);
+
+    rotation.set(1.5F, -0.4F, 2.0F);
+    scale = 0.5F;
+    getReference(expected, position, rotation, scale);
+    requireEqual(transform.get(position, rotation, scale), expected);
+}
@@ -0,0 +1,118 @@
+/*
+# ______       ____   ___
+#   |     \/   ____| |___|    
+#   |     |   |   \  |   |       
+#-----------------------------------------------------------------------
+# Copyright 2021, tyra - https://github.com/h4570/tyra
+# Licenced under Apache License 2.0
+# Sandro Sobczyński <sandro.sobczynski@gmail.com>
+*/
+
+#include <catch.hpp>
+#include <models/texture.hpp>
+
+SCENARIO("generateMipmaps() should stop at minimal mipmap size", "[texture.cpp]")
+{
+    Texture texture;
+    texture.setSize(64, 32, TEX_TYPE_RGBA);
+    texture.generateMipmaps();
+    REQUIRE(texture.getMipmapsCount() == 2);
+    REQUIRE(texture.getMipmapWidth(2) == 16);
+    REQUIRE(texture.getMipmapHeight(2) == 8);
+    REQUIRE(texture.getMipmapDataSize(2) == 16 * 8 * 4);
+}
+
+SCENARIO("generateMipmaps() should respect max count", "[texture.cpp]")
+{
+    Texture texture;
+    texture.setSize(128, 128, TEX_TYPE_RGB);
+    texture.generateMipmaps(1);
+    REQUIRE(texture.getMipmapsCount() == 1);
+    REQUIRE(texture.getMipmapData(0) == texture.getData());
+}
+
+SCENARIO("generateMipmaps() should average 2x2 pixels", "[texture.cpp]")
+{
+    Texture texture;
+    texture.setSize(16, 16, TEX_TYPE_RGBA);
+    for (u32 i = 0; i < 16 * 16; i++)
+    {
+        const u8 isOdd = (i % 16) & 1;
+        texture.setData(i * 4, isOdd ? 200 : 100);
+        texture.setData(i * 4 + 1, 0);
+        texture.setData(i * 4 + 2, 50);
+        texture.setData(i * 4 + 3, 128);
+    }
+    texture.generateMipmaps();
+    REQUIRE(texture.getMipmapsCount() == 1);
+    const unsigned char *level = texture.getMipmapData(1);
+    REQUIRE(level[0] == 150);
+    REQUIRE(level[1] == 0);
+    REQUIRE(level[2] == 50);
+    REQUIRE(level[3] == 128);
+}
+
+SCENARIO("generateMipmaps() of 4bit palette should use nearest palette color", "[texture.cpp]")
+{
+    Texture texture;
+    texture.setSize(16, 16, TEX_TYPE_PALETTE4);
+    texture.setClutColor(0, 0, 0, 0, 128);
+    texture.setClutColor(1, 250, 250, 250, 128);
+    texture.setClutColor(2, 200, 200, 200, 128);
+    for (u32 i = 0; i < texture.getDataSize(); i++)
+        texture.setData(i, 0x11); // All pixels with color 1
+    texture.setData(0, 0x10);     // First pixel black, second white
+    texture.generateMipmaps();
+    const unsigned char *level = texture.getMipmapData(1);
+    REQUIRE((level[0] & 0x0F) == 2);
+    REQUIRE((level[0] >> 4) == 1);
+}
+
+SCENARIO("getVramSize() of narrow PSMT8 texture should use 128 pixels buffer width", "[texture.cpp]")
+{
+    Texture texture;
+    texture.setSize(64, 128, TEX_TYPE_PALETTE8);
+    REQUIRE(texture.getBufferWidth(0) == 128);
+    // 128x64 pages, so two of them
+    REQUIRE(texture.getVramSize(0) == 2 * TEXTURE_GS_PAGE_SIZE);
+    REQUIRE(texture.getVramSize(0) * 4 > texture.getDataSize());
+}
+
+SCENARIO("getVramSize() of narrow PSMT4 texture should use 128 pixels buffer width", "[texture.cpp]")
+{
+    Texture texture;
+    texture.setSize(32, 256, TEX_TYPE_PALETTE4);
+    REQUIRE(texture.getBufferWidth(0) == 128);
+    // 128x128 pages, so two of them
+    REQUIRE(texture.getVramSize(0) == 2 * TEXTURE_GS_PAGE_SIZE);
+}
+
+SCENARIO("getVramSize() of mip levels narrower than 64 pixels should use whole pages", "[texture.cpp]")
+{
+    Texture texture;
+    texture.setSize(128, 128, TEX_TYPE_RGBA);
+    texture.generateMipmaps();
+    REQUIRE(texture.getMipmapsCount() == 4);
+    // 64x32 pages
+    REQUIRE(texture.getVramSize(0) == 8 * TEXTURE_GS_PAGE_SIZE);
+    REQUIRE(texture.getVramSize(1) == 2 * TEXTURE_GS_PAGE_SIZE);
+    for (u8 i = 2; i <= texture.getMipmapsCount(); i++)
+    {
+        REQUIRE(texture.getBufferWidth(i) == 64);
+        REQUIRE(texture.getVramSize(i) == TEXTURE_GS_PAGE_SIZE);
+    }
+}
+
+SCENARIO("getVramSize() of paletted mip levels should use whole pages", "[texture.cpp]")
+{
+    Texture texture;
+    texture.setSize(256, 256, TEX_TYPE_PALETTE8);
+    texture.generateMipmaps();
+    REQUIRE(texture.getVramSize(0) == 8 * TEXTURE_GS_PAGE_SIZE);
+    REQUIRE(texture.getVramSize(1) == 2 * TEXTURE_GS_PAGE_SIZE);
+    for (u8 i = 2; i <= texture.getMipmapsCount(); i++)
+    {
+        REQUIRE(texture.getBufferWidth(i) == 128);
+        REQUIRE(texture.getVramSize(i) == TEXTURE_GS_PAGE_SIZE);
+    }
+}
@@ -0,0 +1,139 @@
+/*
+# ______       ____   ___
+#   |     \/   ____| |___|    
+#   |     |   |   \  |   |       
+#-----------------------------------------------------------------------
+# Copyright 2021, tyra - https://github.com/h4570/tyra
+# Licenced under Apache License 2.0
+# Sandro Sobczyński <sandro.sobczynski@gmail.com>
+*/
+
+#include <catch.hpp>
+#include <models/vram_allocator.hpp>
+
+SCENARIO("allocate() should place slots one after another", "[vram_allocator.cpp]")
+{
+    VramAllocator allocator;
+    allocator.init(1000, 2000, 100);
+    REQUIRE(allocator.getStart() == 1000);
+    REQUIRE(allocator.allocate(1, 100) == 1000);
+    REQUIRE(allocator.allocate(2, 50) == 1100);
+    REQUIRE(allocator.allocate(3, 200) == 1200);
+    REQUIRE(allocator.getSlotsCount() == 3);
+    REQUIRE(allocator.getFreeWords() == 600);
+}
+
+SCENARIO("allocate() should align start address and size", "[vram_allocator.cpp]")
+{
+    VramAllocator allocator;
+    allocator.init(10, 1000, 64);
+    REQUIRE(allocator.getStart() == 64);
+    REQUIRE(allocator.allocate(1, 1) == 64);
+    REQUIRE(allocator.allocate(2, 65) == 128);
+    REQUIRE(allocator.allocate(3, 64) == 256);
+}
+
+SCENARIO("allocate() of resident key should return the same address", "[vram_allocator.cpp]")
+{
+    VramAllocator allocator;
+    allocator.init(0, 1000, 100);
+    allocator.allocate(1, 100);
+    allocator.allocate(2, 100);
+    REQUIRE(allocator.allocate(1, 100) == 0);
+    REQUIRE(allocator.getSlotsCount() == 2);
+}
+
+SCENARIO("use() should return -1 for not resident key", "[vram_allocator.cpp]")
+{
+    VramAllocator allocator;
+    allocator.init(0, 1000, 100);
+    allocator.allocate(1, 100);
+    REQUIRE(allocator.use(1) == 0);
+    REQUIRE(allocator.use(2) == -1);
+}
+
+SCENARIO("allocate() should reuse first fitting gap after release()", "[vram_allocator.cpp]")
+{
+    VramAllocator allocator;
+    allocator.init(0, 1000, 100);
+    allocator.allocate(1, 200);
+    allocator.allocate(2, 100);
+    allocator.allocate(3, 100);
+    allocator.release(1);
+    REQUIRE(allocator.allocate(4, 100) == 0);
+    REQUIRE(allocator.allocate(5, 100) == 100);
+    REQUIRE(allocator.allocate(6, 100) == 400);
+}
+
+SCENARIO("allocate() should evict least recently used slot when full", "[vram_allocator.cpp]")
+{
+    VramAllocator allocator;
+    allocator.init(0, 300, 100);
+    allocator.allocate(1, 100);
+    allocator.nextFrame();
+    allocator.allocate(2, 100);
+    allocator.nextFrame();
+    allocator.allocate(3, 100);
+    allocator.nextFrame();
+    allocator.use(1);
+    REQUIRE(allocator.allocate(4, 100) == 100);
+    REQUIRE(allocator.getEvictedKeys().size() == 1);
+    REQUIRE(allocator.use(2) == -1);
+    REQUIRE(allocator.use(1) == 0);
+}
+
+SCENARIO("allocate() should evict until contiguous space is found", "[vram_allocator.cpp]")
+{
+    VramAllocator allocator;
+    allocator.init(0, 300, 100);
+    allocator.allocate(1, 100);
+    allocator.allocate(2, 100);
+    allocator.allocate(3, 100);
+    allocator.nextFrame();
+    allocator.use(2);
+    REQUIRE(allocator.allocate(4, 200) == 0);
+    REQUIRE(allocator.getEvictedKeys().size() == 3);
+    REQUIRE(allocator.getSlotsCount() == 1);
+}
+
+SCENARIO("alternating two textures should not cause evictions", "[vram_allocator.cpp]")
+{
+    VramAllocator allocator;
+    allocator.init(0, 1000, 100);
+    u32 evictions = 0;
+    for (u32 frame = 0; frame < 10; frame++)
+    {
+        for (u32 i = 0; i < 4; i++)
+        {
+            allocator.allocate(1 + (i % 2), 300);
+            evictions += allocator.getEvictedKeys().size();
+        }
+        allocator.nextFrame();
+    }
+    REQUIRE(evictions == 0);
+    REQUIRE(allocator.getSlotsCount() == 2);
+}
+
+SCENARIO("allocate() bigger than whole range should return -1", "[vram_allocator.cpp]")
+{
+    VramAllocator allocator;
+    allocator.init(0, 1000, 100);
+    allocator.allocate(1, 100);
+    REQUIRE(allocator.allocate(2, 1001) == -1);
+    REQUIRE(allocator.getSlotsCount() == 1);
+}
+
+SCENARIO("isCurrentFrameSlotEvicted() should be set only for slots used in current frame", "[vram_allocator.cpp]")
+{
+    VramAllocator allocator;
+    allocator.init(0, 200, 100);
+    allocator.allocate(1, 100);
+    allocator.allocate(2, 100);
+    allocator.nextFrame();
+    allocator.use(2);
+    allocator.allocate(3, 100);
+    REQUIRE(allocator.getEvictedKeys()[0] == 1);
+    REQUIRE(allocator.isCurrentFrameSlotEvicted() == false);
+    allocator.allocate(4, 100);
+    REQUIRE(allocator.isCurrentFrameSlotEvicted() == true);
+}
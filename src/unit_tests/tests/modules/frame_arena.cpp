@@ -0,0 +1,76 @@
+/*
+# ______       ____   ___
+#   |     \/   ____| |___|    
+#   |     |   |   \  |   |       
+#-----------------------------------------------------------------------
+# Copyright 2021, tyra - https://github.com/h4570/tyra
+# Licenced under Apache License 2.0
+# Sandro Sobczyński <sandro.sobczynski@gmail.com>
+*/
+
+
+#include <catch.hpp>
+#include <modules/frame_arena.hpp>
+
+SCENARIO("Arena allocations should be aligned and linear", "[frame_arena.cpp]")
+{
+    FrameArena arena(1024);
+    u8 *a = arena.allocate<u8>(3);
+    u8 *b = arena.allocate<u8>(20);
+    REQUIRE(((u32)(size_t)a & 0xF) == 0);
+    REQUIRE(((u32)(size_t)b & 0xF) == 0);
+    REQUIRE(b - a == 16);
+    REQUIRE(arena.getCurrentStats().used == 48);
+    REQUIRE(arena.getCurrentStats().overflows == 0);
+}
+
+SCENARIO("Arena memory should be reused after two frames", "[frame_arena.cpp]")
+{
+    FrameArena arena(1024);
+    void *first = arena.allocate(64);
+    arena.endFrame();
+    void *second = arena.allocate(64);
+    REQUIRE(second != first);
+    arena.endFrame();
+    REQUIRE(arena.allocate(64) == first);
+}
+
+SCENARIO("Allocations bigger than arena should overflow to heap", "[frame_arena.cpp]")
+{
+    FrameArena arena(64);
+    arena.allocate(48);
+    void *overflow = arena.allocate(32);
+    REQUIRE(overflow != NULL);
+    REQUIRE(arena.getCurrentStats().overflows == 1);
+    arena.endFrame();
+    REQUIRE(arena.getStats().overflows == 1);
+    REQUIRE(arena.getStats().used == 80);
+    REQUIRE(arena.getCurrentStats().overflows == 0);
+}
+
+SCENARIO("High water mark should be kept between frames", "[frame_arena.cpp]")
+{
+    FrameArena arena(1024);
+    arena.allocate(512);
+    arena.endFrame();
+    arena.allocate(16);
+    arena.endFrame();
+    REQUIRE(arena.getStats().used == 16);
+    REQUIRE(arena.getStats().highWaterMark == 512);
+}
+
+SCENARIO("Packets should be reused after two frames", "[frame_arena.cpp]")
+{
+    FrameArena arena(1024);
+    packet2_t *a = arena.getPacket(12, P2_TYPE_NORMAL, P2_MODE_NORMAL, 0);
+    packet2_t *b = arena.getPacket(12, P2_TYPE_NORMAL, P2_MODE_NORMAL, 0);
+    REQUIRE(a != b);
+    arena.endFrame();
+    packet2_t *c = arena.getPacket(12, P2_TYPE_NORMAL, P2_MODE_NORMAL, 0);
+    REQUIRE(c != a);
+    REQUIRE(c != b);
+    arena.endFrame();
+    REQUIRE(arena.getPacket(12, P2_TYPE_NORMAL, P2_MODE_NORMAL, 0) == a);
+    REQUIRE(arena.getPacket(36, P2_TYPE_NORMAL, P2_MODE_CHAIN, 0) != b);
+    REQUIRE(arena.getStats().packetsCreated == 1);
+}
@@ -0,0 +1,120 @@
+/*
+# ______       ____   ___
+#   |     \/   ____| |___|    
+#   |     |   |   \  |   |       
+#-----------------------------------------------------------------------
+# Copyright 2021, tyra - https://github.com/h4570/tyra
+# Licenced under Apache License 2.0
+# Sandro Sobczyński <sandro.sobczynski@gmail.com>
+*/
+
+#include <catch.hpp>
+#include <modules/frustum_culler.hpp>
+
+/** Camera in 0,0,0 looking at +z, 90 degrees FOV, near 1, far 200 */
+static void setFrustum(Plane *o_planes)
+{
+    const float n = 0.70710678F;
+    o_planes[0].normal.set(n, 0.0F, n);
+    o_planes[1].normal.set(-n, 0.0F, n);
+    o_planes[2].normal.set(0.0F, n, n);
+    o_planes[3].normal.set(0.0F, -n, n);
+    o_planes[4].normal.set(0.0F, 0.0F, 1.0F);
+    o_planes[5].normal.set(0.0F, 0.0F, -1.0F);
+    for (u8 i = 0; i < 4; i++)
+        o_planes[i].distance = 0.0F;
+    o_planes[4].distance = -1.0F;
+    o_planes[5].distance = 200.0F;
+}
+
+/** Old test: box is outside, when all 8 corners are outside of one plane */
+static u8 areCornersInFrustum(Plane *t_planes, const Vector3 &t_center, const Vector3 &t_extent)
+{
+    for (u8 i = 0; i < 6; i++)
+    {
+        u8 isAnyIn = false;
+        for (u8 j = 0; j < 8; j++)
+        {
+            Vector3 corner(
+                t_center.x + (j & 1 ? t_extent.x : -t_extent.x),
+                t_center.y + (j & 2 ? t_extent.y : -t_extent.y),
+                t_center.z + (j & 4 ? t_extent.z : -t_extent.z));
+            if (t_planes[i].normal.x * corner.x + t_planes[i].normal.y * corner.y + t_planes[i].normal.z * corner.z + t_planes[i].distance >= 0.0F)
+                isAnyIn = true;
+        }
+        if (!isAnyIn)
+            return false;
+    }
+    return true;
+}
+
+SCENARIO("Batched culling should give the same result as corner test", "[frustum_culler.cpp]")
+{
+    Plane planes[6];
+    setFrustum(planes);
+    FrustumCuller culler;
+    u32 seed = 1234;
+    const u32 count = 1001; // Last group of 4 is not full
+    for (u32 i = 0; i < count; i++)
+    {
+        seed = seed * 1664525 + 1013904223;
+        const float x = static_cast<float>((seed >> 8) % 600) - 300.0F;
+        seed = seed * 1664525 + 1013904223;
+        const float y = static_cast<float>((seed >> 8) % 600) - 300.0F;
+        seed = seed * 1664525 + 1013904223;
+        const float z = static_cast<float>((seed >> 8) % 400) - 100.0F;
+        const float size = static_cast<float>(seed % 8) + 0.5F;
+        culler.add(Vector3(x, y, z), Vector3(size, size * 0.5F, size * 2.0F));
+    }
+    const u32 visibleCount = culler.cull(planes);
+    u32 expectedCount = 0;
+    seed = 1234;
+    for (u32 i = 0; i < count; i++)
+    {
+        seed = seed * 1664525 + 1013904223;
+        const float x = static_cast<float>((seed >> 8) % 600) - 300.0F;
+        seed = seed * 1664525 + 1013904223;
+        const float y = static_cast<float>((seed >> 8) % 600) - 300.0F;
+        seed = seed * 1664525 + 1013904223;
+        const float z = static_cast<float>((seed >> 8) % 400) - 100.0F;
+        const float size = static_cast<float>(seed % 8) + 0.5F;
+        const Vector3 center(x, y, z), extent(size, size * 0.5F, size * 2.0F);
+        const u8 expected = areCornersInFrustum(planes, center, extent);
+        REQUIRE(culler.isVisible(i) == expected);
+        REQUIRE(FrustumCuller::isBoxInFrustum(planes, center, extent) == expected);
+        expectedCount += expected;
+    }
+    REQUIRE(visibleCount == expectedCount);
+    REQUIRE(culler.getMaskSize() == (count + 31) / 32);
+    REQUIRE((culler.getMask()[count / 32] >> (count % 32)) == 0);
+}
+
+SCENARIO("Box of bounding box vertices should be moved by position", "[frustum_culler.cpp]")
+{
+    Vector3 vertices[8];
+    for (u8 i = 0; i < 8; i++)
+        vertices[i].set(i & 1 ? 3.0F : -1.0F, i & 2 ? 2.0F : 0.0F, i & 4 ? 1.0F : -1.0F);
+    Vector3 center, extent;
+    FrustumCuller::getBoxOfVertices(vertices, Vector3(10.0F, 0.0F, 0.0F), center, extent);
+    REQUIRE(center.x == 11.0F);
+    REQUIRE(center.y == 1.0F);
+    REQUIRE(center.z == 0.0F);
+    REQUIRE(extent.x == 2.0F);
+    REQUIRE(extent.y == 1.0F);
+    REQUIRE(extent.z == 1.0F);
+}
+
+SCENARIO("Cleared culler should be reusable", "[frustum_culler.cpp]")
+{
+    Plane planes[6];
+    setFrustum(planes);
+    FrustumCuller culler;
+    culler.add(Vector3(0.0F, 0.0F, 50.0F), Vector3(1.0F, 1.0F, 1.0F));
+    culler.add(Vector3(0.0F, 0.0F, -50.0F), Vector3(1.0F, 1.0F, 1.0F));
+    REQUIRE(culler.cull(planes) == 1);
+    culler.clear();
+    REQUIRE(culler.getCount() == 0);
+    culler.add(Vector3(0.0F, 0.0F, -50.0F), Vector3(1.0F, 1.0F, 1.0F));
+    REQUIRE(culler.cull(planes) == 0);
+    REQUIRE(culler.isVisible(0) == false);
+}
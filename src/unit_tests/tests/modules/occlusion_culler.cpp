@@ -0,0 +1,114 @@
+/*
+# ______       ____   ___
+#   |     \/   ____| |___|    
+#   |     |   |   \  |   |       
+#-----------------------------------------------------------------------
+# Copyright 2021, tyra - https://github.com/h4570/tyra
+# Licenced under Apache License 2.0
+# Sandro Sobczyński <sandro.sobczynski@gmail.com>
+*/
+
+#include <catch.hpp>
+#include <modules/occlusion_culler.hpp>
+
+/** Camera in 0,0,0 looking at -z, the same as Matrix::setPerspective() with 90 degrees FOV */
+static void setCamera(ScreenSettings &o_screen, Matrix &o_viewProjection)
+{
+    o_screen.fov = 90.0F;
+    o_screen.width = 640.0F;
+    o_screen.height = 448.0F;
+    o_screen.aspectRatio = o_screen.width / o_screen.height;
+    o_screen.nearPlaneDist = 0.1F;
+    o_screen.farPlaneDist = 1000.0F;
+    o_screen.projectionScale = 4096.0F;
+    for (u8 i = 0; i < 16; i++)
+        o_viewProjection.data[i] = 0.0F;
+    o_viewProjection.data[0] = (o_screen.width / o_screen.projectionScale) / o_screen.aspectRatio;
+    o_viewProjection.data[5] = -(o_screen.height / o_screen.projectionScale);
+    o_viewProjection.data[10] = (o_screen.farPlaneDist + o_screen.nearPlaneDist) / (o_screen.farPlaneDist - o_screen.nearPlaneDist);
+    o_viewProjection.data[11] = -1.0F;
+    o_viewProjection.data[14] = (2.0F * o_screen.farPlaneDist * o_screen.nearPlaneDist) / (o_screen.farPlaneDist - o_screen.nearPlaneDist);
+}
+
+/** Square wall (2 triangles) 20x20, facing camera */
+static void addWall(OcclusionCuller &t_culler, const float &t_z)
+{
+    Matrix model;
+    for (u8 i = 0; i < 4; i++)
+        model.data[i * 5] = 1.0F;
+    Vector3 vertices[4] = {
+        Vector3(-10.0F, -10.0F, t_z),
+        Vector3(10.0F, -10.0F, t_z),
+        Vector3(10.0F, 10.0F, t_z),
+        Vector3(-10.0F, 10.0F, t_z)};
+    u32 indices[6] = {0, 1, 2, 0, 2, 3};
+    t_culler.addOccluder(model, vertices, indices, 6);
+}
+
+SCENARIO("Box behind wall should be hidden", "[occlusion_culler.cpp]")
+{
+    ScreenSettings screen;
+    Matrix viewProjection;
+    setCamera(screen, viewProjection);
+    OcclusionCuller culler(screen);
+    culler.begin(viewProjection);
+    addWall(culler, -20.0F);
+    REQUIRE(culler.getCurrentStats().occluderTriangles == 2);
+    REQUIRE(culler.getCurrentStats().rasterizedPixels > 0);
+    REQUIRE(culler.isVisible(Vector3(-1.0F, -1.0F, -32.0F), Vector3(1.0F, 1.0F, -30.0F)) == false);
+    REQUIRE(culler.getCurrentStats().culledBoxes == 1);
+}
+
+SCENARIO("Box in front of wall or next to wall should be visible", "[occlusion_culler.cpp]")
+{
+    ScreenSettings screen;
+    Matrix viewProjection;
+    setCamera(screen, viewProjection);
+    OcclusionCuller culler(screen);
+    culler.begin(viewProjection);
+    addWall(culler, -20.0F);
+    REQUIRE(culler.isVisible(Vector3(-1.0F, -1.0F, -12.0F), Vector3(1.0F, 1.0F, -10.0F)) == true);
+    REQUIRE(culler.isVisible(Vector3(25.0F, -1.0F, -32.0F), Vector3(27.0F, 1.0F, -30.0F)) == true);
+    // Box which is partially behind the wall
+    REQUIRE(culler.isVisible(Vector3(5.0F, -1.0F, -32.0F), Vector3(20.0F, 1.0F, -30.0F)) == true);
+    REQUIRE(culler.getCurrentStats().culledBoxes == 0);
+}
+
+SCENARIO("Wall should not hide itself", "[occlusion_culler.cpp]")
+{
+    ScreenSettings screen;
+    Matrix viewProjection;
+    setCamera(screen, viewProjection);
+    OcclusionCuller culler(screen);
+    culler.begin(viewProjection);
+    addWall(culler, -20.0F);
+    REQUIRE(culler.isVisible(Vector3(-10.0F, -10.0F, -20.0F), Vector3(10.0F, 10.0F, -20.0F)) == true);
+}
+
+SCENARIO("Box crossing near plane should be visible", "[occlusion_culler.cpp]")
+{
+    ScreenSettings screen;
+    Matrix viewProjection;
+    setCamera(screen, viewProjection);
+    OcclusionCuller culler(screen);
+    culler.begin(viewProjection);
+    addWall(culler, -20.0F);
+    REQUIRE(culler.isVisible(Vector3(-1.0F, -1.0F, -30.0F), Vector3(1.0F, 1.0F, 5.0F)) == true);
+}
+
+SCENARIO("Stats should be saved at the end of frame", "[occlusion_culler.cpp]")
+{
+    ScreenSettings screen;
+    Matrix viewProjection;
+    setCamera(screen, viewProjection);
+    OcclusionCuller culler(screen);
+    culler.begin(viewProjection);
+    REQUIRE(culler.isActive() == true);
+    addWall(culler, -20.0F);
+    culler.isVisible(Vector3(-1.0F, -1.0F, -32.0F), Vector3(1.0F, 1.0F, -30.0F));
+    culler.endFrame();
+    REQUIRE(culler.isActive() == false);
+    REQUIRE(culler.getStats().testedBoxes == 1);
+    REQUIRE(culler.getStats().culledBoxes == 1);
+    REQUIRE(culler.getCurrentStats().testedBoxes == 0);
+}
@@ -0,0 +1,106 @@
+/*
+# ______       ____   ___
+#   |     \/   ____| |___|    
+#   |     |   |   \  |   |       
+#-----------------------------------------------------------------------
+# Copyright 2021, tyra - https://github.com/h4570/tyra
+# Licenced under Apache License 2.0
+# Sandro Sobczyński <sandro.sobczynski@gmail.com>
+*/
+
+#include <catch.hpp>
+#include <modules/render_queue.hpp>
+
+SCENARIO("Opaque key should be smaller than translucent key", "[render_queue.cpp]")
+{
+    u64 opaque = RenderQueue::createKey(false, 127, 0xFFFF, 0xFFFF, 100000.0F);
+    u64 translucent = RenderQueue::createKey(true, 0, 0, 0, 0.0F);
+    REQUIRE(opaque < translucent);
+}
+
+SCENARIO("Opaque keys with the same state should be ordered near to far", "[render_queue.cpp]")
+{
+    u64 nearKey = RenderQueue::createKey(false, 0, 5, 5, 1.5F);
+    u64 farKey = RenderQueue::createKey(false, 0, 5, 5, 250.0F);
+    REQUIRE(nearKey < farKey);
+    REQUIRE(RenderQueue::getStateOfKey(nearKey) == RenderQueue::getStateOfKey(farKey));
+}
+
+SCENARIO("Opaque keys should be ordered by texture before depth", "[render_queue.cpp]")
+{
+    u64 farKey = RenderQueue::createKey(false, 0, 1, 5, 250.0F);
+    u64 nearKey = RenderQueue::createKey(false, 0, 2, 5, 1.5F);
+    REQUIRE(farKey < nearKey);
+}
+
+SCENARIO("Translucent keys should be ordered far to near", "[render_queue.cpp]")
+{
+    u64 nearKey = RenderQueue::createKey(true, 0, 1, 5, 1.5F);
+    u64 farKey = RenderQueue::createKey(true, 0, 2, 5, 250.0F);
+    REQUIRE(farKey < nearKey);
+}
+
+SCENARIO("Negative depth should be treated as zero", "[render_queue.cpp]")
+{
+    REQUIRE(RenderQueue::createKey(false, 0, 1, 1, -5.0F) == RenderQueue::createKey(false, 0, 1, 1, 0.0F));
+}
+
+SCENARIO("sort() should group textures and count saved state changes", "[render_queue.cpp]")
+{
+    RenderQueue queue;
+    for (u32 i = 0; i < 12; i++)
+        queue.add(RenderQueue::createKey(false, 0, i % 3, 0, (float)(12 - i)), NULL, NULL, i, NULL, 0);
+    queue.sort();
+    const std::vector<RenderQueueItem> &items = queue.getItems();
+    REQUIRE(items.size() == 12);
+    for (u32 i = 1; i < items.size(); i++)
+        REQUIRE(items[i - 1].key <= items[i].key);
+    REQUIRE(queue.getStats().items == 12);
+    REQUIRE(queue.getStats().unsortedStateChanges == 12);
+    REQUIRE(queue.getStats().sortedStateChanges == 3);
+    // Near to far within texture 0: materialIndex 9, 6, 3, 0
+    REQUIRE(items[0].materialIndex == 9);
+    REQUIRE(items[3].materialIndex == 0);
+}
+
+SCENARIO("sort() with disabled sorting should keep calls order", "[render_queue.cpp]")
+{
+    RenderQueue queue;
+    queue.setSorting(false);
+    queue.add(RenderQueue::createKey(false, 0, 2, 0, 1.0F), NULL, NULL, 0, NULL, 0);
+    queue.add(RenderQueue::createKey(false, 0, 1, 0, 1.0F), NULL, NULL, 1, NULL, 0);
+    queue.sort();
+    REQUIRE(queue.getItems()[0].materialIndex == 0);
+    REQUIRE(queue.getStats().sortedStateChanges == queue.getStats().unsortedStateChanges);
+}
+
+SCENARIO("clear() should remove all items", "[render_queue.cpp]")
+{
+    RenderQueue queue;
+    queue.add(0, NULL, NULL, 0, NULL, 0);
+    queue.clear();
+    REQUIRE(queue.isEmpty());
+}
+
+SCENARIO("add() should copy bulbs", "[render_queue.cpp]")
+{
+    RenderQueue queue;
+    LightBulb bulbs[2];
+    bulbs[0].position.set(1.0F, 2.0F, 3.0F);
+    bulbs[0].intensity = 50;
+    bulbs[1].position.set(4.0F, 5.0F, 6.0F);
+    bulbs[1].intensity = 100;
+    queue.add(RenderQueue::createKey(false, 0, 1, 0, 1.0F), NULL, NULL, 0, bulbs, 2);
+    queue.add(RenderQueue::createKey(false, 0, 0, 0, 1.0F), NULL, NULL, 1, bulbs, 2);
+    bulbs[0].intensity = 0;
+    queue.add(RenderQueue::createKey(false, 0, 2, 0, 1.0F), NULL, NULL, 2, bulbs, 2);
+    queue.add(RenderQueue::createKey(false, 0, 3, 0, 1.0F), NULL, NULL, 3, NULL, 0);
+    queue.sort();
+    const std::vector<RenderQueueItem> &items = queue.getItems();
+    REQUIRE(items[0].materialIndex == 1);
+    REQUIRE(queue.getBulbs(items[0])[0].intensity == 50);
+    REQUIRE(queue.getBulbs(items[0])[1].position.z == 6.0F);
+    REQUIRE(queue.getBulbs(items[1]) == queue.getBulbs(items[0]));
+    REQUIRE(queue.getBulbs(items[2])[0].intensity == 0);
+    REQUIRE(queue.getBulbs(items[3]) == NULL);
+}
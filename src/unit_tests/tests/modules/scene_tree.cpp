@@ -0,0 +1,212 @@
+/*
+# ______       ____   ___
+#   |     \/   ____| |___|    
+#   |     |   |   \  |   |       
+#-----------------------------------------------------------------------
+# Copyright 2021, tyra - https://github.com/h4570/tyra
+# Licenced under Apache License 2.0
+# Sandro Sobczyński <sandro.sobczynski@gmail.com>
+*/
+
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+
+#include <catch.hpp>
+#include <modules/scene_tree.hpp>
+#include <vector>
+#include <string>
+#include <algorithm>
+
+/** Camera in 0,0,0 looking at +z, 90 degrees FOV, near 1, far 200 */
+static void setFrustum(Plane *o_planes)
+{
+    const float n = 0.70710678F;
+    o_planes[0].normal.set(n, 0.0F, n);
+    o_planes[1].normal.set(-n, 0.0F, n);
+    o_planes[2].normal.set(0.0F, n, n);
+    o_planes[3].normal.set(0.0F, -n, n);
+    o_planes[4].normal.set(0.0F, 0.0F, 1.0F);
+    o_planes[5].normal.set(0.0F, 0.0F, -1.0F);
+    for (u8 i = 0; i < 4; i++)
+        o_planes[i].distance = 0.0F;
+    o_planes[4].distance = -1.0F;
+    o_planes[5].distance = 200.0F;
+}
+
+static u32 random(u32 &t_seed)
+{
+    t_seed = t_seed * 1664525 + 1013904223;
+    return t_seed >> 8;
+}
+
+static float randomFloat(u32 &t_seed, const float &t_min, const float &t_max)
+{
+    return t_min + (t_max - t_min) * (random(t_seed) & 0xFFFF) / 65535.0F;
+}
+
+static void randomBox(u32 &t_seed, Vector3 &o_min, Vector3 &o_max)
+{
+    Vector3 center(randomFloat(t_seed, -300.0F, 300.0F), randomFloat(t_seed, -300.0F, 300.0F), randomFloat(t_seed, -100.0F, 300.0F));
+    const float size = randomFloat(t_seed, 0.5F, 5.0F);
+    o_min.set(center.x - size, center.y - size, center.z - size);
+    o_max.set(center.x + size, center.y + size, center.z + size);
+}
+
+static u8 isBoxInFrustum(Plane *t_planes, const Vector3 &t_min, const Vector3 &t_max)
+{
+    for (u8 i = 0; i < 6; i++)
+    {
+        Vector3 corner(
+            t_planes[i].normal.x > 0.0F ? t_max.x : t_min.x,
+            t_planes[i].normal.y > 0.0F ? t_max.y : t_min.y,
+            t_planes[i].normal.z > 0.0F ? t_max.z : t_min.z);
+        if (t_planes[i].distanceTo(corner) < 0.0F)
+            return false;
+    }
+    return true;
+}
+
+/** Fills tree with random boxes. Returns proxies of boxes, which are in frustum (margin included) */
+static std::vector<u32> fillTree(SceneTree &t_tree, const u32 &t_count, Plane *t_planes, u32 t_seed)
+{
+    std::vector<u32> expected;
+    Vector3 min, max;
+    for (u32 i = 0; i < t_count; i++)
+    {
+        randomBox(t_seed, min, max);
+        const u32 proxy = t_tree.add(NULL, min, max);
+        Vector3 fatMin(min.x - 1.0F, min.y - 1.0F, min.z - 1.0F), fatMax(max.x + 1.0F, max.y + 1.0F, max.z + 1.0F);
+        if (isBoxInFrustum(t_planes, fatMin, fatMax))
+            expected.push_back(proxy);
+    }
+    std::sort(expected.begin(), expected.end());
+    return expected;
+}
+
+SCENARIO("Visible set should be the same as result of testing every box", "[scene_tree.cpp]")
+{
+    Plane planes[6];
+    setFrustum(planes);
+    SceneTree tree;
+    std::vector<u32> expected = fillTree(tree, 1000, planes, 1234);
+    std::vector<u32> result(1000);
+    result.resize(tree.getVisible(planes, &result[0], result.size()));
+    std::sort(result.begin(), result.end());
+    REQUIRE(tree.getCount() == 1000);
+    REQUIRE(expected.size() > 0);
+    REQUIRE(result == expected);
+}
+
+SCENARIO("Visible set should be the same after rebuild", "[scene_tree.cpp]")
+{
+    Plane planes[6];
+    setFrustum(planes);
+    SceneTree tree;
+    std::vector<u32> expected = fillTree(tree, 1000, planes, 99);
+    tree.rebuild();
+    std::vector<u32> result(1000);
+    result.resize(tree.getVisible(planes, &result[0], result.size()));
+    std::sort(result.begin(), result.end());
+    REQUIRE(tree.getCount() == 1000);
+    REQUIRE(result == expected);
+}
+
+SCENARIO("Tree should stay balanced", "[scene_tree.cpp]")
+{
+    SceneTree tree;
+    // Sorted input is the worst case for incremental insertion
+    for (u32 i = 0; i < 4096; i++)
+        tree.add(NULL, Vector3(i * 10.0F, 0.0F, 0.0F), Vector3(i * 10.0F + 1.0F, 1.0F, 1.0F));
+    REQUIRE(tree.getHeight() < 32);
+    tree.rebuild();
+    REQUIRE(tree.getHeight() == 13);
+}
+
+SCENARIO("Small move should not change the tree", "[scene_tree.cpp]")
+{
+    SceneTree tree(1.0F);
+    const u32 proxy = tree.add(NULL, Vector3(0.0F, 0.0F, 0.0F), Vector3(1.0F, 1.0F, 1.0F));
+    tree.add(NULL, Vector3(10.0F, 0.0F, 0.0F), Vector3(11.0F, 1.0F, 1.0F));
+    REQUIRE(tree.update(proxy, Vector3(0.5F, 0.0F, 0.0F), Vector3(1.5F, 1.0F, 1.0F)) == false);
+    REQUIRE(tree.update(proxy, Vector3(5.0F, 0.0F, 0.0F), Vector3(6.0F, 1.0F, 1.0F)) == true);
+    REQUIRE(tree.getStats().reinserts == 1);
+}
+
+SCENARIO("Moved and removed boxes should be visible only in new place", "[scene_tree.cpp]")
+{
+    Plane planes[6];
+    setFrustum(planes);
+    SceneTree tree;
+    const u32 a = tree.add(NULL, Vector3(-1.0F, -1.0F, 50.0F), Vector3(1.0F, 1.0F, 52.0F));
+    const u32 b = tree.add(NULL, Vector3(-1.0F, -1.0F, 60.0F), Vector3(1.0F, 1.0F, 62.0F));
+    const u32 c = tree.add(NULL, Vector3(-1.0F, -1.0F, -60.0F), Vector3(1.0F, 1.0F, -58.0F));
+    u32 result[3];
+    REQUIRE(tree.getVisible(planes, result, 3) == 2);
+
+    tree.update(a, Vector3(-1.0F, -1.0F, -50.0F), Vector3(1.0F, 1.0F, -48.0F));
+    tree.update(c, Vector3(-1.0F, -1.0F, 70.0F), Vector3(1.0F, 1.0F, 72.0F));
+    tree.remove(b);
+    REQUIRE(tree.getCount() == 2);
+    REQUIRE(tree.getVisible(planes, result, 3) == 1);
+    REQUIRE(result[0] == c);
+}
+
+SCENARIO("Visible set should not be bigger than output array", "[scene_tree.cpp]")
+{
+    Plane planes[6];
+    setFrustum(planes);
+    SceneTree tree;
+    std::vector<u32> expected = fillTree(tree, 1000, planes, 7);
+    u32 result[4];
+    REQUIRE(expected.size() > 4);
+    REQUIRE(tree.getVisible(planes, result, 4) == 4);
+}
+
+SCENARIO("Hierarchical culling should do less plane tests than linear culling", "[scene_tree.cpp]")
+{
+    Plane planes[6];
+    setFrustum(planes);
+    const u32 counts[3] = {1000, 5000, 10000};
+    for (u8 i = 0; i < 3; i++)
+    {
+        SceneTree tree;
+        fillTree(tree, counts[i], planes, 42);
+        tree.rebuild();
+        std::vector<u32> result(counts[i]);
+        tree.getVisible(planes, &result[0], result.size());
+        // Linear culling needs 6 planes per box in worst case and at least 1 per box
+        REQUIRE(tree.getStats().planeTests < counts[i] * 2);
+    }
+}
+
+TEST_CASE("Scene tree frustum culling benchmark", "[scene_tree.cpp][!benchmark]")
+{
+    Plane planes[6];
+    setFrustum(planes);
+    const u32 counts[3] = {1000, 5000, 10000};
+    for (u8 i = 0; i < 3; i++)
+    {
+        SceneTree tree;
+        u32 seed = 42;
+        std::vector<Vector3> mins(counts[i]), maxs(counts[i]);
+        for (u32 j = 0; j < counts[i]; j++)
+        {
+            randomBox(seed, mins[j], maxs[j]);
+            tree.add(NULL, mins[j], maxs[j]);
+        }
+        std::vector<u32> result(counts[i]);
+
+        BENCHMARK("Linear " + std::to_string(counts[i]))
+        {
+            u32 visible = 0;
+            for (u32 j = 0; j < counts[i]; j++)
+                if (isBoxInFrustum(planes, mins[j], maxs[j]))
+                    result[visible++] = j;
+            return visible;
+        };
+
+        BENCHMARK("Tree " + std::to_string(counts[i]))
+        {
+            return tree.getVisible(planes, &result[0], result.size());
+        };
+    }
+}
@@ -0,0 +1,60 @@
+/*
+# ______       ____   ___
+#   |     \/   ____| |___|    
+#   |     |   |   \  |   |       
+#-----------------------------------------------------------------------
+# Copyright 2021, tyra - https://github.com/h4570/tyra
+# Licenced under Apache License 2.0
+# Sandro Sobczyński <sandro.sobczynski@gmail.com>
+*/
+
+
+#include <catch.hpp>
+#include <modules/vu1_program_manager.hpp>
+#include <vector>
+
+/** Splits vertices into VU1 packages, like VifSender does. Returns how many times every triangle was drawn */
+static std::vector<u32> drawPackages(const u32 &t_vertCount, const u32 &t_vertsPerBuff, const u8 &t_isStrip)
+{
+    std::vector<u32> result(t_isStrip ? t_vertCount - 2 : t_vertCount / 3, 0);
+    for (u32 i = 0; i < t_vertCount;)
+    {
+        const u32 endI = getVu1PackageEnd(i, t_vertCount, t_vertsPerBuff);
+        REQUIRE(endI - i <= t_vertsPerBuff);
+        if (t_isStrip) // every vertex after first two ends triangle
+            for (u32 j = i; j + 2 < endI; j++)
+                result[j]++;
+        else
+        {
+            REQUIRE(i % 3 == 0);
+            for (u32 j = i; j + 2 < endI; j += 3)
+                result[j / 3]++;
+        }
+        i = getVu1NextPackageStart(endI, t_vertCount);
+    }
+    return result;
+}
+
+SCENARIO("Every strip triangle should be drawn exactly once", "[vu1_program_manager.cpp]")
+{
+    const u32 buffs[4] = {VU1_PACKAGE_VERTS_PER_BUFF, VU1_LARGE_PACKAGE_VERTS_PER_BUFF, VU1_CLIP_PACKAGE_VERTS_PER_BUFF, VU1_QUANTIZED_PACKAGE_VERTS_PER_BUFF};
+    for (u8 b = 0; b < 4; b++)
+        for (u32 count = 3; count < 1000; count++)
+        {
+            std::vector<u32> drawn = drawPackages(count, buffs[b], true);
+            for (u32 i = 0; i < drawn.size(); i++)
+                REQUIRE(drawn[i] == 1);
+        }
+}
+
+SCENARIO("Every list triangle should be drawn exactly once", "[vu1_program_manager.cpp]")
+{
+    const u32 buffs[4] = {VU1_PACKAGE_VERTS_PER_BUFF, VU1_LARGE_PACKAGE_VERTS_PER_BUFF, VU1_CLIP_PACKAGE_VERTS_PER_BUFF, VU1_QUANTIZED_PACKAGE_VERTS_PER_BUFF};
+    for (u8 b = 0; b < 4; b++)
+        for (u32 count = 3; count < 1000; count += 3)
+        {
+            std::vector<u32> drawn = drawPackages(count, buffs[b], false);
+            for (u32 i = 0; i < drawn.size(); i++)
+                REQUIRE(drawn[i] == 1);
+        }
+}
@@ -0,0 +1,65 @@
+/*
+# ______       ____   ___
+#   |     \/   ____| |___|    
+#   |     |   |   \  |   |       
+#-----------------------------------------------------------------------
+# Copyright 2021, tyra - https://github.com/h4570/tyra
+# Licenced under Apache License 2.0
+# Sandro Sobczyński <sandro.sobczynski@gmail.com>
+*/
+
+#include <catch.hpp>
+#include <utils/handle_table.hpp>
+
+SCENARIO("add() should return handle with table type", "[handle_table.cpp]")
+{
+    HandleTable<u32> table(HANDLE_TYPE_TEXTURE);
+    u32 handle = table.add(5);
+    REQUIRE(handle != HANDLE_NONE);
+    REQUIRE(Handle::getType(handle) == HANDLE_TYPE_TEXTURE);
+    REQUIRE(*table.get(handle) == 5);
+}
+
+SCENARIO("get() of removed handle should return NULL", "[handle_table.cpp]")
+{
+    HandleTable<u32> table(HANDLE_TYPE_TEXTURE);
+    u32 handle = table.add(5);
+    REQUIRE(table.remove(handle));
+    REQUIRE(table.get(handle) == NULL);
+    REQUIRE(!table.remove(handle));
+}
+
+SCENARIO("Reused slot should get new generation", "[handle_table.cpp]")
+{
+    HandleTable<u32> table(HANDLE_TYPE_SPRITE);
+    u32 first = table.add(1);
+    table.remove(first);
+    u32 second = table.add(2);
+    REQUIRE(Handle::getIndex(first) == Handle::getIndex(second));
+    REQUIRE(first != second);
+    REQUIRE(table.get(first) == NULL);
+    REQUIRE(*table.get(second) == 2);
+}
+
+SCENARIO("Handle of other table type should not be valid", "[handle_table.cpp]")
+{
+    HandleTable<u32> textures(HANDLE_TYPE_TEXTURE);
+    HandleTable<u32> sprites(HANDLE_TYPE_SPRITE);
+    u32 texture = textures.add(1);
+    sprites.add(2);
+    REQUIRE(sprites.get(texture) == NULL);
+}
+
+SCENARIO("remove() should keep other handles valid and items dense", "[handle_table.cpp]")
+{
+    HandleTable<u32> table(HANDLE_TYPE_MESH);
+    u32 a = table.add(10);
+    u32 b = table.add(20);
+    u32 c = table.add(30);
+    table.remove(a);
+    REQUIRE(table.getCount() == 2);
+    REQUIRE(*table.get(b) == 20);
+    REQUIRE(*table.get(c) == 30);
+    REQUIRE(table.getAll()[0] == 30);
+    REQUIRE(table.getHandleAt(0) == c);
+}
@@ -0,0 +1,27 @@
+/*
+# ______       ____   ___
+#   |     \/   ____| |___|    
+#   |     |   |   \  |   |       
+#-----------------------------------------------------------------------
+# Copyright 2021, tyra - https://github.com/h4570/tyra
+# Licenced under Apache License 2.0
+# Sandro Sobczyński <sandro.sobczynski@gmail.com>
+*/
+
+#include <catch.hpp>
+#include <utils/hash.hpp>
+
+SCENARIO("fnv1a() should return known FNV-1a values", "[hash.cpp]")
+{
+    REQUIRE(Hash::fnv1a("") == 2166136261U);
+    REQUIRE(Hash::fnv1a("a") == 0xE40C292CU);
+    REQUIRE(Hash::fnv1a("foobar") == 0xBF9CF968U);
+}
+
+SCENARIO("fnv1a() should be usable at compile time", "[hash.cpp]")
+{
+    constexpr u32 water = Hash::fnv1a("water");
+    char name[] = "water";
+    REQUIRE(Hash::fnv1a(name) == water);
+    REQUIRE(Hash::fnv1a("Water") != water);
+}
@@ -20,3 +20,16 @@ SCENARIO("min(a,b) greater 'b' should return 'a'", "[math.cpp]")
 {
     REQUIRE(Math::min(-5, 5) == -5);
 }
+
+SCENARIO("log2(x) of power of 2 should be exact", "[math.cpp]")
+{
+    REQUIRE(Math::log2(1.0F) == 0.0F);
+    REQUIRE(Math::log2(8.0F) == 3.0F);
+    REQUIRE(Math::log2(0.25F) == -2.0F);
+}
+
+SCENARIO("log2(x) should be close to real log2", "[math.cpp]")
+{
+    REQUIRE(Math::log2(3.0F) == Approx(1.585F).margin(0.09F));
+    REQUIRE(Math::log2(100.0F) == Approx(6.644F).margin(0.09F));
+}
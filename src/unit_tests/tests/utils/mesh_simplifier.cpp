@@ -0,0 +1,100 @@
+/*
+# ______       ____   ___
+#   |     \/   ____| |___|    
+#   |     |   |   \  |   |       
+#-----------------------------------------------------------------------
+# Copyright 2021, tyra - https://github.com/h4570/tyra
+# Licenced under Apache License 2.0
+# Sandro Sobczyński <sandro.sobczynski@gmail.com>
+*/
+
+#include <catch.hpp>
+#include <utils/mesh_simplifier.hpp>
+#include <vector>
+#include <algorithm>
+
+/** Flat grid in XY plane with quads made of two triangles. Faces are facing +z. */
+static void createGrid(const u32 &t_size, std::vector<Vector3> &o_vertices, std::vector<u32> &o_faces)
+{
+    o_vertices.clear();
+    o_faces.clear();
+    for (u32 y = 0; y < t_size; y++)
+        for (u32 x = 0; x < t_size; x++)
+            o_vertices.push_back(Vector3(static_cast<float>(x), static_cast<float>(y), 0.0F));
+    for (u32 y = 0; y + 1 < t_size; y++)
+        for (u32 x = 0; x + 1 < t_size; x++)
+        {
+            const u32 a = y * t_size + x, b = a + 1, c = a + t_size, d = c + 1;
+            const u32 quad[6] = {a, b, c, c, b, d};
+            o_faces.insert(o_faces.end(), quad, quad + 6);
+        }
+}
+
+/** Signed area along z of triangle */
+static float getArea(const std::vector<Vector3> &t_vertices, const u32 *t_faces)
+{
+    const Vector3 &a = t_vertices[t_faces[0]], &b = t_vertices[t_faces[1]], &c = t_vertices[t_faces[2]];
+    return ((b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x)) * 0.5F;
+}
+
+SCENARIO("simplify() should reduce flat grid without changing its shape", "[mesh_simplifier.cpp]")
+{
+    std::vector<Vector3> vertices;
+    std::vector<u32> faces;
+    createGrid(10, vertices, faces);
+    const Vector3 *frames[1] = {&vertices[0]};
+    std::vector<u32> vertexFaces(faces.size()), stFaces(faces.size()), normalFaces(faces.size());
+    const u32 count = MeshSimplifier::simplify(frames, 1, vertices.size(), &faces[0], &faces[0], &faces[0], faces.size(), NULL, 60, &vertexFaces[0], &stFaces[0], &normalFaces[0]);
+
+    REQUIRE(count % 3 == 0);
+    REQUIRE(count <= 60);
+    REQUIRE(count > 0);
+    float area = 0.0F;
+    for (u32 i = 0; i < count; i += 3)
+    {
+        // No flipped or degenerated triangles
+        REQUIRE(getArea(vertices, &vertexFaces[i]) > 0.0F);
+        area += getArea(vertices, &vertexFaces[i]);
+        // Corners of collapsed vertex get data of vertex, which replaced it
+        for (u8 j = 0; j < 3; j++)
+        {
+            REQUIRE(stFaces[i + j] == vertexFaces[i + j]);
+            REQUIRE(normalFaces[i + j] == vertexFaces[i + j]);
+        }
+    }
+    REQUIRE(area == Approx(81.0F));
+}
+
+SCENARIO("simplify() should not remove locked vertices", "[mesh_simplifier.cpp]")
+{
+    std::vector<Vector3> vertices;
+    std::vector<u32> faces;
+    createGrid(4, vertices, faces);
+    const Vector3 *frames[1] = {&vertices[0]};
+    std::vector<u8> locked(vertices.size(), true);
+    std::vector<u32> vertexFaces(faces.size()), stFaces(faces.size()), normalFaces(faces.size());
+    const u32 count = MeshSimplifier::simplify(frames, 1, vertices.size(), &faces[0], &faces[0], &faces[0], faces.size(), &locked[0], 0, &vertexFaces[0], &stFaces[0], &normalFaces[0]);
+    REQUIRE(count == faces.size());
+    REQUIRE(vertexFaces == faces);
+}
+
+SCENARIO("simplify() should keep vertices, which are important in any animation frame", "[mesh_simplifier.cpp]")
+{
+    std::vector<Vector3> vertices;
+    std::vector<u32> faces;
+    createGrid(5, vertices, faces);
+    // Center vertex is a spike only in second frame
+    std::vector<Vector3> spike = vertices;
+    const u32 center = 12;
+    spike[center].z = 10.0F;
+    const Vector3 *frames[2] = {&vertices[0], &spike[0]};
+    std::vector<u32> vertexFaces(faces.size()), stFaces(faces.size()), normalFaces(faces.size());
+
+    const u32 flatCount = MeshSimplifier::simplify(frames, 1, vertices.size(), &faces[0], &faces[0], &faces[0], faces.size(), NULL, 6, &vertexFaces[0], &stFaces[0], &normalFaces[0]);
+    REQUIRE(flatCount <= 6);
+    REQUIRE(std::find(vertexFaces.begin(), vertexFaces.begin() + flatCount, center) == vertexFaces.begin() + flatCount);
+
+    const u32 animatedCount = MeshSimplifier::simplify(frames, 2, vertices.size(), &faces[0], &faces[0], &faces[0], faces.size(), NULL, 12, &vertexFaces[0], &stFaces[0], &normalFaces[0]);
+    REQUIRE(animatedCount <= 12);
+    REQUIRE(std::find(vertexFaces.begin(), vertexFaces.begin() + animatedCount, center) != vertexFaces.begin() + animatedCount);
+}
@@ -0,0 +1,80 @@
+/*
+# ______       ____   ___
+#   |     \/   ____| |___|    
+#   |     |   |   \  |   |       
+#-----------------------------------------------------------------------
+# Copyright 2021, tyra - https://github.com/h4570/tyra
+# Licenced under Apache License 2.0
+# Sandro Sobczyński <sandro.sobczynski@gmail.com>
+*/
+
+#include <catch.hpp>
+#include <utils/quantizer.hpp>
+#include <models/texture.hpp>
+
+SCENARIO("medianCut() should be lossless for few colors", "[quantizer.cpp]")
+{
+    const u8 pixels[] = {
+        255, 0, 0, 255,
+        0, 255, 0, 255,
+        255, 0, 0, 255,
+        0, 0, 255, 128,
+        0, 255, 0, 255,
+        0, 0, 255, 128};
+    u8 palette[16 * 4];
+    u8 indexes[6];
+    const u32 colors = Quantizer::medianCut(pixels, 6, 16, palette, indexes);
+    REQUIRE(colors == 3);
+    for (u32 i = 0; i < 6; i++)
+        for (u32 c = 0; c < 4; c++)
+            REQUIRE(palette[indexes[i] * 4 + c] == pixels[i * 4 + c]);
+    REQUIRE(indexes[0] == indexes[2]);
+    REQUIRE(indexes[1] == indexes[4]);
+    REQUIRE(indexes[3] == indexes[5]);
+}
+
+SCENARIO("medianCut() should not exceed max colors", "[quantizer.cpp]")
+{
+    const u32 count = 64;
+    u8 pixels[count * 4];
+    for (u32 i = 0; i < count; i++)
+    {
+        pixels[i * 4] = i * 4;
+        pixels[i * 4 + 1] = 255 - i * 4;
+        pixels[i * 4 + 2] = (i % 8) * 32;
+        pixels[i * 4 + 3] = 255;
+    }
+    u8 palette[16 * 4];
+    u8 indexes[count];
+    const u32 colors = Quantizer::medianCut(pixels, count, 16, palette, indexes);
+    REQUIRE(colors == 16);
+    for (u32 i = 0; i < count; i++)
+    {
+        REQUIRE(indexes[i] < 16);
+        REQUIRE(abs((s32)palette[indexes[i] * 4] - (s32)pixels[i * 4]) <= 32);
+    }
+}
+
+SCENARIO("findNearest() should return nearest palette color", "[quantizer.cpp]")
+{
+    const u8 palette[] = {
+        0, 0, 0, 255,
+        255, 255, 255, 255,
+        200, 10, 10, 255};
+    const u8 reddish[] = {180, 30, 20, 255};
+    const u8 gray[] = {60, 60, 60, 255};
+    REQUIRE(Quantizer::findNearest(palette, 3, reddish) == 2);
+    REQUIRE(Quantizer::findNearest(palette, 3, gray) == 0);
+}
+
+SCENARIO("getClutIndexCSM1() should swap 8-15 with 16-23 in every 32 colors", "[quantizer.cpp]")
+{
+    REQUIRE(Texture::getClutIndexCSM1(0) == 0);
+    REQUIRE(Texture::getClutIndexCSM1(7) == 7);
+    REQUIRE(Texture::getClutIndexCSM1(8) == 16);
+    REQUIRE(Texture::getClutIndexCSM1(15) == 23);
+    REQUIRE(Texture::getClutIndexCSM1(16) == 8);
+    REQUIRE(Texture::getClutIndexCSM1(24) == 24);
+    REQUIRE(Texture::getClutIndexCSM1(40) == 48);
+    REQUIRE(Texture::getClutIndexCSM1(255) == 255);
+}
@@ -0,0 +1,114 @@
+/*
+# ______       ____   ___
+#   |     \/   ____| |___|    
+#   |     |   |   \  |   |       
+#-----------------------------------------------------------------------
+# Copyright 2021, tyra - https://github.com/h4570/tyra
+# Licenced under Apache License 2.0
+# Sandro Sobczyński <sandro.sobczynski@gmail.com>
+*/
+
+#include <catch.hpp>
+#include <utils/stripifier.hpp>
+#include <set>
+#include <vector>
+
+/** Rotates triangle, so it begins with lowest vertex. Winding is kept. */
+static std::vector<u32> getTriangle(const u32 &t_a, const u32 &t_b, const u32 &t_c)
+{
+    std::vector<u32> result;
+    if (t_a < t_b && t_a < t_c)
+        result = {t_a, t_b, t_c};
+    else if (t_b < t_c)
+        result = {t_b, t_c, t_a};
+    else
+        result = {t_c, t_a, t_b};
+    return result;
+}
+
+/** Checks, if every input triangle is drawn once by strips, with the same winding */
+static void requireAllTriangles(const u32 *t_vertexFaces, const u32 &t_facesCount, const u32 *t_faces, const u8 *t_restarts, const u32 &t_count)
+{
+    std::multiset<std::vector<u32>> expected, drawn;
+    for (u32 i = 0; i < t_facesCount; i += 3)
+        expected.insert(getTriangle(t_vertexFaces[i], t_vertexFaces[i + 1], t_vertexFaces[i + 2]));
+    u32 stripTriangle = 0;
+    for (u32 i = 0; i < t_count; i++)
+    {
+        if (t_restarts[i])
+        {
+            stripTriangle = 0;
+            continue;
+        }
+        REQUIRE(i >= 2);
+        const u32 a = t_vertexFaces[t_faces[i - 2]];
+        const u32 b = t_vertexFaces[t_faces[i - 1]];
+        const u32 c = t_vertexFaces[t_faces[i]];
+        drawn.insert(stripTriangle++ & 1 ? getTriangle(b, a, c) : getTriangle(a, b, c));
+    }
+    REQUIRE(drawn == expected);
+}
+
+SCENARIO("generate() should join quad into one strip", "[stripifier.cpp]")
+{
+    const u32 vertexFaces[] = {0, 1, 2, 2, 1, 3};
+    const u32 stFaces[] = {0, 1, 2, 2, 1, 3};
+    const u32 normalFaces[] = {0, 0, 0, 0, 0, 0};
+    u32 faces[6];
+    u8 restarts[6];
+    const u32 count = Stripifier::generate(vertexFaces, stFaces, normalFaces, 6, faces, restarts);
+    REQUIRE(count == 4);
+    REQUIRE(restarts[0] == 1);
+    REQUIRE(restarts[1] == 1);
+    REQUIRE(restarts[2] == 0);
+    REQUIRE(restarts[3] == 0);
+    requireAllTriangles(vertexFaces, 6, faces, restarts, count);
+}
+
+SCENARIO("generate() should not join triangles with other texture coords", "[stripifier.cpp]")
+{
+    const u32 vertexFaces[] = {0, 1, 2, 2, 1, 3};
+    const u32 stFaces[] = {0, 1, 2, 4, 5, 3};
+    const u32 normalFaces[] = {0, 0, 0, 0, 0, 0};
+    u32 faces[6];
+    u8 restarts[6];
+    const u32 count = Stripifier::generate(vertexFaces, stFaces, normalFaces, 6, faces, restarts);
+    REQUIRE(count == 6);
+    REQUIRE(restarts[3] == 1);
+    REQUIRE(restarts[4] == 1);
+}
+
+SCENARIO("generate() should not join triangles with other winding", "[stripifier.cpp]")
+{
+    const u32 vertexFaces[] = {0, 1, 2, 1, 2, 3};
+    const u32 normalFaces[] = {0, 0, 0, 0, 0, 0};
+    u32 faces[6];
+    u8 restarts[6];
+    const u32 count = Stripifier::generate(vertexFaces, vertexFaces, normalFaces, 6, faces, restarts);
+    REQUIRE(count == 6);
+    requireAllTriangles(vertexFaces, 6, faces, restarts, count);
+}
+
+SCENARIO("generate() should draw every triangle of grid once", "[stripifier.cpp]")
+{
+    const u32 size = 8;
+    const u32 facesCount = size * size * 6;
+    u32 vertexFaces[facesCount], normalFaces[facesCount];
+    u32 i = 0;
+    for (u32 y = 0; y < size; y++)
+        for (u32 x = 0; x < size; x++)
+        {
+            const u32 v = y * (size + 1) + x;
+            const u32 quad[] = {v, v + 1, v + size + 1, v + size + 1, v + 1, v + size + 2};
+            for (u32 j = 0; j < 6; j++, i++)
+            {
+                vertexFaces[i] = quad[j];
+                normalFaces[i] = 0;
+            }
+        }
+    u32 faces[facesCount];
+    u8 restarts[facesCount];
+    const u32 count = Stripifier::generate(vertexFaces, vertexFaces, normalFaces, facesCount, faces, restarts);
+    REQUIRE(count < facesCount / 2);
+    requireAllTriangles(vertexFaces, facesCount, faces, restarts, count);
+}
@@ -0,0 +1,92 @@
+/*
+# ______       ____   ___
+#   |     \/   ____| |___|    
+#   |     |   |   \  |   |       
+#-----------------------------------------------------------------------
+# Copyright 2021, tyra - https://github.com/h4570/tyra
+# Licenced under Apache License 2.0
+# Sandro Sobczyński <sandro.sobczynski@gmail.com>
+*/
+
+
+#include <catch.hpp>
+#include <utils/vertex_quantizer.hpp>
+#include <vector>
+#include <cmath>
+
+static u32 random(u32 &t_seed)
+{
+    t_seed = t_seed * 1664525 + 1013904223;
+    return t_seed >> 8;
+}
+
+static float randomFloat(u32 &t_seed, const float &t_min, const float &t_max)
+{
+    return t_min + (t_max - t_min) * (random(t_seed) & 0xFFFF) / 65535.0F;
+}
+
+SCENARIO("Dequantized vertices should be within half of scale", "[vertex_quantizer.cpp]")
+{
+    u32 seed = 42;
+    const u32 count = 1000;
+    VECTOR *vertices = new VECTOR[count];
+    for (u32 i = 0; i < count; i++)
+    {
+        vertices[i][0] = randomFloat(seed, -300.0F, 100.0F);
+        vertices[i][1] = randomFloat(seed, 0.0F, 50.0F);
+        vertices[i][2] = randomFloat(seed, -1.0F, 1.0F);
+        vertices[i][3] = 1.0F;
+    }
+    VECTOR scale, offset;
+    VertexQuantizer::getBounds(vertices, count, 3, scale, offset);
+    std::vector<s16> result(count * 4);
+    VertexQuantizer::quantizeVertices(vertices, count, scale, offset, &result[0]);
+    for (u32 i = 0; i < count; i++)
+    {
+        for (u8 c = 0; c < 3; c++)
+        {
+            const float error = fabsf(VertexQuantizer::dequantize(result[i * 4 + c], scale[c], offset[c]) - vertices[i][c]);
+            // Float rounding of scale and offset is added to error bound
+            REQUIRE(error <= scale[c] * 0.5F + fabsf(vertices[i][c]) * 1e-6F);
+        }
+        REQUIRE(result[i * 4 + 3] == 1);
+    }
+    delete[] vertices;
+}
+
+SCENARIO("Bounding box should use whole s16 range", "[vertex_quantizer.cpp]")
+{
+    VECTOR coordinates[3] = {{0.0F, -2.0F, 1.0F, 1.0F}, {0.5F, 0.0F, 1.0F, 1.0F}, {1.0F, 2.0F, 1.0F, 1.0F}};
+    VECTOR scale, offset;
+    VertexQuantizer::getBounds(coordinates, 3, 2, scale, offset);
+    REQUIRE(offset[0] == 0.5F);
+    REQUIRE(offset[1] == 0.0F);
+    s16 result[6];
+    VertexQuantizer::quantizeCoordinates(coordinates, 3, scale, offset, result);
+    REQUIRE(result[0] == -VERTEX_QUANTIZER_MAX);
+    REQUIRE(result[1] == -VERTEX_QUANTIZER_MAX);
+    REQUIRE(result[2] == 0);
+    REQUIRE(result[3] == 0);
+    REQUIRE(result[4] == VERTEX_QUANTIZER_MAX);
+    REQUIRE(result[5] == VERTEX_QUANTIZER_MAX);
+}
+
+SCENARIO("Flat bounding box should be quantized without error", "[vertex_quantizer.cpp]")
+{
+    VECTOR vertices[2] = {{5.0F, 1.0F, -3.0F, 1.0F}, {5.0F, 2.0F, -3.0F, 1.0F}};
+    VECTOR scale, offset;
+    VertexQuantizer::getBounds(vertices, 2, 3, scale, offset);
+    s16 result[8];
+    VertexQuantizer::quantizeVertices(vertices, 2, scale, offset, result);
+    REQUIRE(result[0] == 0);
+    REQUIRE(result[2] == 0);
+    REQUIRE(VertexQuantizer::dequantize(result[4], scale[0], offset[0]) == 5.0F);
+    REQUIRE(VertexQuantizer::dequantize(result[6], scale[2], offset[2]) == -3.0F);
+}
+
+SCENARIO("Values out of bounding box should be clamped", "[vertex_quantizer.cpp]")
+{
+    REQUIRE(VertexQuantizer::quantize(10.0F, 1.0F / VERTEX_QUANTIZER_MAX, 0.0F) == VERTEX_QUANTIZER_MAX);
+    REQUIRE(VertexQuantizer::quantize(-10.0F, 1.0F / VERTEX_QUANTIZER_MAX, 0.0F) == -VERTEX_QUANTIZER_MAX);
+    REQUIRE(VertexQuantizer::quantize(-0.5F, 1.0F / VERTEX_QUANTIZER_MAX, 0.0F) == -16384);
+}